@@ -57,27 +57,11 @@ void cavitySetup( MultiBlockLattice3D<T,DESCRIPTOR>& lattice,
     lattice.initialize();
 }
 
-int main(int argc, char* argv[]) {
-
-    plbInit(&argc, &argv);
-    //defaultMultiBlockPolicy3D().toggleBlockingCommunication(true);
-
-    plint N;
-    try {
-        global::argv(1).read(N);
-    }
-    catch(...)
-    {
-        pcout << "Wrong parameters. The syntax is " << std::endl;
-        pcout << argv[0] << " N" << std::endl;
-        pcout << "where N is the resolution. The benchmark cases published " << std::endl;
-        pcout << "on the Palabos Wiki use N=100, N=400, N=1000, or N=4000." << std::endl;
-        exit(1);
-    }
-
-    pcout << "Starting benchmark with " << N+1 << "x" << N+1 << "x" << N+1 << " grid points "
-          << "(approx. 2 minutes on modern processors)." << std::endl;
-
+/// Run the benchmark with the given memory layout of the lattice,
+///   and return the performance in Mega site updates per second.
+T runBenchmark(plint N, LatticeStorage::StorageT storage)
+{
+    defaultMultiBlockPolicy3D().setLatticeStorage(storage);
 
     IncomprFlowParam<T> parameters(
             (T) 1e-2,  // uMax
@@ -117,18 +101,77 @@ int main(int argc, char* argv[]) {
     }
 
     // Run the benchmark for good.
-    global::timer("benchmark").start();
+    global::timer("benchmark").restart();
     global::profiler().turnOn();
     for (plint iT=0; iT<numIter; ++iT) {
         lattice.collideAndStream();
     }
+    global::profiler().turnOff();
 
+    T mlups = (T) (numCells*numIter) /
+              global::timer("benchmark").getTime() / 1.e6;
     pcout << "After " << numIter << " iterations: "
-          << (T) (numCells*numIter) /
-             global::timer("benchmark").getTime() / 1.e6
-          << " Mega site updates per second." << std::endl << std::endl;
-
-    global::profiler().writeReport();
+          << mlups << " Mega site updates per second." << std::endl << std::endl;
 
     delete boundaryCondition;
+    return mlups;
+}
+
+int main(int argc, char* argv[]) {
+
+    plbInit(&argc, &argv);
+    //defaultMultiBlockPolicy3D().toggleBlockingCommunication(true);
+
+    plint N;
+    try {
+        global::argv(1).read(N);
+    }
+    catch(...)
+    {
+        pcout << "Wrong parameters. The syntax is " << std::endl;
+        pcout << argv[0] << " N [cells|arrays|ab|float|both]" << std::endl;
+        pcout << "where N is the resolution. The benchmark cases published " << std::endl;
+        pcout << "on the Palabos Wiki use N=100, N=400, N=1000, or N=4000." << std::endl;
+        pcout << "The optional second argument selects the memory layout of the lattice:" << std::endl;
+        pcout << "cells (default) for the array of cells with scalar collision, arrays for" << std::endl;
+        pcout << "the population arrays with vectorized collision, ab for the population" << std::endl;
+        pcout << "arrays with two-lattice (AB) streaming, float for the population arrays" << std::endl;
+        pcout << "stored in single precision, and both to compare cells and arrays." << std::endl;
+        exit(1);
+    }
+    std::string mode("cells");
+    if (global::argc() > 2) {
+        global::argv(2).read(mode);
+    }
+    if (mode!="cells" && mode!="arrays" && mode!="ab" && mode!="float" && mode!="both") {
+        pcout << "Unknown memory layout " << mode << ". Use cells, arrays, ab, float, or both." << std::endl;
+        exit(1);
+    }
+
+    pcout << "Starting benchmark with " << N+1 << "x" << N+1 << "x" << N+1 << " grid points "
+          << "(approx. 2 minutes on modern processors)." << std::endl;
+
+    T cellsMlups = T(), arraysMlups = T();
+    if (mode=="cells" || mode=="both") {
+        pcout << "Array of cells, scalar collision:" << std::endl;
+        cellsMlups = runBenchmark(N, LatticeStorage::cellArray);
+    }
+    if (mode=="arrays" || mode=="both") {
+        pcout << "Population arrays, vectorized collision:" << std::endl;
+        arraysMlups = runBenchmark(N, LatticeStorage::populationArrays);
+    }
+    if (mode=="ab") {
+        pcout << "Two sets of population arrays, AB streaming:" << std::endl;
+        runBenchmark(N, LatticeStorage::twoPopulationArrays);
+    }
+    if (mode=="float") {
+        pcout << "Population arrays in single precision, vectorized collision:" << std::endl;
+        runBenchmark(N, LatticeStorage::floatPopulationArrays);
+    }
+    if (mode=="both") {
+        pcout << "Speedup of the vectorized collision: "
+              << arraysMlups/cellsMlups << std::endl << std::endl;
+    }
+
+    global::profiler().writeReport();
 }
@@ -27,9 +27,48 @@
  */
 #include "atomicBlock/atomicBlock3D.h"
 #include "atomicBlock/atomicBlockSerializer3D.h"
+#include "core/plbDebug.h"
+#include <vector>
 
 namespace plb {
 
+/* *************** Class BlockDataTransfer3D ******************************** */
+
+void BlockDataTransfer3D::sendStatic(Box3D domain, char* buffer) const {
+    plint numBytes = domain.nCells()*staticCellSize();
+    // Avoid dereferencing uninitialized pointer.
+    if (numBytes==0) return;
+    std::vector<char> stream;
+    send(domain, stream, modif::staticVariables);
+    PLB_ASSERT( (plint)stream.size() == numBytes );
+    std::copy(stream.begin(), stream.end(), buffer);
+}
+
+void BlockDataTransfer3D::receiveStatic(Box3D domain, char const* buffer, Dot3D absoluteOffset) {
+    plint numBytes = domain.nCells()*staticCellSize();
+    // Avoid dereferencing uninitialized pointer.
+    if (numBytes==0) return;
+    std::vector<char> stream(buffer, buffer+numBytes);
+    receive(domain, stream, modif::staticVariables, absoluteOffset);
+}
+
+plint BlockDataTransfer3D::incomingCellSize(plint normalX, plint normalY, plint normalZ) const {
+    return staticCellSize();
+}
+
+void BlockDataTransfer3D::sendIncoming (
+        Box3D domain, plint normalX, plint normalY, plint normalZ, char* buffer ) const
+{
+    sendStatic(domain, buffer);
+}
+
+void BlockDataTransfer3D::receiveIncoming (
+        Box3D domain, plint normalX, plint normalY, plint normalZ,
+        char const* buffer, Dot3D absoluteOffset )
+{
+    receiveStatic(domain, buffer, absoluteOffset);
+}
+
 /* *************** Class StatSubscriber3D *********************************** */
 
 StatSubscriber3D::StatSubscriber3D(AtomicBlock3D& block_)
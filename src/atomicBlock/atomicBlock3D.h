@@ -88,6 +88,30 @@ struct BlockDataTransfer3D {
     {
         attribute(toDomain, deltaX, deltaY, deltaZ, from, kind);
     }
+    /// Send static data from the block into a preallocated buffer of
+    ///   domain.nCells()*staticCellSize() bytes.
+    /** This is used by the communicators to pack messages in place, in the
+     *  buffer of the MPI communication. By default, the data is sent into
+     *  a temporary byte-stream, and copied.
+     **/
+    virtual void sendStatic(Box3D domain, char* buffer) const;
+    /// Receive static data into the block from a buffer of domain.nCells()*staticCellSize() bytes.
+    /** By default, the data is copied into a temporary byte-stream which is then received. **/
+    virtual void receiveStatic(Box3D domain, char const* buffer, Dot3D absoluteOffset);
+    /// Size in bytes of the static data of a cell which is sent by sendIncoming().
+    virtual plint incomingCellSize(plint normalX, plint normalY, plint normalZ) const;
+    /// Send the part of the static data which streams into the envelope of a block
+    ///   from outside the block, into a preallocated buffer.
+    /** The domain is located in the envelope of the receiving block, on the side
+     *  (normalX,normalY,normalZ) of its bulk (components -1, 0 or 1). The rest of
+     *  the static data of the envelope is expected to be up to date. By default,
+     *  all static data is sent.
+     **/
+    virtual void sendIncoming( Box3D domain, plint normalX, plint normalY, plint normalZ,
+                               char* buffer ) const;
+    /// Receive data sent by sendIncoming().
+    virtual void receiveIncoming( Box3D domain, plint normalX, plint normalY, plint normalZ,
+                                  char const* buffer, Dot3D absoluteOffset );
 };
 
 class AtomicBlock3D : public Block3D {
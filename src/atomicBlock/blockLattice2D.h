@@ -169,9 +169,9 @@ public:
 private:
     /// Generic implementation of bulkCollideAndStream(domain).
     void linearBulkCollideAndStream(Box2D domain);
-    /// Cache-efficient implementation of bulkCollideAndStream(domain)for
-    ///   nearest-neighbor lattices.
-    void blockwiseBulkCollideAndStream(Box2D domain);
+    /// Cache-efficient implementation of bulkCollideAndStream(domain), for
+    ///   all lattices.
+    void blockwiseBulkCollideAndStream(Box2D domain, Dot2D tileShape);
 private:
     /// Helper method for memory allocation
     void allocateAndInitialize();
@@ -403,17 +403,16 @@ void BlockLattice2D<T,Descriptor>::bulkCollideAndStream(Box2D domain) {
     // Make sure domain is contained within current lattice
     PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
 
-    if (Descriptor<T>::vicinity==1) {
-        // On nearest-neighbor lattice, use the cache-efficient
-        //   version of collidAndStream.
-        blockwiseBulkCollideAndStream(domain);
+    // The tile shape is auto-tuned on the first sweeps. A tile shape of 0 means
+    //   that the straightforward implementation is faster on this platform.
+    Dot2D tileShape = cachePolicy().startSweep(domain.nCells());
+    if (tileShape.x > 0 && tileShape.y > 0) {
+        blockwiseBulkCollideAndStream(domain, tileShape);
     }
     else {
-        // Otherwise, use the straightforward implementation.
-        //   Note that at some point, we should implement the cache-efficient
-        //   version for extended lattices as well.
         linearBulkCollideAndStream(domain);
     }
+    cachePolicy().stopSweep(domain.nCells());
 }
 
 
@@ -435,42 +434,41 @@ void BlockLattice2D<T,Descriptor>::linearBulkCollideAndStream(Box2D domain) {
 
 
 /** Sophisticated implementation which improves cache usage through block-wise
- *  loops. For now, this works only with nearest-neighbor lattices. On extended
- *  lattices, the naive version "linearBulkCollideAndStream" is used.
+ *  loops. It works with all lattices, including extended ones: the blocks are
+ *  sheared according to the velocity set, as explained in
+ *  indexTemplates::SwapStreamingSkew2D.
  */
 template<typename T, template<typename U> class Descriptor>
-void BlockLattice2D<T,Descriptor>::blockwiseBulkCollideAndStream(Box2D domain) {
+void BlockLattice2D<T,Descriptor>::blockwiseBulkCollideAndStream(Box2D domain, Dot2D tileShape) {
     // Make sure domain is contained within current lattice
     PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
-
-    // For cache efficiency, memory is traversed block-wise. The two outer loops enumerate
-    //   the blocks, whereas the two inner loops enumerate the cells inside each block.
-    const plint blockSize = cachePolicy().getBlockSize();
-    // Outer loops.
-    for (plint outerX=domain.x0; outerX<=domain.x1; outerX+=blockSize) {
-        for (plint outerY=domain.y0; outerY<=domain.y1+blockSize-1; outerY+=blockSize) {
+    PLB_PRECONDITION( tileShape.x > 0 && tileShape.y > 0 );
+
+    const plint xShiftY = indexTemplates::swapStreamingSkew2D<Descriptor<T> >().getXshiftY();
+    const plint ny = domain.getNy();
+
+    // For cache efficiency, memory is traversed block-wise. The blocks are slabs
+    //   of tileShape.x cells along x, which are tiled with tileShape.y cells in
+    //   the skewed coordinate v = y+xShiftY*x (relative to the origin of the
+    //   domain). The skew ensures that only post-collision cells are accessed
+    //   during the swap-operation of the streaming.
+    for (plint outerX=0; outerX<domain.getNx(); outerX+=tileShape.x) {
+        plint endX = std::min(outerX+tileShape.x, domain.getNx())-1;
+        for (plint outerV=xShiftY*outerX; outerV<=ny-1+xShiftY*endX; outerV+=tileShape.y) {
+            plint endV = outerV+tileShape.y-1;
             // Inner loops.
-            plint dx = 0;
-            for (plint innerX=outerX;
-                 innerX <= std::min(outerX+blockSize-1, domain.x1);
-                 ++innerX, ++dx)
-            {
-                // Y-index is shifted in negative direction at each x-increment. to ensure
-                //   that only post-collision cells are accessed during the swap-operation
-                //   of the streaming.
-                plint minY = outerY-dx;
-                plint maxY = minY+blockSize-1;
-                for (plint innerY=std::max(minY,domain.y0);
-                     innerY <= std::min(maxY, domain.y1);
-                     ++innerY)
-                {
+            for (plint dx=outerX; dx<=endX; ++dx) {
+                plint iX = domain.x0+dx;
+                plint startY = std::max((plint)0, outerV-xShiftY*dx);
+                plint endY = std::min(ny-1, endV-xShiftY*dx);
+                for (plint iY=domain.y0+startY; iY<=domain.y0+endY; ++iY) {
                     // Collide the cell.
-                    grid[innerX][innerY].collide (
+                    grid[iX][iY].collide (
                             this->getInternalStatistics() );
                     // Swap the populations on the cell, and then with post-collision
                     //   neighboring cell, to perform the streaming step.
                     latticeTemplates<T,Descriptor>::swapAndStream2D (
-                            grid, innerX, innerY );
+                            grid, iX, iY );
                 }
             }
         }
@@ -833,7 +831,11 @@ void BlockLatticeDataTransfer2D<T,Descriptor>::attribute_regenerate (
 
 template<typename T, template<typename U> class Descriptor>
 CachePolicy2D& BlockLattice2D<T,Descriptor>::cachePolicy() {
-    static CachePolicy2D cachePolicySingleton(200);
+    // The name of the policy in the file of the CachePolicyTuner contains the
+    //   descriptor and the floating-point precision.
+    static CachePolicy2D cachePolicySingleton (
+            200, true, std::string("BlockLattice2D.") + Descriptor<T>::name + "." +
+                       util::val2str(8*sizeof(T)) + "bit" );
     return cachePolicySingleton;
 }
 
@@ -34,6 +34,7 @@
 #include "atomicBlock/dataField3D.h"
 #include "core/blockLatticeBase3D.h"
 #include "atomicBlock/atomicBlock3D.h"
+#include "atomicBlock/populationArrays3D.h"
 #include "core/blockIdentifiers.h"
 #include <vector>
 #include <map>
@@ -68,7 +69,22 @@ public:
     {
         attribute(toDomain, deltaX, deltaY, deltaZ, from, kind);
     }
+    /// Serialize the populations and external scalars directly into the buffer.
+    virtual void sendStatic(Box3D domain, char* buffer) const;
+    /// Unserialize the populations and external scalars directly from the buffer.
+    virtual void receiveStatic(Box3D domain, char const* buffer, Dot3D absoluteOffset);
+    /// Only the populations which stream into the envelope from outside the block are
+    ///   transmitted, without the external scalars.
+    virtual plint incomingCellSize(plint normalX, plint normalY, plint normalZ) const;
+    virtual void sendIncoming( Box3D domain, plint normalX, plint normalY, plint normalZ,
+                               char* buffer ) const;
+    virtual void receiveIncoming( Box3D domain, plint normalX, plint normalY, plint normalZ,
+                                  char const* buffer, Dot3D absoluteOffset );
 private:
+    /// Populations which stream into a cell located on the side (normalX,normalY,normalZ)
+    ///   of the bulk from outside the block.
+    static void incomingPopulations( plint normalX, plint normalY, plint normalZ,
+                                     std::vector<plint>& pops );
     void send_static(Box3D domain, std::vector<char>& buffer) const;
     void send_dynamic(Box3D domain, std::vector<char>& buffer) const;
     void send_all(Box3D domain, std::vector<char>& buffer) const;
@@ -101,6 +117,16 @@ template<typename T_, template<typename U_> class Descriptor_>
 /** A block lattice contains a regular array of Cell objects and
  * some useful methods to execute the LB dynamics on the lattice.
  *
+ * With the storage LatticeStorage::populationArrays, the populations are
+ * instead held in a PopulationArrays3D object, and the methods get()
+ * return cell views (see PopulationArrays3D for the semantics). With
+ * LatticeStorage::twoPopulationArrays, collideAndStream() in addition
+ * uses the AB pattern on two sets of population arrays. The storages
+ * LatticeStorage::floatPopulationArrays and twoFloatPopulationArrays are
+ * their counterparts with populations stored in single precision. With
+ * LatticeStorage::sparsePopulationArrays, memory is only allocated for
+ * the cells which are not buried inside solid regions.
+ *
  * This class is not intended to be derived from.
  */
 template<typename T, template<typename U> class Descriptor>
@@ -108,7 +134,8 @@ class BlockLattice3D : public BlockLatticeBase3D<T,Descriptor>, public AtomicBlo
 {
 public:
     /// Construction of an nx_ by ny_ by nz_ lattice
-    BlockLattice3D(plint nx_, plint ny_, plint nz_, Dynamics<T,Descriptor>* backgroundDynamics_);
+    BlockLattice3D(plint nx_, plint ny_, plint nz_, Dynamics<T,Descriptor>* backgroundDynamics_,
+                   LatticeStorage::StorageT storage_ = LatticeStorage::cellArray);
     /// Destruction of the lattice
     ~BlockLattice3D();
     /// Copy construction
@@ -123,6 +150,9 @@ public:
         PLB_PRECONDITION(iX<this->getNx());
         PLB_PRECONDITION(iY<this->getNy());
         PLB_PRECONDITION(iZ<this->getNz());
+        if (populationArrays) {
+            return populationArrays->getCellView(iX,iY,iZ);
+        }
         return grid[iX][iY][iZ];
     }
     /// Read only access to lattice cells
@@ -130,6 +160,9 @@ public:
         PLB_PRECONDITION(iX<this->getNx());
         PLB_PRECONDITION(iY<this->getNy());
         PLB_PRECONDITION(iZ<this->getNz());
+        if (populationArrays) {
+            return populationArrays->getCellView(iX,iY,iZ);
+        }
         return grid[iX][iY][iZ];
     }
     /// Specify wheter statistics measurements are done on a rect. domain
@@ -147,6 +180,12 @@ public:
     virtual void collideAndStream(Box3D domain);
     /// Apply first collision, then streaming step to the whole domain
     virtual void collideAndStream();
+    /// Split version of collideAndStream(domain), which allows to overlap the
+    ///   communication of the envelope with computations. collideAndStreamShell()
+    ///   completes the step on the cells at a distance smaller than width from the
+    ///   border of the domain, and collideAndStreamInterior() on the other cells.
+    void collideAndStreamShell(Box3D domain, plint width);
+    void collideAndStreamInterior(Box3D domain, plint width);
     /// Increment time counter
     /** Warning: don't call this method manually. Instead, call incrementTime()
      *  on the multi-block lattice. Otherwise, the internal time of the multi-block
@@ -164,21 +203,34 @@ public:
     Dynamics<T,Descriptor>& getBackgroundDynamics();
     /// Get a const reference to the background dynamics
     Dynamics<T,Descriptor> const& getBackgroundDynamics() const;
+    /// Memory layout of the cells.
+    LatticeStorage::StorageT getStorage() const;
     /// Apply streaming step to bulk (non-boundary) cells
     void bulkStream(Box3D domain);
-    /// Apply streaming step to boundary cells
+    /// Apply streaming step to boundary cells, with the neighbors inside bound
     void boundaryStream(Box3D bound, Box3D domain);
     /// Apply collision and streaming step to bulk (non-boundary) cells
     void bulkCollideAndStream(Box3D domain);
 private:
     /// Generic implementation of bulkCollideAndStream(domain).
     void linearBulkCollideAndStream(Box3D domain);
-    /// Cache-efficient implementation of bulkCollideAndStream(domain)for
-    ///   nearest-neighbor lattices.
-    void blockwiseBulkCollideAndStream(Box3D domain);
+    /// Cache-efficient implementation of bulkCollideAndStream(domain), for
+    ///   all lattices.
+    void blockwiseBulkCollideAndStream(Box3D domain, Dot3D tileShape);
+    /// Collision and streaming step on the bulk cells (iX,iY,z0) to (iX,iY,z1).
+    ///   Each run of cells which share a dynamics object is collided with a single
+    ///   call to Dynamics::collideSequence().
+    void bulkCollideAndStreamRow(plint iX, plint iY, plint z0, plint z1);
+    /// Decomposition of domain into six slabs of thickness width+vicinity, which
+    ///   form the shell, and the interior. Returns false if the collision-streaming
+    ///   step cannot be split on this domain.
+    bool decomposeShell( Box3D domain, plint width,
+                         std::vector<Box3D>& shell, Box3D& interior ) const;
+    /// Streaming step between two disjoint boxes.
+    void streamBetween(Box3D box1, Box3D box2);
 private:
     /// Helper method for memory allocation
-    void allocateAndInitialize();
+    void allocateAndInitialize(LatticeStorage::StorageT storage);
     /// Helper method for memory de-allocation
     void releaseMemory();
     void implementPeriodicity();
@@ -188,15 +240,26 @@ private:
     Dynamics<T,Descriptor>* backgroundDynamics;
     Cell<T,Descriptor>     *rawData;
     Cell<T,Descriptor>   ***grid;
+    /// Non-null if and only if the storage is not LatticeStorage::cellArray.
+    PopulationArrays3D<T,Descriptor>* populationArrays;
     BlockLatticeDataTransfer3D<T,Descriptor> dataTransfer;
 public:
+    /// Cache policy of the lattices with LatticeStorage::cellArray.
     static CachePolicy3D& cachePolicy();
+    /// Cache policy of bulkCollideAndStream() for a given storage. The storages
+    ///   with one and two sets of population arrays share the same policy.
+    static CachePolicy3D& cachePolicy(LatticeStorage::StorageT storage);
+private:
+    static std::string cachePolicyName(std::string storageName);
+public:
 template<typename T_, template<typename U_> class Descriptor_>
     friend class ExternalRhoJcollideAndStream3D;
 template<typename T_, template<typename U_> class Descriptor_>
     friend class PackedExternalRhoJcollideAndStream3D;
 template<typename T_, template<typename U_> class Descriptor_>
     friend class OnLinkExternalRhoJcollideAndStream3D;
+template<typename T_, template<typename U_> class Descriptor_>
+    friend class BlockLatticeDataTransfer3D;
 };
 
 template<typename T, template<typename U> class Descriptor>
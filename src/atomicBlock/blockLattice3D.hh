@@ -48,24 +48,29 @@ namespace plb {
 /** \param nx_ lattice width (first index)
  *  \param ny_ lattice height (second index)
  *  \param nz_ lattice depth (third index)
+ *  \param storage_ memory layout of the cells
  */
 template<typename T, template<typename U> class Descriptor>
 BlockLattice3D<T,Descriptor>::BlockLattice3D (
         plint nx_, plint ny_, plint nz_,
-        Dynamics<T,Descriptor>* backgroundDynamics_ )
+        Dynamics<T,Descriptor>* backgroundDynamics_,
+        LatticeStorage::StorageT storage_ )
     : AtomicBlock3D(nx_, ny_, nz_),
       backgroundDynamics(backgroundDynamics_),
+      rawData(0), grid(0), populationArrays(0),
       dataTransfer(*this)
 {
     plint nx = this->getNx();
     plint ny = this->getNy();
     plint nz = this->getNz();
     // Allocate memory, and initialize dynamics.
-    allocateAndInitialize();
-    for (plint iX=0; iX<nx; ++iX) {
-        for (plint iY=0; iY<ny; ++iY) {
-            for (plint iZ=0; iZ<nz; ++iZ) {
-                grid[iX][iY][iZ].attributeDynamics(backgroundDynamics);
+    allocateAndInitialize(storage_);
+    if (!populationArrays) {
+        for (plint iX=0; iX<nx; ++iX) {
+            for (plint iY=0; iY<ny; ++iY) {
+                for (plint iZ=0; iZ<nz; ++iZ) {
+                    grid[iX][iY][iZ].attributeDynamics(backgroundDynamics);
+                }
             }
         }
     }
@@ -103,12 +108,22 @@ BlockLattice3D<T,Descriptor>::BlockLattice3D(BlockLattice3D<T,Descriptor> const&
     : BlockLatticeBase3D<T,Descriptor>(rhs),
       AtomicBlock3D(rhs),
       backgroundDynamics(rhs.backgroundDynamics->clone()),
+      rawData(0), grid(0), populationArrays(0),
       dataTransfer(*this)
 {
+    if (rhs.populationArrays) {
+        this->getInternalStatistics().subscribeAverage(); // Subscribe average rho-bar
+        this->getInternalStatistics().subscribeAverage(); // Subscribe average uSqr
+        this->getInternalStatistics().subscribeMax();     // Subscribe max uSqr
+        // Copy the arrays, and get independent clones of the dynamics.
+        populationArrays = new PopulationArrays3D<T,Descriptor>(*rhs.populationArrays);
+        populationArrays->cloneDynamics(backgroundDynamics);
+        return;
+    }
     plint nx = this->getNx();
     plint ny = this->getNy();
     plint nz = this->getNz();
-    allocateAndInitialize();
+    allocateAndInitialize(LatticeStorage::cellArray);
     for (plint iX=0; iX<nx; ++iX) {
         for (plint iY=0; iY<ny; ++iY) {
             for (plint iZ=0; iZ<nz; ++iZ) {
@@ -153,6 +168,7 @@ void BlockLattice3D<T,Descriptor>::swap(BlockLattice3D& rhs) {
     std::swap(backgroundDynamics, rhs.backgroundDynamics);
     std::swap(rawData, rhs.rawData);
     std::swap(grid, rhs.grid);
+    std::swap(populationArrays, rhs.populationArrays);
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -163,6 +179,11 @@ void BlockLattice3D<T,Descriptor>::specifyStatisticsStatus(Box3D domain, bool st
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                if (populationArrays) {
+                    populationArrays->specifyStatisticsStatus (
+                            populationArrays->cellIndex(iX,iY,iZ), status );
+                    continue;
+                }
                 grid[iX][iY][iZ].specifyStatisticsStatus(status);
             }
         }
@@ -174,6 +195,11 @@ void BlockLattice3D<T,Descriptor>::collide(Box3D domain) {
     // Make sure domain is contained within current lattice
     PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
 
+    if (populationArrays) {
+        populationArrays->collide(domain, this->getInternalStatistics());
+        return;
+    }
+
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
@@ -257,6 +283,14 @@ void BlockLattice3D<T,Descriptor>::collideAndStream(Box3D domain) {
     global::profiler().start("collStream");
     global::profiler().increment("collStreamCells", domain.nCells());
 
+    // With two lattices, collision and streaming are done in a single
+    // pass, without the special treatment of the boundary envelope.
+    if (populationArrays && populationArrays->usesTwoLattices()) {
+        populationArrays->twoLatticeCollideAndStream(domain, this->getInternalStatistics());
+        global::profiler().stop("collStream");
+        return;
+    }
+
     static const plint vicinity = Descriptor<T>::vicinity;
 
     // First, do the collision on cells within a boundary envelope of width
@@ -311,6 +345,85 @@ void BlockLattice3D<T,Descriptor>::collideAndStream(Box3D domain) {
     global::profiler().stop("collStream");
 }
 
+/** The shell is processed as six slabs, with one call to collideAndStream(Box3D)
+ * per slab, after which the populations exchanged between the slabs are
+ * streamed. Streaming consists of independent swaps between pairs of
+ * neighboring cells, and the result is therefore the same as with
+ * collideAndStream(domain). On small domains, and with two lattices, the
+ * step is not split and executed in full by collideAndStreamShell().
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::collideAndStreamShell(Box3D domain, plint width) {
+    std::vector<Box3D> shell;
+    Box3D interior;
+    if (!decomposeShell(domain, width, shell, interior)) {
+        collideAndStream(domain);
+        return;
+    }
+    for (pluint iSlab=0; iSlab<shell.size(); ++iSlab) {
+        collideAndStream(shell[iSlab]);
+    }
+    for (pluint iSlab=0; iSlab<shell.size(); ++iSlab) {
+        for (pluint jSlab=iSlab+1; jSlab<shell.size(); ++jSlab) {
+            streamBetween(shell[iSlab], shell[jSlab]);
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::collideAndStreamInterior(Box3D domain, plint width) {
+    std::vector<Box3D> shell;
+    Box3D interior;
+    if (!decomposeShell(domain, width, shell, interior)) {
+        return;
+    }
+    collideAndStream(interior);
+    for (pluint iSlab=0; iSlab<shell.size(); ++iSlab) {
+        streamBetween(interior, shell[iSlab]);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool BlockLattice3D<T,Descriptor>::decomposeShell (
+        Box3D domain, plint width, std::vector<Box3D>& shell, Box3D& interior ) const
+{
+    static const plint vicinity = Descriptor<T>::vicinity;
+    PLB_PRECONDITION( width >= vicinity );
+    if (populationArrays && populationArrays->usesTwoLattices()) {
+        return false;
+    }
+    // The slabs and the interior must be thick enough for collideAndStream(Box3D).
+    plint t = width+vicinity;
+    plint minExtent = 2*t + 2*vicinity;
+    if (domain.getNx()<minExtent || domain.getNy()<minExtent || domain.getNz()<minExtent) {
+        return false;
+    }
+    shell.clear();
+    shell.push_back(Box3D(domain.x0,     domain.x0+t-1, domain.y0,     domain.y1,     domain.z0, domain.z1));
+    shell.push_back(Box3D(domain.x1-t+1, domain.x1,     domain.y0,     domain.y1,     domain.z0, domain.z1));
+    shell.push_back(Box3D(domain.x0+t,   domain.x1-t,   domain.y0,     domain.y0+t-1, domain.z0, domain.z1));
+    shell.push_back(Box3D(domain.x0+t,   domain.x1-t,   domain.y1-t+1, domain.y1,     domain.z0, domain.z1));
+    shell.push_back(Box3D(domain.x0+t,   domain.x1-t,   domain.y0+t,   domain.y1-t,   domain.z0, domain.z0+t-1));
+    shell.push_back(Box3D(domain.x0+t,   domain.x1-t,   domain.y0+t,   domain.y1-t,   domain.z1-t+1, domain.z1));
+    interior = Box3D(domain.x0+t, domain.x1-t, domain.y0+t, domain.y1-t, domain.z0+t, domain.z1-t);
+    return true;
+}
+
+/** Each pair of neighboring cells, with one cell in each box, exchanges its
+ *  populations exactly once.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::streamBetween(Box3D box1, Box3D box2) {
+    static const plint vicinity = Descriptor<T>::vicinity;
+    Box3D inters;
+    if (intersect(box1, box2.enlarge(vicinity), inters)) {
+        boundaryStream(box2, inters);
+    }
+    if (intersect(box2, box1.enlarge(vicinity), inters)) {
+        boundaryStream(box1, inters);
+    }
+}
+
 /** At the end of this method, finalizeIteration() and
  * executeInternalProcessors() are automatically invoked.
  * \sa collideAndStream(int,int,int,int,int,int) */
@@ -331,7 +444,7 @@ void BlockLattice3D<T,Descriptor>::incrementTime() {
 }
 
 template<typename T, template<typename U> class Descriptor>
-void BlockLattice3D<T,Descriptor>::allocateAndInitialize() {
+void BlockLattice3D<T,Descriptor>::allocateAndInitialize(LatticeStorage::StorageT storage) {
     this->getInternalStatistics().subscribeAverage(); // Subscribe average rho-bar
     this->getInternalStatistics().subscribeAverage(); // Subscribe average uSqr
     this->getInternalStatistics().subscribeMax();     // Subscribe max uSqr
@@ -339,6 +452,14 @@ void BlockLattice3D<T,Descriptor>::allocateAndInitialize() {
     plint nx = this->getNx();
     plint ny = this->getNy();
     plint nz = this->getNz();
+    if (storage!=LatticeStorage::cellArray) {
+        populationArrays = new PopulationArrays3D<T,Descriptor> (
+                nx,ny,nz, backgroundDynamics,
+                LatticeStorage::usesTwoLattices(storage),
+                LatticeStorage::usesSinglePrecision(storage),
+                LatticeStorage::usesSparseStorage(storage) );
+        return;
+    }
     rawData = new Cell<T,Descriptor> [nx*ny*nz];
     grid    = new Cell<T,Descriptor>** [nx];
     for (plint iX=0; iX<nx; ++iX) {
@@ -351,6 +472,13 @@ void BlockLattice3D<T,Descriptor>::allocateAndInitialize() {
 
 template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::releaseMemory() {
+    if (populationArrays) {
+        populationArrays->synchronizeCellViews();
+        populationArrays->deleteDynamics();
+        delete populationArrays;
+        delete backgroundDynamics;
+        return;
+    }
     plint nx = this->getNx();
     plint ny = this->getNy();
     plint nz = this->getNz();
@@ -376,6 +504,15 @@ template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::attributeDynamics (
         plint iX, plint iY, plint iZ, Dynamics<T,Descriptor>* dynamics )
 {
+    if (populationArrays) {
+        plint iCell = populationArrays->cellIndex(iX,iY,iZ);
+        Dynamics<T,Descriptor>* previousDynamics = &populationArrays->getDynamics(iCell);
+        populationArrays->attributeDynamics(iCell, dynamics);
+        if (previousDynamics != backgroundDynamics) {
+            delete previousDynamics;
+        }
+        return;
+    }
     Dynamics<T,Descriptor>* previousDynamics = &grid[iX][iY][iZ].getDynamics();
     if (previousDynamics != backgroundDynamics) {
         delete previousDynamics;
@@ -393,18 +530,40 @@ Dynamics<T,Descriptor> const& BlockLattice3D<T,Descriptor>::getBackgroundDynamic
     return *backgroundDynamics;
 }
 
+template<typename T, template<typename U> class Descriptor>
+LatticeStorage::StorageT BlockLattice3D<T,Descriptor>::getStorage() const {
+    if (!populationArrays) {
+        return LatticeStorage::cellArray;
+    }
+    if (populationArrays->usesSparseStorage()) {
+        return LatticeStorage::sparsePopulationArrays;
+    }
+    if (populationArrays->usesSinglePrecision()) {
+        return populationArrays->usesTwoLattices() ? LatticeStorage::twoFloatPopulationArrays
+                                                   : LatticeStorage::floatPopulationArrays;
+    }
+    return populationArrays->usesTwoLattices() ? LatticeStorage::twoPopulationArrays
+                                               : LatticeStorage::populationArrays;
+}
+
 /** This method is slower than bulkStream(int,int,int,int), because it must
  * be verified which distribution functions are to be kept from leaving
- * the domain.
+ * the domain. The populations of the cells in domain are exchanged with
+ * the neighbors which are inside bound. Usually, domain is contained in bound,
+ * but it can also be disjoint from it (see streamBetween()).
  * \sa stream(int,int,int,int)
  * \sa stream()
  */
 template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::boundaryStream(Box3D bound, Box3D domain) {
-    // Make sure bound is contained within current lattice
+    // Make sure bound and domain are contained within current lattice
     PLB_PRECONDITION( contained(bound, this->getBoundingBox()) );
-    // Make sure domain is contained within bound
-    PLB_PRECONDITION( contained(domain, bound) );
+    PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
+
+    if (populationArrays) {
+        populationArrays->boundaryStream(bound, domain);
+        return;
+    }
 
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
@@ -436,6 +595,11 @@ void BlockLattice3D<T,Descriptor>::bulkStream(Box3D domain) {
     // Make sure domain is contained within current lattice
     PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
 
+    if (populationArrays) {
+        populationArrays->bulkStream(domain);
+        return;
+    }
+
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
@@ -461,18 +625,19 @@ void BlockLattice3D<T,Descriptor>::bulkCollideAndStream(Box3D domain) {
     // Make sure domain is contained within current lattice
     PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
 
-    // if (Descriptor<T>::q==15 || Descriptor<T>::q==19) {
-    if (Descriptor<T>::q==19) {
-        // On nearest-neighbor lattice, use the cache-efficient
-        //   version of collidAndStream.
-        blockwiseBulkCollideAndStream(domain);
+    // The tile shape is auto-tuned on the first sweeps. A tile shape of 0 means
+    //   that the straightforward implementation is faster on this platform. This
+    //   is typically the case with population arrays, because the long runs of
+    //   cells along the z-direction are collided with vectorized kernels.
+    CachePolicy3D& policy = cachePolicy(getStorage());
+    Dot3D tileShape = policy.startSweep(domain.nCells());
+    if (tileShape.x > 0 && tileShape.y > 0 && tileShape.z > 0) {
+        blockwiseBulkCollideAndStream(domain, tileShape);
     }
     else {
-        // Otherwise, use the straightforward implementation.
-        //   Note that at some point, we should implement the cache-efficient
-        //   version for extended lattices as well.
         linearBulkCollideAndStream(domain);
     }
+    policy.stopSweep(domain.nCells());
 }
 
 
@@ -484,66 +649,66 @@ void BlockLattice3D<T,Descriptor>::linearBulkCollideAndStream(Box3D domain) {
     // Make sure domain is contained within current lattice
     PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
 
+    if (populationArrays) {
+        populationArrays->linearBulkCollideAndStream(domain, this->getInternalStatistics());
+        return;
+    }
+
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
-            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
-                grid[iX][iY][iZ].collide(this->getInternalStatistics());
-                latticeTemplates<T,Descriptor>::swapAndStream3D(grid, iX, iY, iZ);
-            }
+            bulkCollideAndStreamRow(iX, iY, domain.z0, domain.z1);
         }
     }
 }
 
 
 /** Sophisticated implementation which improves cache usage through block-wise
- *  loops. For now, this works only with nearest-neighbor lattices. On extended
- *  lattices, the naive version "linearBulkCollideAndStream" is used.
+ *  loops. It works with all lattices, including extended ones: the blocks are
+ *  sheared according to the velocity set, as explained in
+ *  indexTemplates::SwapStreamingSkew3D.
  */
 template<typename T, template<typename U> class Descriptor>
-void BlockLattice3D<T,Descriptor>::blockwiseBulkCollideAndStream(Box3D domain) {
+void BlockLattice3D<T,Descriptor>::blockwiseBulkCollideAndStream(Box3D domain, Dot3D tileShape) {
     // Make sure domain is contained within current lattice
     PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
+    PLB_PRECONDITION( tileShape.x > 0 && tileShape.y > 0 && tileShape.z > 0 );
 
-    // For cache efficiency, memory is traversed block-wise. The three outer loops enumerate
-    //   the blocks, whereas the three inner loops enumerate the cells inside each block.
-    const plint blockSize = cachePolicy().getBlockSize();
-    // Outer loops.
-    for (plint outerX=domain.x0; outerX<=domain.x1; outerX+=blockSize) {
-        for (plint outerY=domain.y0; outerY<=domain.y1+blockSize-1; outerY+=blockSize) {
-            for (plint outerZ=domain.z0; outerZ<=domain.z1+2*(blockSize-1); outerZ+=blockSize) {
+    if (populationArrays) {
+        populationArrays->blockwiseBulkCollideAndStream (
+                domain, tileShape, this->getInternalStatistics() );
+        return;
+    }
+    indexTemplates::SwapStreamingSkew3D<Descriptor<T> > const& skew =
+        indexTemplates::swapStreamingSkew3D<Descriptor<T> >();
+    const plint xShiftY = skew.getXshiftY();
+    const plint xShiftZ = skew.getXshiftZ();
+    const plint yShiftZ = skew.getYshiftZ();
+    const plint ny = domain.getNy();
+    const plint nz = domain.getNz();
+
+    // For cache efficiency, memory is traversed block-wise. The blocks are slabs
+    //   of tileShape.x cells along x, which are tiled in the skewed coordinates
+    //   v = y+xShiftY*x and w = z+xShiftZ*x+yShiftZ*y (relative to the origin
+    //   of the domain), with tileShape.y and tileShape.z cells. The skew ensures
+    //   that only post-collision cells are accessed during the swap-operation
+    //   of the streaming.
+    for (plint outerX=0; outerX<domain.getNx(); outerX+=tileShape.x) {
+        plint endX = std::min(outerX+tileShape.x, domain.getNx())-1;
+        for (plint outerV=xShiftY*outerX; outerV<=ny-1+xShiftY*endX; outerV+=tileShape.y) {
+            plint endV = outerV+tileShape.y-1;
+            plint minY = std::max((plint)0, outerV-xShiftY*endX);
+            plint maxY = std::min(ny-1, endV-xShiftY*outerX);
+            for (plint outerW=xShiftZ*outerX+yShiftZ*minY; outerW<=nz-1+xShiftZ*endX+yShiftZ*maxY; outerW+=tileShape.z) {
+                plint endW = outerW+tileShape.z-1;
                 // Inner loops.
-                plint dx = 0;
-                for (plint innerX=outerX;
-                     innerX <= std::min(outerX+blockSize-1, domain.x1);
-                     ++innerX, ++dx)
-                {
-                    // Y-index is shifted in negative direction at each x-increment. to ensure
-                    //   that only post-collision cells are accessed during the swap-operation
-                    //   of the streaming.
-                    plint minY = outerY-dx;
-                    plint maxY = minY+blockSize-1;
-                    plint dy = 0;
-                    for (plint innerY=std::max(minY,domain.y0);
-                         innerY <= std::min(maxY, domain.y1);
-                         ++innerY, ++dy)
-                    {
-                        // Z-index is shifted in negative direction at each x-increment. and at each
-                        //    y-increment, to ensure that only post-collision cells are accessed during
-                        //    the swap-operation of the streaming.
-                        plint minZ = outerZ-dx-dy;
-                        plint maxZ = minZ+blockSize-1;
-                        for (plint innerZ=std::max(minZ,domain.z0);
-                             innerZ <= std::min(maxZ, domain.z1);
-                             ++innerZ)
-                        {
-                            // Collide the cell.
-                            grid[innerX][innerY][innerZ].collide (
-                                    this->getInternalStatistics() );
-                            // Swap the populations on the cell, and then with post-collision
-                            //   neighboring cell, to perform the streaming step.
-                            latticeTemplates<T,Descriptor>::swapAndStream3D (
-                                    grid, innerX, innerY, innerZ );
-                        }
+                for (plint dx=outerX; dx<=endX; ++dx) {
+                    plint startY = std::max((plint)0, outerV-xShiftY*dx);
+                    plint endY = std::min(ny-1, endV-xShiftY*dx);
+                    for (plint dy=startY; dy<=endY; ++dy) {
+                        plint startZ = std::max((plint)0, outerW-xShiftZ*dx-yShiftZ*dy);
+                        plint endZ = std::min(nz-1, endW-xShiftZ*dx-yShiftZ*dy);
+                        bulkCollideAndStreamRow ( domain.x0+dx, domain.y0+dy,
+                                                  domain.z0+startZ, domain.z0+endZ );
                     }
                 }
             }
@@ -551,6 +716,31 @@ void BlockLattice3D<T,Descriptor>::blockwiseBulkCollideAndStream(Box3D domain) {
     }
 }
 
+/** All cells of a run are first collided, and then streamed. This is equivalent
+ *  to the cell-by-cell execution of collide() and swapAndStream3D(), because the
+ *  swap-operation of a cell only modifies the previously processed neighbors.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::bulkCollideAndStreamRow (
+        plint iX, plint iY, plint z0, plint z1 )
+{
+    Cell<T,Descriptor>* row = grid[iX][iY];
+    plint iZ = z0;
+    while (iZ <= z1) {
+        Dynamics<T,Descriptor>* dynamics = &row[iZ].getDynamics();
+        plint runEnd = iZ+1;
+        while (runEnd <= z1 && &row[runEnd].getDynamics() == dynamics) {
+            ++runEnd;
+        }
+        dynamics->collideSequence(row+iZ, runEnd-iZ, this->getInternalStatistics());
+        for (; iZ<runEnd; ++iZ) {
+            // Swap the populations on the cell, and then with post-collision
+            //   neighboring cell, to perform the streaming step.
+            latticeTemplates<T,Descriptor>::swapAndStream3D(grid, iX, iY, iZ);
+        }
+    }
+}
+
 template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::implementPeriodicity() {
     static const plint vicinity = Descriptor<T>::vicinity;
@@ -595,6 +785,10 @@ void BlockLattice3D<T,Descriptor>::implementPeriodicity() {
 
 template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::periodicDomain(Box3D domain) {
+    if (populationArrays) {
+        populationArrays->periodicDomain(domain);
+        return;
+    }
     plint nx = this->getNx();
     plint ny = this->getNy();
     plint nz = this->getNz();
@@ -672,23 +866,152 @@ template<typename T, template<typename U> class Descriptor>
 void BlockLatticeDataTransfer3D<T,Descriptor>::send_static (
         Box3D domain, std::vector<char>& buffer ) const
 {
-    plint cellSize = staticCellSize();
-    pluint numBytes = domain.nCells()*cellSize;
+    pluint numBytes = domain.nCells()*staticCellSize();
     // Avoid dereferencing uninitialized pointer.
     if (numBytes==0) return;
     buffer.resize(numBytes);
+    sendStatic(domain, &buffer[0]);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLatticeDataTransfer3D<T,Descriptor>::sendStatic (
+        Box3D domain, char* buffer ) const
+{
+    PLB_PRECONDITION(contained(domain, lattice.getBoundingBox()));
+    plint cellSize = staticCellSize();
+    // Avoid dereferencing uninitialized pointer.
+    if (domain.nCells()*cellSize==0) return;
 
     plint iData=0;
+    if (lattice.populationArrays) {
+        PopulationArrays3D<T,Descriptor> const& arrays = *lattice.populationArrays;
+        arrays.synchronizeCellViews();
+        for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+            for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+                for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                    arrays.serialize(arrays.cellIndex(iX,iY,iZ), buffer+iData);
+                    iData += cellSize;
+                }
+            }
+        }
+        return;
+    }
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
-                lattice.get(iX,iY,iZ).serialize(&buffer[iData]);
+                lattice.get(iX,iY,iZ).serialize(buffer+iData);
                 iData += cellSize;
             }
         }
     }
 }
 
+/** A population f_i streams into a cell x of the envelope from outside the
+ *  block if x-c_i is outside the block. For a cell on the side n of the bulk,
+ *  this is the case of the velocities c_i which point towards the bulk along
+ *  at least one of the directions in which n is non-zero.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLatticeDataTransfer3D<T,Descriptor>::incomingPopulations (
+        plint normalX, plint normalY, plint normalZ, std::vector<plint>& pops )
+{
+    pops.clear();
+    for (plint iPop=0; iPop<Descriptor<T>::numPop; ++iPop) {
+        if ( Descriptor<T>::c[iPop][0]*normalX < 0 ||
+             Descriptor<T>::c[iPop][1]*normalY < 0 ||
+             Descriptor<T>::c[iPop][2]*normalZ < 0 )
+        {
+            pops.push_back(iPop);
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+plint BlockLatticeDataTransfer3D<T,Descriptor>::incomingCellSize (
+        plint normalX, plint normalY, plint normalZ ) const
+{
+    std::vector<plint> pops;
+    incomingPopulations(normalX, normalY, normalZ, pops);
+    return sizeof(T)*pops.size();
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLatticeDataTransfer3D<T,Descriptor>::sendIncoming (
+        Box3D domain, plint normalX, plint normalY, plint normalZ, char* buffer ) const
+{
+    PLB_PRECONDITION(contained(domain, lattice.getBoundingBox()));
+    std::vector<plint> pops;
+    incomingPopulations(normalX, normalY, normalZ, pops);
+    plint cellSize = sizeof(T)*pops.size();
+    // Avoid dereferencing uninitialized pointer.
+    if (domain.nCells()*cellSize==0) return;
+
+    plint iData=0;
+    if (lattice.populationArrays) {
+        PopulationArrays3D<T,Descriptor> const& arrays = *lattice.populationArrays;
+        arrays.synchronizeCellViews();
+        for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+            for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+                for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                    arrays.serializePopulations(arrays.cellIndex(iX,iY,iZ), pops, buffer+iData);
+                    iData += cellSize;
+                }
+            }
+        }
+        return;
+    }
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                Cell<T,Descriptor> const& cell = lattice.get(iX,iY,iZ);
+                for (pluint i=0; i<pops.size(); ++i) {
+                    memcpy((void*)(buffer+iData), (const void*)(&cell[pops[i]]), sizeof(T));
+                    iData += sizeof(T);
+                }
+            }
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLatticeDataTransfer3D<T,Descriptor>::receiveIncoming (
+        Box3D domain, plint normalX, plint normalY, plint normalZ,
+        char const* buffer, Dot3D absoluteOffset )
+{
+    PLB_PRECONDITION(contained(domain, lattice.getBoundingBox()));
+    std::vector<plint> pops;
+    incomingPopulations(normalX, normalY, normalZ, pops);
+    plint cellSize = sizeof(T)*pops.size();
+    // Avoid dereferencing uninitialized pointer.
+    if (domain.nCells()*cellSize==0) return;
+
+    plint iData=0;
+    if (lattice.populationArrays) {
+        PopulationArrays3D<T,Descriptor>& arrays = *lattice.populationArrays;
+        arrays.synchronizeCellViews();
+        for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+            for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+                for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                    arrays.unSerializePopulations(arrays.cellIndex(iX,iY,iZ), pops, buffer+iData);
+                    iData += cellSize;
+                }
+            }
+        }
+        return;
+    }
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                Cell<T,Descriptor>& cell = lattice.get(iX,iY,iZ);
+                for (pluint i=0; i<pops.size(); ++i) {
+                    memcpy((void*)(&cell[pops[i]]), (const void*)(buffer+iData), sizeof(T));
+                    iData += sizeof(T);
+                }
+            }
+        }
+    }
+}
+
 template<typename T, template<typename U> class Descriptor>
 void BlockLatticeDataTransfer3D<T,Descriptor>::send_dynamic (
         Box3D domain, std::vector<char>& buffer ) const
@@ -764,13 +1087,36 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::receive_static (
     PLB_PRECONDITION( (plint) buffer.size() == domain.nCells()*staticCellSize() );
     // Avoid dereferencing uninitialized pointer.
     if (buffer.empty()) return;
+    receiveStatic(domain, &buffer[0], Dot3D());
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLatticeDataTransfer3D<T,Descriptor>::receiveStatic (
+        Box3D domain, char const* buffer, Dot3D absoluteOffset )
+{
+    PLB_PRECONDITION(contained(domain, lattice.getBoundingBox()));
     plint cellSize = staticCellSize();
+    // Avoid dereferencing uninitialized pointer.
+    if (domain.nCells()*cellSize==0) return;
 
     plint iData=0;
+    if (lattice.populationArrays) {
+        PopulationArrays3D<T,Descriptor>& arrays = *lattice.populationArrays;
+        arrays.synchronizeCellViews();
+        for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+            for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+                for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                    arrays.unSerialize(arrays.cellIndex(iX,iY,iZ), buffer+iData);
+                    iData += cellSize;
+                }
+            }
+        }
+        return;
+    }
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
-                lattice.get(iX,iY,iZ).unSerialize(&buffer[iData]);
+                lattice.get(iX,iY,iZ).unSerialize(buffer+iData);
                 iData += cellSize;
             }
         }
@@ -874,6 +1220,22 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::attribute_static (
         Box3D toDomain, plint deltaX, plint deltaY, plint deltaZ,
         BlockLattice3D<T,Descriptor> const& from )
 {
+    if (lattice.populationArrays && from.populationArrays) {
+        PopulationArrays3D<T,Descriptor>& arrays = *lattice.populationArrays;
+        PopulationArrays3D<T,Descriptor> const& fromArrays = *from.populationArrays;
+        arrays.synchronizeCellViews();
+        fromArrays.synchronizeCellViews();
+        for (plint iX=toDomain.x0; iX<=toDomain.x1; ++iX) {
+            for (plint iY=toDomain.y0; iY<=toDomain.y1; ++iY) {
+                for (plint iZ=toDomain.z0; iZ<=toDomain.z1; ++iZ) {
+                    arrays.attributeValues (
+                            arrays.cellIndex(iX,iY,iZ), fromArrays,
+                            fromArrays.cellIndex(iX+deltaX,iY+deltaY,iZ+deltaZ) );
+                }
+            }
+        }
+        return;
+    }
     for (plint iX=toDomain.x0; iX<=toDomain.x1; ++iX) {
         for (plint iY=toDomain.y0; iY<=toDomain.y1; ++iY) {
             for (plint iZ=toDomain.z0; iZ<=toDomain.z1; ++iZ) {
@@ -960,8 +1322,37 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::attribute_regenerate (
 
 template<typename T, template<typename U> class Descriptor>
 CachePolicy3D& BlockLattice3D<T,Descriptor>::cachePolicy() {
-    static CachePolicy3D cachePolicySingleton(30);
-    return cachePolicySingleton;
+    return cachePolicy(LatticeStorage::cellArray);
+}
+
+/// The name of a policy in the file of the CachePolicyTuner contains the
+///   descriptor, the floating-point precision and the storage.
+template<typename T, template<typename U> class Descriptor>
+std::string BlockLattice3D<T,Descriptor>::cachePolicyName(std::string storageName) {
+    return std::string("BlockLattice3D.") + Descriptor<T>::name + "." +
+           util::val2str(8*sizeof(T)) + "bit." + storageName;
+}
+
+template<typename T, template<typename U> class Descriptor>
+CachePolicy3D& BlockLattice3D<T,Descriptor>::cachePolicy(LatticeStorage::StorageT storage) {
+    static CachePolicy3D cellArrayPolicySingleton (
+            30, true, cachePolicyName("cellArray") );
+    static CachePolicy3D populationArraysPolicySingleton (
+            0, true, cachePolicyName("populationArrays") );
+    static CachePolicy3D floatPopulationArraysPolicySingleton (
+            0, true, cachePolicyName("floatPopulationArrays") );
+    static CachePolicy3D sparsePopulationArraysPolicySingleton (
+            0, true, cachePolicyName("sparsePopulationArrays") );
+    if (storage==LatticeStorage::cellArray) {
+        return cellArrayPolicySingleton;
+    }
+    if (LatticeStorage::usesSparseStorage(storage)) {
+        return sparsePopulationArraysPolicySingleton;
+    }
+    if (LatticeStorage::usesSinglePrecision(storage)) {
+        return floatPopulationArraysPolicySingleton;
+    }
+    return populationArraysPolicySingleton;
 }
 
 
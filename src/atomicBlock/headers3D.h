@@ -30,6 +30,7 @@
 #include "atomicBlock/atomicContainerBlock3D.h"
 #include "atomicBlock/atomicBlockOperations3D.h"
 #include "atomicBlock/blockLattice3D.h"
+#include "atomicBlock/populationArrays3D.h"
 #include "atomicBlock/dataField3D.h"
 #include "atomicBlock/dataProcessor3D.h"
 #include "atomicBlock/dataProcessingFunctional3D.h"
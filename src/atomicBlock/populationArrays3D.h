@@ -0,0 +1,276 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+ * Structure-of-arrays storage for the cells of a 3D block lattice -- header file.
+ */
+#ifndef POPULATION_ARRAYS_3D_H
+#define POPULATION_ARRAYS_3D_H
+
+#include "core/globalDefs.h"
+#include "core/plbDebug.h"
+#include "core/cell.h"
+#include "core/geometry3D.h"
+#include "core/blockStatistics.h"
+#include <vector>
+#include <deque>
+
+namespace plb {
+
+/// Structure-of-arrays storage for the cells of a BlockLattice3D.
+/** Each population direction and each external scalar is stored in a
+ *  separate contiguous array which is aligned on a cache-line boundary.
+ *  The dynamics objects are referred to through an array of integer ids,
+ *  which index a table of dynamics objects. The id 0 always refers to the
+ *  background dynamics of the lattice.
+ *
+ *  Code which needs a Cell object (data processors, data transfer, ...)
+ *  is served with a cell view: a Cell which holds a copy of the content
+ *  of the lattice site. Cell views are written back into the arrays at
+ *  the next synchronization point, i.e. whenever the lattice executes a
+ *  collision or streaming step. References to a cell view remain valid
+ *  until then.
+ *
+ *  With two lattices, a second set of population arrays is allocated, and
+ *  the collision-streaming step reads the populations from one set and writes
+ *  them into the other one (AB pattern), in a single pass over memory. At the
+ *  end of each step, the two sets are exchanged, so that population() always
+ *  refers to the up-to-date populations.
+ *
+ *  In single precision, the populations are stored as float, while the
+ *  external scalars, the collision and the reductions keep the precision T.
+ *  Like in a Cell, the populations are stored with an offset (f_i - t_i),
+ *  which keeps their magnitude small and reduces the round-off error of the
+ *  conversion. The collision is executed on copies of the populations in
+ *  precision T, which are converted back before streaming.
+ *
+ *  In sparse mode, populations and external scalars are only stored for the
+ *  active cells, which are addressed indirectly through a slot index, and
+ *  streaming uses a precomputed list of the slots of the neighbors. A cell is
+ *  inactive if it is a solid cell (BounceBack or NoDynamics) surrounded by
+ *  solid cells: the fluid cells never access its populations. The set of
+ *  active cells is updated at the first synchronization after a change of
+ *  dynamics. Inactive cells are seen with zero populations through cell
+ *  views, and values written to them are discarded. Cells which become active
+ *  start with zero populations, unless they are written through cell views
+ *  before the update. As usual, fluid cells must not be adjacent to
+ *  NoDynamics cells.
+ *
+ *  The dynamics objects are not owned by this class. Their life time is
+ *  managed by BlockLattice3D.
+ */
+template<typename T, template<typename U> class Descriptor>
+class PopulationArrays3D {
+public:
+    PopulationArrays3D(plint nx_, plint ny_, plint nz_, Dynamics<T,Descriptor>* backgroundDynamics,
+                       bool twoLattices_=false, bool singlePrecision_=false, bool sparse_=false);
+    /// Copy construction. The dynamics objects are shared with rhs.
+    PopulationArrays3D(PopulationArrays3D<T,Descriptor> const& rhs);
+    ~PopulationArrays3D();
+    void swap(PopulationArrays3D<T,Descriptor>& rhs);
+public:
+    plint getNx() const { return nx; }
+    plint getNy() const { return ny; }
+    plint getNz() const { return nz; }
+    /// Whether a second set of population arrays is used for AB streaming.
+    bool usesTwoLattices() const { return twoLattices; }
+    /// Whether the populations are stored as float instead of T.
+    bool usesSinglePrecision() const { return singlePrecision; }
+    /// Whether only the active cells are stored (indirect addressing).
+    bool usesSparseStorage() const { return sparse; }
+    /// Number of cells for which populations are stored.
+    plint getNumStoredCells() const { return sparse ? numSlots : numCells; }
+    /// Linear index of a cell, which is used to access the individual arrays.
+    plint cellIndex(plint iX, plint iY, plint iZ) const {
+        PLB_PRECONDITION(iX>=0 && iX<nx);
+        PLB_PRECONDITION(iY>=0 && iY<ny);
+        PLB_PRECONDITION(iZ>=0 && iZ<nz);
+        return iZ + nz*(iY + ny*iX);
+    }
+    /// Array which holds the population iPop of all cells. S is T, or float
+    ///   in single precision. In sparse mode, the array is indexed by slots.
+    template<typename S>
+    S* population(plint iPop) {
+        PLB_PRECONDITION( iPop < Descriptor<T>::numPop );
+        PLB_PRECONDITION( sizeof(S) == populationSize() );
+        return (S*)populations + iPop*stride;
+    }
+    template<typename S>
+    S const* population(plint iPop) const {
+        PLB_PRECONDITION( iPop < Descriptor<T>::numPop );
+        PLB_PRECONDITION( sizeof(S) == populationSize() );
+        return (S const*)populations + iPop*stride;
+    }
+    /// Array which holds the external scalar iExt of all cells. In sparse
+    ///   mode, the array is indexed by slots.
+    T* external(plint iExt) {
+        PLB_PRECONDITION( iExt < Descriptor<T>::ExternalField::numScalars );
+        return externals + iExt*stride;
+    }
+    T const* external(plint iExt) const {
+        PLB_PRECONDITION( iExt < Descriptor<T>::ExternalField::numScalars );
+        return externals + iExt*stride;
+    }
+    int getDynamicsId(plint iCell) const {
+        return dynamicsIds[iCell];
+    }
+    Dynamics<T,Descriptor>& getDynamics(plint iCell) const {
+        return *dynamicsTable[dynamicsIds[iCell]];
+    }
+    /// Let a cell refer to a new dynamics object. The previous dynamics
+    ///   object is not deleted.
+    void attributeDynamics(plint iCell, Dynamics<T,Descriptor>* dynamics);
+    /// Replace all dynamics objects by independent clones, and the background
+    ///   dynamics by newBackground. To be used after copy-construction.
+    void cloneDynamics(Dynamics<T,Descriptor>* newBackground);
+    /// Delete all dynamics objects, except for the background dynamics.
+    void deleteDynamics();
+    bool takesStatistics(plint iCell) const {
+        return statisticsFlags[iCell];
+    }
+    void specifyStatisticsStatus(plint iCell, bool status);
+    /// Copy the content of a lattice site into a Cell object.
+    void gather(plint iCell, Cell<T,Descriptor>& cell) const {
+        if (singlePrecision) gather<float>(iCell, cell);
+        else gather<T>(iCell, cell);
+    }
+    /// Copy populations, external scalars and statistics status of a
+    ///   Cell object into a lattice site.
+    void scatter(plint iCell, Cell<T,Descriptor> const& cell) {
+        if (singlePrecision) scatter<float>(iCell, cell);
+        else scatter<T>(iCell, cell);
+    }
+    /// Serialize the static content of a cell, with the format of Cell::serialize().
+    void serialize(plint iCell, char* buffer) const;
+    /// Un-serialize the static content of a cell, with the format of Cell::unSerialize().
+    void unSerialize(plint iCell, char const* buffer);
+    /// Serialize the populations of a cell listed in pops, in precision T.
+    void serializePopulations(plint iCell, std::vector<plint> const& pops, char* buffer) const;
+    /// Un-serialize the populations of a cell listed in pops.
+    void unSerializePopulations(plint iCell, std::vector<plint> const& pops, char const* buffer);
+    /// Copy the static content of a cell of another storage.
+    void attributeValues(plint iCell, PopulationArrays3D<T,Descriptor> const& from, plint fromCell);
+public:
+    /// Get a cell view, which remains valid until the next synchronization.
+    Cell<T,Descriptor>& getCellView(plint iX, plint iY, plint iZ) const;
+    /// Write all cell views back into the arrays, and discard them.
+    void synchronizeCellViews() const;
+public:
+    /// Collision step followed by a reversion of the populations, as in BlockLattice3D::collide().
+    void collide(Box3D domain, BlockStatistics& statistics);
+    void bulkStream(Box3D domain);
+    void boundaryStream(Box3D bound, Box3D domain);
+    void linearBulkCollideAndStream(Box3D domain, BlockStatistics& statistics);
+    void blockwiseBulkCollideAndStream(Box3D domain, Dot3D tileShape, BlockStatistics& statistics);
+    /// Full collision-streaming step on the domain with the AB pattern; requires two lattices.
+    /** The result is the same as the one of the swap algorithm in BlockLattice3D::collideAndStream():
+     *  populations which would be streamed to a cell outside the domain are bounced back, and the
+     *  cells outside the domain are left unchanged.
+     */
+    void twoLatticeCollideAndStream(Box3D domain, BlockStatistics& statistics);
+    void periodicDomain(Box3D domain);
+private:
+    /// The methods templated on S are the implementations for the storage
+    ///   precision S (T, or float in single precision).
+    template<typename S> void gather(plint iCell, Cell<T,Descriptor>& cell) const;
+    template<typename S> void scatter(plint iCell, Cell<T,Descriptor> const& cell);
+    /// Value of a population in precision T.
+    T getPopulation(plint iPop, plint iCell) const;
+    void setPopulation(plint iPop, plint iCell, T value);
+    /// Index of the cell in the arrays, or -1 for an inactive cell.
+    plint slotOf(plint iCell) const {
+        return sparse ? cellSlots[iCell] : iCell;
+    }
+    /// Recompute the set of active cells and reallocate the arrays, in sparse mode.
+    void updateActiveCells();
+    /// Whether cells with this dynamics can be inactive, in sparse mode.
+    static bool isSolid(Dynamics<T,Descriptor> const& dynamics);
+    template<typename S> void bulkStream(Box3D domain);
+    template<typename S> void boundaryStream(Box3D bound, Box3D domain);
+    template<typename S> void twoLatticeCollideAndStream(Box3D domain, BlockStatistics& statistics);
+    template<typename S> void periodicDomain(Box3D domain);
+    /// Collision and streaming step on the cells (iX,iY,z0) to (iX,iY,z1), with one
+    ///   call to Dynamics::collideSequence() per run of cells with the same dynamics.
+    ///   In single precision, the runs are collided in runBuffer.
+    void collideAndStreamRow( plint iX, plint iY, plint z0, plint z1,
+                              std::vector<Cell<T,Descriptor> >& cells, std::vector<T>& runBuffer,
+                              BlockStatistics& statistics );
+    /// Write back a post-collision cell, and apply the streaming step with the swap algorithm.
+    template<typename S> void swapStream(plint iCell, Cell<T,Descriptor> const& cell);
+    /// Apply the streaming step with the swap algorithm to a post-collision cell.
+    template<typename S> void swapStream(plint iCell);
+    /// Counterpart of boundaryStream() in sparse mode.
+    void sparseStream(Box3D bound, Box3D domain);
+    /// Counterparts of swapStream() in sparse mode.
+    void sparseSwapStream(plint slot, Cell<T,Descriptor> const& cell);
+    void sparseSwapStream(plint slot);
+    /// Collision of a run of cells with the same dynamics, starting at iCell. The collision
+    ///   is executed directly on the arrays f if the dynamics supports it (return value
+    ///   true), and otherwise on copies of the cells in the buffer "cells" (return value false).
+    bool collideRun( T* f[Descriptor<T>::numPop], plint iCell, plint runLength,
+                     std::vector<Cell<T,Descriptor> >& cells, BlockStatistics& statistics );
+    /// Stream populations, which are stored in the buffer rowBuffer, from the cells
+    ///   (iX,iY,domain.z0) to (iX,iY,domain.z1) into the spare population arrays.
+    template<typename S> void pushRow(plint iX, plint iY, Box3D const& domain, T const* rowBuffer);
+    template<typename S> S* sparePopulation(plint iPop) {
+        return (S*)sparePopulations + iPop*stride;
+    }
+    /// Size in bytes of a stored population.
+    plint populationSize() const {
+        return singlePrecision ? (plint)sizeof(float) : (plint)sizeof(T);
+    }
+    void allocateMemory();
+    void computeNeighborOffsets();
+private:
+    PopulationArrays3D<T,Descriptor>& operator=(PopulationArrays3D<T,Descriptor> const& rhs);
+private:
+    plint nx, ny, nz;
+    plint numCells, stride;
+    bool twoLattices;
+    bool singlePrecision;
+    bool sparse;
+    plint numSlots;
+    std::vector<int> cellSlots;
+    /// Slots of the neighbors in the directions 1 to q/2 of each active cell,
+    ///   or -1 for inactive cells and for cells outside the block.
+    std::vector<int> neighborSlots;
+    mutable bool activeCellsOutdated;
+    char* rawMemory;
+    char* populations;
+    T*    externals;
+    char* sparePopulations;
+    plint neighborOffset[Descriptor<T>::numPop];
+    std::vector<int> dynamicsIds;
+    std::vector<char> statisticsFlags;
+    std::vector<Dynamics<T,Descriptor>*> dynamicsTable;
+    std::vector<int> freeDynamicsIds;
+    mutable std::vector<int> viewSlots;
+    mutable std::deque<Cell<T,Descriptor> > views;
+    mutable std::vector<plint> viewedCells;
+};
+
+}  // namespace plb
+
+#endif  // POPULATION_ARRAYS_3D_H
@@ -0,0 +1,1025 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Structure-of-arrays storage for the cells of a 3D block lattice -- generic implementation.
+ */
+#ifndef POPULATION_ARRAYS_3D_HH
+#define POPULATION_ARRAYS_3D_HH
+
+#include "atomicBlock/populationArrays3D.h"
+#include "core/dynamics.h"
+#include "core/cell.h"
+#include "latticeBoltzmann/indexTemplates.h"
+#include <algorithm>
+#include <cstring>
+
+namespace plb {
+
+/* *************** Class PopulationArrays3D ********************************* */
+
+template<typename T, template<typename U> class Descriptor>
+PopulationArrays3D<T,Descriptor>::PopulationArrays3D (
+        plint nx_, plint ny_, plint nz_, Dynamics<T,Descriptor>* backgroundDynamics,
+        bool twoLattices_, bool singlePrecision_, bool sparse_ )
+    : nx(nx_), ny(ny_), nz(nz_),
+      numCells(nx_*ny_*nz_),
+      twoLattices(twoLattices_),
+      singlePrecision(singlePrecision_),
+      sparse(sparse_),
+      numSlots(0),
+      activeCellsOutdated(false),
+      rawMemory(0),
+      dynamicsIds(nx_*ny_*nz_, 0),
+      statisticsFlags(nx_*ny_*nz_, 1),
+      dynamicsTable(1, backgroundDynamics)
+{
+    // Cell ids and dynamics ids are stored as int.
+    PLB_ASSERT( numCells <= (plint)std::numeric_limits<int>::max() );
+    // The sparse mode is implemented for the swap algorithm in precision T only.
+    PLB_PRECONDITION( !sparse || (!twoLattices && !singlePrecision) );
+    computeNeighborOffsets();
+    if (sparse) {
+        updateActiveCells();
+        return;
+    }
+    allocateMemory();
+    // Like in the Cell class, populations and external scalars are
+    //   initialized to zero.
+    std::fill(externals, externals+Descriptor<T>::ExternalField::numScalars*stride, T());
+    if (singlePrecision) {
+        std::fill(population<float>(0), population<float>(0)+Descriptor<T>::numPop*stride, 0.f);
+    }
+    else {
+        std::fill(population<T>(0), population<T>(0)+Descriptor<T>::numPop*stride, T());
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+PopulationArrays3D<T,Descriptor>::PopulationArrays3D (
+        PopulationArrays3D<T,Descriptor> const& rhs )
+    : nx(rhs.nx), ny(rhs.ny), nz(rhs.nz),
+      numCells(rhs.numCells),
+      twoLattices(rhs.twoLattices),
+      singlePrecision(rhs.singlePrecision),
+      sparse(rhs.sparse),
+      numSlots(0),
+      activeCellsOutdated(false),
+      dynamicsIds(rhs.dynamicsIds),
+      statisticsFlags(rhs.statisticsFlags),
+      dynamicsTable(rhs.dynamicsTable),
+      freeDynamicsIds(rhs.freeDynamicsIds)
+{
+    rhs.synchronizeCellViews();
+    // After the synchronization, the active cells of rhs are up to date.
+    numSlots = rhs.numSlots;
+    cellSlots = rhs.cellSlots;
+    neighborSlots = rhs.neighborSlots;
+    allocateMemory();
+    memcpy((void*)populations, (const void*)rhs.populations, Descriptor<T>::numPop*stride*populationSize());
+    std::copy(rhs.externals, rhs.externals+Descriptor<T>::ExternalField::numScalars*stride, externals);
+    computeNeighborOffsets();
+}
+
+template<typename T, template<typename U> class Descriptor>
+PopulationArrays3D<T,Descriptor>::~PopulationArrays3D() {
+    delete [] rawMemory;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::swap(PopulationArrays3D<T,Descriptor>& rhs) {
+    std::swap(nx, rhs.nx);
+    std::swap(ny, rhs.ny);
+    std::swap(nz, rhs.nz);
+    std::swap(numCells, rhs.numCells);
+    std::swap(stride, rhs.stride);
+    std::swap(twoLattices, rhs.twoLattices);
+    std::swap(singlePrecision, rhs.singlePrecision);
+    std::swap(sparse, rhs.sparse);
+    std::swap(numSlots, rhs.numSlots);
+    cellSlots.swap(rhs.cellSlots);
+    neighborSlots.swap(rhs.neighborSlots);
+    std::swap(activeCellsOutdated, rhs.activeCellsOutdated);
+    std::swap(rawMemory, rhs.rawMemory);
+    std::swap(populations, rhs.populations);
+    std::swap(externals, rhs.externals);
+    std::swap(sparePopulations, rhs.sparePopulations);
+    for (plint iPop=0; iPop<Descriptor<T>::numPop; ++iPop) {
+        std::swap(neighborOffset[iPop], rhs.neighborOffset[iPop]);
+    }
+    dynamicsIds.swap(rhs.dynamicsIds);
+    statisticsFlags.swap(rhs.statisticsFlags);
+    dynamicsTable.swap(rhs.dynamicsTable);
+    freeDynamicsIds.swap(rhs.freeDynamicsIds);
+    viewSlots.swap(rhs.viewSlots);
+    views.swap(rhs.views);
+    viewedCells.swap(rhs.viewedCells);
+}
+
+/** Each array is padded to a multiple of the cache-line size, so that
+ *  all arrays start on a cache-line boundary. The memory holds the
+ *  populations, followed by the external scalars, and by the spare
+ *  populations in case of two lattices. The spare populations are not
+ *  initialized. In sparse mode, only the active cells are allocated.
+ */
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::allocateMemory() {
+    static const plint alignment = 64;
+    const plint smallestSize = std::min(populationSize(), (plint)sizeof(T));
+    const plint valuesPerLine = std::max((plint)1, alignment/smallestSize);
+    const plint numStored = sparse ? numSlots : numCells;
+    stride = (numStored+valuesPerLine-1)/valuesPerLine*valuesPerLine;
+    const plint populationBytes = Descriptor<T>::numPop*stride*populationSize();
+    const plint externalBytes = Descriptor<T>::ExternalField::numScalars*stride*(plint)sizeof(T);
+    rawMemory = new char[populationBytes*(twoLattices ? 2:1) + externalBytes + alignment];
+    pluint address = (pluint)rawMemory;
+    populations = rawMemory + (alignment - address%alignment)%alignment;
+    externals = (T*) (populations + populationBytes);
+    sparePopulations = twoLattices ? populations + populationBytes + externalBytes : 0;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::computeNeighborOffsets() {
+    for (plint iPop=0; iPop<Descriptor<T>::numPop; ++iPop) {
+        neighborOffset[iPop] = Descriptor<T>::c[iPop][0]*ny*nz +
+                               Descriptor<T>::c[iPop][1]*nz +
+                               Descriptor<T>::c[iPop][2];
+    }
+}
+
+/** A cell is active if it is not solid, or if one of its neighbors is not
+ *  solid. Neighbors are looked up periodically across the block boundaries,
+ *  so that the cells are also correct for periodicDomain(). The slots are
+ *  attributed in the natural order of the cells, and the populations and
+ *  external scalars of cells which remain active are conserved.
+ */
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::updateActiveCells() {
+    PLB_PRECONDITION( sparse );
+    const plint numPop = Descriptor<T>::numPop;
+    const plint numScalars = Descriptor<T>::ExternalField::numScalars;
+    const plint half = Descriptor<T>::q/2;
+    std::vector<char> solidDynamics(dynamicsTable.size(), 0);
+    for (pluint iDyn=0; iDyn<dynamicsTable.size(); ++iDyn) {
+        if (dynamicsTable[iDyn]) {
+            solidDynamics[iDyn] = isSolid(*dynamicsTable[iDyn]);
+        }
+    }
+    std::vector<int> newSlots(numCells, -1);
+    plint newNumSlots = 0;
+    for (plint iX=0; iX<nx; ++iX) {
+        for (plint iY=0; iY<ny; ++iY) {
+            for (plint iZ=0; iZ<nz; ++iZ) {
+                plint iCell = cellIndex(iX,iY,iZ);
+                bool active = !solidDynamics[dynamicsIds[iCell]];
+                for (plint iPop=1; iPop<Descriptor<T>::q && !active; ++iPop) {
+                    plint nextX = (iX+Descriptor<T>::c[iPop][0]+nx)%nx;
+                    plint nextY = (iY+Descriptor<T>::c[iPop][1]+ny)%ny;
+                    plint nextZ = (iZ+Descriptor<T>::c[iPop][2]+nz)%nz;
+                    active = !solidDynamics[dynamicsIds[cellIndex(nextX,nextY,nextZ)]];
+                }
+                if (active) {
+                    newSlots[iCell] = (int)newNumSlots++;
+                }
+            }
+        }
+    }
+
+    char* oldRawMemory = rawMemory;
+    T* oldPopulations = population<T>(0);
+    T* oldExternals = externals;
+    plint oldStride = stride;
+    cellSlots.swap(newSlots);
+    std::vector<int>& oldSlots = newSlots;
+    numSlots = newNumSlots;
+    allocateMemory();
+    std::fill(population<T>(0), population<T>(0)+numPop*stride, T());
+    std::fill(externals, externals+numScalars*stride, T());
+    if (oldRawMemory) {
+        for (plint iCell=0; iCell<numCells; ++iCell) {
+            plint oldSlot = oldSlots[iCell];
+            plint slot = cellSlots[iCell];
+            if (oldSlot>=0 && slot>=0) {
+                for (plint iPop=0; iPop<numPop; ++iPop) {
+                    population<T>(iPop)[slot] = oldPopulations[iPop*oldStride+oldSlot];
+                }
+                for (plint iExt=0; iExt<numScalars; ++iExt) {
+                    external(iExt)[slot] = oldExternals[iExt*oldStride+oldSlot];
+                }
+            }
+        }
+        delete [] oldRawMemory;
+    }
+
+    // The neighbors are only listed inside the block: the streaming step does
+    //   not cross the block boundaries.
+    neighborSlots.assign(numSlots*half, -1);
+    for (plint iX=0; iX<nx; ++iX) {
+        for (plint iY=0; iY<ny; ++iY) {
+            for (plint iZ=0; iZ<nz; ++iZ) {
+                plint slot = cellSlots[cellIndex(iX,iY,iZ)];
+                if (slot<0) continue;
+                for (plint iPop=1; iPop<=half; ++iPop) {
+                    plint nextX = iX + Descriptor<T>::c[iPop][0];
+                    plint nextY = iY + Descriptor<T>::c[iPop][1];
+                    plint nextZ = iZ + Descriptor<T>::c[iPop][2];
+                    if ( nextX>=0 && nextX<nx && nextY>=0 && nextY<ny &&
+                         nextZ>=0 && nextZ<nz )
+                    {
+                        neighborSlots[slot*half+iPop-1] = cellSlots[cellIndex(nextX,nextY,nextZ)];
+                    }
+                }
+            }
+        }
+    }
+    activeCellsOutdated = false;
+}
+
+/** Only the exact classes BounceBack and NoDynamics are considered solid: they
+ *  neither read nor write populations of neighboring cells. Derived classes,
+ *  which may for example measure forces, are kept active.
+ */
+template<typename T, template<typename U> class Descriptor>
+bool PopulationArrays3D<T,Descriptor>::isSolid(Dynamics<T,Descriptor> const& dynamics) {
+    static const int bounceBackId = BounceBack<T,Descriptor>().getId();
+    static const int noDynamicsId = NoDynamics<T,Descriptor>().getId();
+    int id = dynamics.getId();
+    return id==bounceBackId || id==noDynamicsId;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::attributeDynamics (
+        plint iCell, Dynamics<T,Descriptor>* dynamics )
+{
+    int oldId = dynamicsIds[iCell];
+    if (oldId!=0) {
+        dynamicsTable[oldId] = 0;
+        freeDynamicsIds.push_back(oldId);
+    }
+    int newId = 0;
+    if (dynamics != dynamicsTable[0]) {
+        if (freeDynamicsIds.empty()) {
+            newId = (int)dynamicsTable.size();
+            dynamicsTable.push_back(dynamics);
+        }
+        else {
+            newId = freeDynamicsIds.back();
+            freeDynamicsIds.pop_back();
+            dynamicsTable[newId] = dynamics;
+        }
+    }
+    dynamicsIds[iCell] = newId;
+    if (sparse) {
+        activeCellsOutdated = true;
+    }
+    if (!viewSlots.empty() && viewSlots[iCell]>=0) {
+        views[viewSlots[iCell]].attributeDynamics(dynamics);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::cloneDynamics(Dynamics<T,Descriptor>* newBackground)
+{
+    dynamicsTable[0] = newBackground;
+    for (pluint iDyn=1; iDyn<dynamicsTable.size(); ++iDyn) {
+        if (dynamicsTable[iDyn]) {
+            dynamicsTable[iDyn] = dynamicsTable[iDyn]->clone();
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::deleteDynamics() {
+    for (pluint iDyn=1; iDyn<dynamicsTable.size(); ++iDyn) {
+        delete dynamicsTable[iDyn];
+    }
+    dynamicsTable.resize(1);
+    freeDynamicsIds.clear();
+    std::fill(dynamicsIds.begin(), dynamicsIds.end(), 0);
+    if (sparse) {
+        activeCellsOutdated = true;
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::specifyStatisticsStatus(plint iCell, bool status) {
+    statisticsFlags[iCell] = status;
+    if (!viewSlots.empty() && viewSlots[iCell]>=0) {
+        views[viewSlots[iCell]].specifyStatisticsStatus(status);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+template<typename S>
+void PopulationArrays3D<T,Descriptor>::gather(plint iCell, Cell<T,Descriptor>& cell) const {
+    plint slot = slotOf(iCell);
+    for (plint iPop=0; iPop<Descriptor<T>::numPop; ++iPop) {
+        cell[iPop] = slot>=0 ? (T) population<S>(iPop)[slot] : T();
+    }
+    for (plint iExt=0; iExt<Descriptor<T>::ExternalField::numScalars; ++iExt) {
+        *cell.getExternal(iExt) = slot>=0 ? external(iExt)[slot] : T();
+    }
+    cell.specifyStatisticsStatus(statisticsFlags[iCell]);
+    cell.attributeDynamics(dynamicsTable[dynamicsIds[iCell]]);
+}
+
+template<typename T, template<typename U> class Descriptor>
+template<typename S>
+void PopulationArrays3D<T,Descriptor>::scatter(plint iCell, Cell<T,Descriptor> const& cell) {
+    statisticsFlags[iCell] = cell.takesStatistics();
+    plint slot = slotOf(iCell);
+    if (slot<0) return;
+    for (plint iPop=0; iPop<Descriptor<T>::numPop; ++iPop) {
+        population<S>(iPop)[slot] = (S) cell[iPop];
+    }
+    for (plint iExt=0; iExt<Descriptor<T>::ExternalField::numScalars; ++iExt) {
+        external(iExt)[slot] = *cell.getExternal(iExt);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+T PopulationArrays3D<T,Descriptor>::getPopulation(plint iPop, plint iCell) const {
+    plint slot = slotOf(iCell);
+    if (slot<0) {
+        return T();
+    }
+    if (singlePrecision) {
+        return (T) population<float>(iPop)[slot];
+    }
+    return population<T>(iPop)[slot];
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::setPopulation(plint iPop, plint iCell, T value) {
+    plint slot = slotOf(iCell);
+    if (slot<0) {
+        return;
+    }
+    if (singlePrecision) {
+        population<float>(iPop)[slot] = (float) value;
+    }
+    else {
+        population<T>(iPop)[slot] = value;
+    }
+}
+
+/** In single precision as well, the populations are serialized in precision T. */
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::serialize(plint iCell, char* buffer) const {
+    for (plint iPop=0; iPop<Descriptor<T>::numPop; ++iPop) {
+        T value = getPopulation(iPop, iCell);
+        memcpy((void*)buffer, (const void*)(&value), sizeof(T));
+        buffer += sizeof(T);
+    }
+    plint slot = slotOf(iCell);
+    for (plint iExt=0; iExt<Descriptor<T>::ExternalField::numScalars; ++iExt) {
+        T value = slot>=0 ? external(iExt)[slot] : T();
+        memcpy((void*)buffer, (const void*)(&value), sizeof(T));
+        buffer += sizeof(T);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::unSerialize(plint iCell, char const* buffer) {
+    for (plint iPop=0; iPop<Descriptor<T>::numPop; ++iPop) {
+        T value;
+        memcpy((void*)(&value), (const void*)buffer, sizeof(T));
+        setPopulation(iPop, iCell, value);
+        buffer += sizeof(T);
+    }
+    plint slot = slotOf(iCell);
+    for (plint iExt=0; iExt<Descriptor<T>::ExternalField::numScalars; ++iExt) {
+        if (slot>=0) {
+            memcpy((void*)(external(iExt)+slot), (const void*)buffer, sizeof(T));
+        }
+        buffer += sizeof(T);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::serializePopulations (
+        plint iCell, std::vector<plint> const& pops, char* buffer ) const
+{
+    for (pluint i=0; i<pops.size(); ++i) {
+        T value = getPopulation(pops[i], iCell);
+        memcpy((void*)buffer, (const void*)(&value), sizeof(T));
+        buffer += sizeof(T);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::unSerializePopulations (
+        plint iCell, std::vector<plint> const& pops, char const* buffer )
+{
+    for (pluint i=0; i<pops.size(); ++i) {
+        T value;
+        memcpy((void*)(&value), (const void*)buffer, sizeof(T));
+        setPopulation(pops[i], iCell, value);
+        buffer += sizeof(T);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::attributeValues (
+        plint iCell, PopulationArrays3D<T,Descriptor> const& from, plint fromCell )
+{
+    for (plint iPop=0; iPop<Descriptor<T>::numPop; ++iPop) {
+        setPopulation(iPop, iCell, from.getPopulation(iPop, fromCell));
+    }
+    plint slot = slotOf(iCell);
+    plint fromSlot = from.slotOf(fromCell);
+    for (plint iExt=0; iExt<Descriptor<T>::ExternalField::numScalars; ++iExt) {
+        if (slot>=0) {
+            external(iExt)[slot] = fromSlot>=0 ? from.external(iExt)[fromSlot] : T();
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+Cell<T,Descriptor>& PopulationArrays3D<T,Descriptor>::getCellView (
+        plint iX, plint iY, plint iZ ) const
+{
+    plint iCell = cellIndex(iX,iY,iZ);
+    if (viewSlots.empty()) {
+        viewSlots.resize(numCells, -1);
+    }
+    int& slot = viewSlots[iCell];
+    if (slot<0) {
+        slot = (int)views.size();
+        // Elements of a deque are not relocated by push_back, which keeps
+        //   the references to previously created views valid.
+        views.push_back(Cell<T,Descriptor>());
+        gather(iCell, views.back());
+        viewedCells.push_back(iCell);
+    }
+    return views[slot];
+}
+
+/** The cell views hold the most recent content of the cells they refer to.
+ *  Writing them back therefore doesn't change the logical state of the
+ *  storage, which is why this method is const.
+ */
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::synchronizeCellViews() const {
+    PopulationArrays3D<T,Descriptor>& self = const_cast<PopulationArrays3D<T,Descriptor>&>(*this);
+    // The active cells are updated first, so that the cell views of cells
+    //   which become active are stored.
+    if (activeCellsOutdated) {
+        self.updateActiveCells();
+    }
+    if (viewedCells.empty()) return;
+    for (pluint iView=0; iView<viewedCells.size(); ++iView) {
+        self.scatter(viewedCells[iView], views[iView]);
+        viewSlots[viewedCells[iView]] = -1;
+    }
+    viewedCells.clear();
+    views.clear();
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::collide(Box3D domain, BlockStatistics& statistics) {
+    synchronizeCellViews();
+    Cell<T,Descriptor> cell;
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                plint iCell = cellIndex(iX,iY,iZ);
+                if (slotOf(iCell)<0) continue;
+                gather(iCell, cell);
+                cell.collide(statistics);
+                cell.revert();
+                scatter(iCell, cell);
+            }
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::bulkStream(Box3D domain) {
+    synchronizeCellViews();
+    if (sparse) sparseStream(Box3D(0,nx-1, 0,ny-1, 0,nz-1), domain);
+    else if (singlePrecision) bulkStream<float>(domain);
+    else bulkStream<T>(domain);
+}
+
+template<typename T, template<typename U> class Descriptor>
+template<typename S>
+void PopulationArrays3D<T,Descriptor>::bulkStream(Box3D domain) {
+    const plint half = Descriptor<T>::q/2;
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                plint iCell = cellIndex(iX,iY,iZ);
+                for (plint iPop=1; iPop<=half; ++iPop) {
+                    std::swap(population<S>(iPop+half)[iCell],
+                              population<S>(iPop)[iCell+neighborOffset[iPop]]);
+                }
+            }
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::boundaryStream(Box3D bound, Box3D domain) {
+    synchronizeCellViews();
+    if (sparse) sparseStream(bound, domain);
+    else if (singlePrecision) boundaryStream<float>(bound, domain);
+    else boundaryStream<T>(bound, domain);
+}
+
+template<typename T, template<typename U> class Descriptor>
+template<typename S>
+void PopulationArrays3D<T,Descriptor>::boundaryStream(Box3D bound, Box3D domain) {
+    const plint half = Descriptor<T>::q/2;
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                plint iCell = cellIndex(iX,iY,iZ);
+                for (plint iPop=1; iPop<=half; ++iPop) {
+                    plint nextX = iX + Descriptor<T>::c[iPop][0];
+                    plint nextY = iY + Descriptor<T>::c[iPop][1];
+                    plint nextZ = iZ + Descriptor<T>::c[iPop][2];
+                    if ( nextX>=bound.x0 && nextX<=bound.x1 &&
+                         nextY>=bound.y0 && nextY<=bound.y1 &&
+                         nextZ>=bound.z0 && nextZ<=bound.z1 )
+                    {
+                        std::swap(population<S>(iPop+half)[iCell],
+                                  population<S>(iPop)[iCell+neighborOffset[iPop]]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/** Counterpart of boundaryStream() in sparse mode. The swap is skipped when
+ *  the neighbor is inactive: both swapped populations are then irrelevant.
+ */
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::sparseStream(Box3D bound, Box3D domain) {
+    const plint half = Descriptor<T>::q/2;
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                plint slot = cellSlots[cellIndex(iX,iY,iZ)];
+                if (slot<0) continue;
+                int const* next = &neighborSlots[slot*half];
+                for (plint iPop=1; iPop<=half; ++iPop) {
+                    if (next[iPop-1]<0) continue;
+                    plint nextX = iX + Descriptor<T>::c[iPop][0];
+                    plint nextY = iY + Descriptor<T>::c[iPop][1];
+                    plint nextZ = iZ + Descriptor<T>::c[iPop][2];
+                    if ( nextX>=bound.x0 && nextX<=bound.x1 &&
+                         nextY>=bound.y0 && nextY<=bound.y1 &&
+                         nextZ>=bound.z0 && nextZ<=bound.z1 )
+                    {
+                        std::swap(population<T>(iPop+half)[slot],
+                                  population<T>(iPop)[next[iPop-1]]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/** This is the equivalent of latticeTemplates::swapAndStream3D() on a
+ *  cell-array lattice.
+ */
+template<typename T, template<typename U> class Descriptor>
+template<typename S>
+void PopulationArrays3D<T,Descriptor>::swapStream (
+        plint iCell, Cell<T,Descriptor> const& cell )
+{
+    const plint half = Descriptor<T>::q/2;
+    population<S>(0)[iCell] = (S) cell[0];
+    for (plint iPop=1; iPop<=half; ++iPop) {
+        S* fPlus  = population<S>(iPop);
+        S* fMinus = population<S>(iPop+half);
+        plint next = iCell+neighborOffset[iPop];
+        fPlus[iCell]  = (S) cell[iPop+half];
+        fMinus[iCell] = fPlus[next];
+        fPlus[next]   = (S) cell[iPop];
+    }
+    for (plint iExt=0; iExt<Descriptor<T>::ExternalField::numScalars; ++iExt) {
+        external(iExt)[iCell] = *cell.getExternal(iExt);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+template<typename S>
+void PopulationArrays3D<T,Descriptor>::swapStream(plint iCell)
+{
+    const plint half = Descriptor<T>::q/2;
+    for (plint iPop=1; iPop<=half; ++iPop) {
+        S* fPlus  = population<S>(iPop);
+        S* fMinus = population<S>(iPop+half);
+        plint next = iCell+neighborOffset[iPop];
+        S fTmp        = fPlus[iCell];
+        fPlus[iCell]  = fMinus[iCell];
+        fMinus[iCell] = fPlus[next];
+        fPlus[next]   = fTmp;
+    }
+}
+
+/** Counterpart of swapStream() in sparse mode. As for neighbors outside the
+ *  block, the exchange with an inactive neighbor is skipped, and only the
+ *  local swap of the populations is applied.
+ */
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::sparseSwapStream (
+        plint slot, Cell<T,Descriptor> const& cell )
+{
+    const plint half = Descriptor<T>::q/2;
+    int const* neighbors = &neighborSlots[slot*half];
+    population<T>(0)[slot] = cell[0];
+    for (plint iPop=1; iPop<=half; ++iPop) {
+        T* fPlus  = population<T>(iPop);
+        T* fMinus = population<T>(iPop+half);
+        plint next = neighbors[iPop-1];
+        fPlus[slot] = cell[iPop+half];
+        if (next>=0) {
+            fMinus[slot] = fPlus[next];
+            fPlus[next]  = cell[iPop];
+        }
+        else {
+            fMinus[slot] = cell[iPop];
+        }
+    }
+    for (plint iExt=0; iExt<Descriptor<T>::ExternalField::numScalars; ++iExt) {
+        external(iExt)[slot] = *cell.getExternal(iExt);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::sparseSwapStream(plint slot)
+{
+    const plint half = Descriptor<T>::q/2;
+    int const* neighbors = &neighborSlots[slot*half];
+    for (plint iPop=1; iPop<=half; ++iPop) {
+        T* fPlus  = population<T>(iPop);
+        T* fMinus = population<T>(iPop+half);
+        plint next = neighbors[iPop-1];
+        T fTmp        = fPlus[slot];
+        fPlus[slot]   = fMinus[slot];
+        if (next>=0) {
+            fMinus[slot] = fPlus[next];
+            fPlus[next]  = fTmp;
+        }
+        else {
+            fMinus[slot] = fTmp;
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool PopulationArrays3D<T,Descriptor>::collideRun (
+        T* f[Descriptor<T>::numPop], plint iCell, plint runLength,
+        std::vector<Cell<T,Descriptor> >& cells, BlockStatistics& statistics )
+{
+    Dynamics<T,Descriptor>& dynamics = *dynamicsTable[dynamicsIds[iCell]];
+    if (dynamics.collidePopulationArrays(f, &statisticsFlags[iCell], runLength, statistics)) {
+        return true;
+    }
+    if ((plint)cells.size() < runLength) {
+        cells.resize(runLength);
+    }
+    for (plint iRun=0; iRun<runLength; ++iRun) {
+        gather(iCell+iRun, cells[iRun]);
+    }
+    dynamics.collideSequence(&cells[0], runLength, statistics);
+    return false;
+}
+
+/** Same algorithm as BlockLattice3D::bulkCollideAndStreamRow(), with the
+ *  collision of each run of cells executed by collideRun().
+ */
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::collideAndStreamRow (
+        plint iX, plint iY, plint z0, plint z1,
+        std::vector<Cell<T,Descriptor> >& cells, std::vector<T>& runBuffer,
+        BlockStatistics& statistics )
+{
+    if (z1 < z0) return;
+    const plint numPop = Descriptor<T>::numPop;
+    plint rowStart = cellIndex(iX,iY,z0);
+    plint rowLength = z1-z0+1;
+    plint iCell = 0;
+    if (sparse) {
+        // The active cells of a run have consecutive slots, because the
+        //   slots are attributed in the natural order of the cells.
+        while (iCell < rowLength) {
+            plint runStart = rowStart+iCell;
+            plint slot = cellSlots[runStart];
+            if (slot<0) {
+                ++iCell;
+                continue;
+            }
+            int dynamicsId = dynamicsIds[runStart];
+            plint runLength = 1;
+            while ( iCell+runLength < rowLength &&
+                    dynamicsIds[runStart+runLength]==dynamicsId &&
+                    cellSlots[runStart+runLength]>=0 )
+            {
+                ++runLength;
+            }
+            T* f[Descriptor<T>::numPop];
+            for (plint iPop=0; iPop<numPop; ++iPop) {
+                f[iPop] = population<T>(iPop)+slot;
+            }
+            if (collideRun(f, runStart, runLength, cells, statistics)) {
+                for (plint iRun=0; iRun<runLength; ++iRun) {
+                    sparseSwapStream(slot+iRun);
+                }
+            }
+            else {
+                for (plint iRun=0; iRun<runLength; ++iRun) {
+                    sparseSwapStream(slot+iRun, cells[iRun]);
+                }
+            }
+            iCell += runLength;
+        }
+        return;
+    }
+    while (iCell < rowLength) {
+        int dynamicsId = dynamicsIds[rowStart+iCell];
+        plint runLength = 1;
+        while (iCell+runLength < rowLength && dynamicsIds[rowStart+iCell+runLength]==dynamicsId) {
+            ++runLength;
+        }
+        plint runStart = rowStart+iCell;
+        T* f[Descriptor<T>::numPop];
+        if (singlePrecision) {
+            // The run is collided on a copy in precision T, which is converted
+            //   back before the streaming step.
+            if ((plint)runBuffer.size() < numPop*runLength) {
+                runBuffer.resize(numPop*runLength);
+            }
+            for (plint iPop=0; iPop<numPop; ++iPop) {
+                float const* from = population<float>(iPop)+runStart;
+                f[iPop] = &runBuffer[iPop*runLength];
+                std::copy(from, from+runLength, f[iPop]);
+            }
+            if (collideRun(f, runStart, runLength, cells, statistics)) {
+                for (plint iPop=0; iPop<numPop; ++iPop) {
+                    std::copy(f[iPop], f[iPop]+runLength, population<float>(iPop)+runStart);
+                }
+                for (plint iRun=0; iRun<runLength; ++iRun) {
+                    swapStream<float>(runStart+iRun);
+                }
+            }
+            else {
+                for (plint iRun=0; iRun<runLength; ++iRun) {
+                    swapStream<float>(runStart+iRun, cells[iRun]);
+                }
+            }
+        }
+        else {
+            for (plint iPop=0; iPop<numPop; ++iPop) {
+                f[iPop] = population<T>(iPop)+runStart;
+            }
+            if (collideRun(f, runStart, runLength, cells, statistics)) {
+                for (plint iRun=0; iRun<runLength; ++iRun) {
+                    swapStream<T>(runStart+iRun);
+                }
+            }
+            else {
+                for (plint iRun=0; iRun<runLength; ++iRun) {
+                    swapStream<T>(runStart+iRun, cells[iRun]);
+                }
+            }
+        }
+        iCell += runLength;
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::linearBulkCollideAndStream (
+        Box3D domain, BlockStatistics& statistics )
+{
+    synchronizeCellViews();
+    std::vector<Cell<T,Descriptor> > cells;
+    std::vector<T> runBuffer;
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            collideAndStreamRow(iX, iY, domain.z0, domain.z1, cells, runBuffer, statistics);
+        }
+    }
+}
+
+/** Same traversal order as in BlockLattice3D::blockwiseBulkCollideAndStream().
+ */
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::blockwiseBulkCollideAndStream (
+        Box3D domain, Dot3D tileShape, BlockStatistics& statistics )
+{
+    synchronizeCellViews();
+    std::vector<Cell<T,Descriptor> > cells;
+    std::vector<T> runBuffer;
+    indexTemplates::SwapStreamingSkew3D<Descriptor<T> > const& skew =
+        indexTemplates::swapStreamingSkew3D<Descriptor<T> >();
+    const plint xShiftY = skew.getXshiftY();
+    const plint xShiftZ = skew.getXshiftZ();
+    const plint yShiftZ = skew.getYshiftZ();
+    const plint ny = domain.getNy();
+    const plint nz = domain.getNz();
+    for (plint outerX=0; outerX<domain.getNx(); outerX+=tileShape.x) {
+        plint endX = std::min(outerX+tileShape.x, domain.getNx())-1;
+        for (plint outerV=xShiftY*outerX; outerV<=ny-1+xShiftY*endX; outerV+=tileShape.y) {
+            plint endV = outerV+tileShape.y-1;
+            plint minY = std::max((plint)0, outerV-xShiftY*endX);
+            plint maxY = std::min(ny-1, endV-xShiftY*outerX);
+            for (plint outerW=xShiftZ*outerX+yShiftZ*minY; outerW<=nz-1+xShiftZ*endX+yShiftZ*maxY; outerW+=tileShape.z) {
+                plint endW = outerW+tileShape.z-1;
+                for (plint dx=outerX; dx<=endX; ++dx) {
+                    plint startY = std::max((plint)0, outerV-xShiftY*dx);
+                    plint endY = std::min(ny-1, endV-xShiftY*dx);
+                    for (plint dy=startY; dy<=endY; ++dy) {
+                        plint startZ = std::max((plint)0, outerW-xShiftZ*dx-yShiftZ*dy);
+                        plint endZ = std::min(nz-1, endW-xShiftZ*dx-yShiftZ*dy);
+                        collideAndStreamRow ( domain.x0+dx, domain.y0+dy,
+                                              domain.z0+startZ, domain.z0+endZ,
+                                              cells, runBuffer, statistics );
+                    }
+                }
+            }
+        }
+    }
+}
+
+/** Each row of cells along z is copied into a buffer, collided in the
+ *  buffer and streamed from the buffer into the spare arrays. The current
+ *  arrays are only read, and the spare arrays are only written.
+ */
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::twoLatticeCollideAndStream (
+        Box3D domain, BlockStatistics& statistics )
+{
+    PLB_PRECONDITION( twoLattices );
+    PLB_PRECONDITION( domain.x0>=0 && domain.x1<nx && domain.y0>=0 && domain.y1<ny &&
+                      domain.z0>=0 && domain.z1<nz );
+    synchronizeCellViews();
+    if (singlePrecision) twoLatticeCollideAndStream<float>(domain, statistics);
+    else twoLatticeCollideAndStream<T>(domain, statistics);
+    std::swap(populations, sparePopulations);
+}
+
+/** In single precision, the conversion to and from precision T takes place
+ *  when the rows are copied into and out of the buffer.
+ */
+template<typename T, template<typename U> class Descriptor>
+template<typename S>
+void PopulationArrays3D<T,Descriptor>::twoLatticeCollideAndStream (
+        Box3D domain, BlockStatistics& statistics )
+{
+    const plint numPop = Descriptor<T>::numPop;
+    plint rowLength = domain.getNz();
+    std::vector<T> rowBuffer(numPop*rowLength);
+    std::vector<Cell<T,Descriptor> > cells;
+
+    for (plint iX=0; iX<nx; ++iX) {
+        for (plint iY=0; iY<ny; ++iY) {
+            plint rowStart = cellIndex(iX,iY,0);
+            bool rowInDomain = iX>=domain.x0 && iX<=domain.x1 && iY>=domain.y0 && iY<=domain.y1;
+            // Cells outside the domain keep their populations.
+            for (plint iPop=0; iPop<numPop; ++iPop) {
+                S const* from = population<S>(iPop)+rowStart;
+                S* to = sparePopulation<S>(iPop)+rowStart;
+                if (rowInDomain) {
+                    std::copy(from, from+domain.z0, to);
+                    std::copy(from+domain.z1+1, from+nz, to+domain.z1+1);
+                }
+                else {
+                    std::copy(from, from+nz, to);
+                }
+            }
+            if (!rowInDomain) continue;
+
+            plint domainStart = rowStart+domain.z0;
+            T* f[Descriptor<T>::numPop];
+            for (plint iPop=0; iPop<numPop; ++iPop) {
+                S const* from = population<S>(iPop)+domainStart;
+                std::copy(from, from+rowLength, &rowBuffer[iPop*rowLength]);
+            }
+            plint iCell = 0;
+            while (iCell < rowLength) {
+                int dynamicsId = dynamicsIds[domainStart+iCell];
+                plint runLength = 1;
+                while (iCell+runLength < rowLength && dynamicsIds[domainStart+iCell+runLength]==dynamicsId) {
+                    ++runLength;
+                }
+                for (plint iPop=0; iPop<numPop; ++iPop) {
+                    f[iPop] = &rowBuffer[iPop*rowLength+iCell];
+                }
+                if (!collideRun(f, domainStart+iCell, runLength, cells, statistics)) {
+                    for (plint iRun=0; iRun<runLength; ++iRun) {
+                        for (plint iPop=0; iPop<numPop; ++iPop) {
+                            f[iPop][iRun] = cells[iRun][iPop];
+                        }
+                        for (plint iExt=0; iExt<Descriptor<T>::ExternalField::numScalars; ++iExt) {
+                            external(iExt)[domainStart+iCell+iRun] = *cells[iRun].getExternal(iExt);
+                        }
+                    }
+                }
+                iCell += runLength;
+            }
+            pushRow<S>(iX, iY, domain, &rowBuffer[0]);
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+template<typename S>
+void PopulationArrays3D<T,Descriptor>::pushRow (
+        plint iX, plint iY, Box3D const& domain, T const* rowBuffer )
+{
+    plint rowLength = domain.getNz();
+    plint domainStart = cellIndex(iX,iY,domain.z0);
+    for (plint iPop=0; iPop<Descriptor<T>::numPop; ++iPop) {
+        T const* post = rowBuffer+iPop*rowLength;
+        plint nextX = iX + Descriptor<T>::c[iPop][0];
+        plint nextY = iY + Descriptor<T>::c[iPop][1];
+        plint cz = Descriptor<T>::c[iPop][2];
+        // Range of cells which stream into the domain; the others bounce back.
+        plint first = 0, last = -1;
+        if ( nextX>=domain.x0 && nextX<=domain.x1 &&
+             nextY>=domain.y0 && nextY<=domain.y1 )
+        {
+            first = std::max((plint)0, -cz);
+            last  = std::min(rowLength-1, rowLength-1-cz);
+        }
+        S* bounced = sparePopulation<S>(indexTemplates::opposite<Descriptor<T> >(iPop))+domainStart;
+        if (first<=last) {
+            S* to = sparePopulation<S>(iPop)+domainStart+neighborOffset[iPop];
+            std::copy(post+first, post+last+1, to+first);
+            std::copy(post, post+first, bounced);
+            std::copy(post+last+1, post+rowLength, bounced+last+1);
+        }
+        else {
+            std::copy(post, post+rowLength, bounced);
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void PopulationArrays3D<T,Descriptor>::periodicDomain(Box3D domain) {
+    synchronizeCellViews();
+    if (singlePrecision) periodicDomain<float>(domain);
+    else periodicDomain<T>(domain);
+}
+
+template<typename T, template<typename U> class Descriptor>
+template<typename S>
+void PopulationArrays3D<T,Descriptor>::periodicDomain(Box3D domain) {
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                for (plint iPop=1; iPop<Descriptor<T>::q; ++iPop) {
+                    plint prevX = iX - Descriptor<T>::c[iPop][0];
+                    plint prevY = iY - Descriptor<T>::c[iPop][1];
+                    plint prevZ = iZ - Descriptor<T>::c[iPop][2];
+
+                    if ( (prevX>=0 && prevX<nx) &&
+                         (prevY>=0 && prevY<ny) &&
+                         (prevZ>=0 && prevZ<nz) )
+                    {
+                        plint nextX = (iX+nx)%nx;
+                        plint nextY = (iY+ny)%ny;
+                        plint nextZ = (iZ+nz)%nz;
+                        plint prevSlot = slotOf(cellIndex(prevX,prevY,prevZ));
+                        plint nextSlot = slotOf(cellIndex(nextX,nextY,nextZ));
+                        if (prevSlot>=0 && nextSlot>=0) {
+                            std::swap (
+                                population<S>(indexTemplates::opposite<Descriptor<T> >(iPop))[prevSlot],
+                                population<S>(iPop)[nextSlot] );
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+}  // namespace plb
+
+#endif  // POPULATION_ARRAYS_3D_HH
@@ -32,6 +32,7 @@
 #include "atomicBlock/blockLattice3D.h"
 #include "multiGrid/multiGridUtil.h"
 #include "core/plbProfiler.h"
+#include "core/runTimeDiagnostics.h"
 
 namespace plb {
 
@@ -62,6 +63,8 @@ void ExternalRhoJcollideAndStream3D<T,Descriptor>::bulkCollideAndStream (
         ScalarField3D<T> const& rhoBarField, Dot3D const& offset1,
         TensorField3D<T,3> const& jField, Dot3D const& offset2, BlockStatistics& stat )
 {
+    // This processor accesses the cell array of the lattice directly.
+    PLB_PRECONDITION( lattice.getStorage()==LatticeStorage::cellArray );
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
@@ -83,6 +86,7 @@ void ExternalRhoJcollideAndStream3D<T,Descriptor>::boundaryStream (
 {
     // Make sure domain is contained within bound
     PLB_PRECONDITION( contained(domain, bound) );
+    PLB_PRECONDITION( lattice.getStorage()==LatticeStorage::cellArray );
 
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
@@ -107,9 +111,12 @@ template<typename T, template<typename U> class Descriptor>
 void ExternalRhoJcollideAndStream3D<T,Descriptor>::processGenericBlocks (
         Box3D domain, std::vector<AtomicBlock3D*> atomicBlocks )
 {
-    global::timer("collideAndStream").start();
     BlockLattice3D<T,Descriptor>& lattice =
         dynamic_cast<BlockLattice3D<T,Descriptor>&>(*atomicBlocks[0]);
+    if (lattice.getStorage() != LatticeStorage::cellArray) {
+        throw PlbLogicException("ExternalRhoJcollideAndStream3D requires a lattice with cell-array storage.");
+    }
+    global::timer("collideAndStream").start();
     ScalarField3D<T> const& rhoBarField =
         dynamic_cast<ScalarField3D<T> const&>(*atomicBlocks[1]);
     TensorField3D<T,3> const& jField =
@@ -239,6 +246,8 @@ void PackedExternalRhoJcollideAndStream3D<T,Descriptor>::bulkCollideAndStream (
         BlockLattice3D<T,Descriptor>& lattice, Box3D const& domain,
         NTensorField3D<T> const& rhoBarJfield, Dot3D const& offset, BlockStatistics& stat )
 {
+    // This processor accesses the cell array of the lattice directly.
+    PLB_PRECONDITION( lattice.getStorage()==LatticeStorage::cellArray );
     Array<T,3> j;
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
@@ -263,6 +272,7 @@ void PackedExternalRhoJcollideAndStream3D<T,Descriptor>::boundaryStream (
 {
     // Make sure domain is contained within bound
     PLB_PRECONDITION( contained(domain, bound) );
+    PLB_PRECONDITION( lattice.getStorage()==LatticeStorage::cellArray );
 
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
@@ -288,6 +298,9 @@ void PackedExternalRhoJcollideAndStream3D<T,Descriptor>::process (
         Box3D domain, BlockLattice3D<T,Descriptor>& lattice,
                       NTensorField3D<T>& rhoBarJfield )
 {
+    if (lattice.getStorage() != LatticeStorage::cellArray) {
+        throw PlbLogicException("PackedExternalRhoJcollideAndStream3D requires a lattice with cell-array storage.");
+    }
     global::timer("collideAndStream").start();
 
     PLB_ASSERT( rhoBarJfield.getNdim()==4 );
@@ -437,6 +450,8 @@ void OnLinkExternalRhoJcollideAndStream3D<T,Descriptor>::bulkCollideAndStream (
         ScalarField3D<T> const& rhoBarField, Dot3D const& offset1,
         TensorField3D<T,3> const& jField, Dot3D const& offset2, BlockStatistics& stat )
 {
+    // This processor accesses the cell array of the lattice directly.
+    PLB_PRECONDITION( lattice.getStorage()==LatticeStorage::cellArray );
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
@@ -457,6 +472,7 @@ void OnLinkExternalRhoJcollideAndStream3D<T,Descriptor>::boundaryStream (
 {
     // Make sure domain is contained within bound
     PLB_PRECONDITION( contained(domain, bound) );
+    PLB_PRECONDITION( lattice.getStorage()==LatticeStorage::cellArray );
 
     int bbId = BounceBack<T,Descriptor>().getId();
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
@@ -486,9 +502,12 @@ template<typename T, template<typename U> class Descriptor>
 void OnLinkExternalRhoJcollideAndStream3D<T,Descriptor>::processGenericBlocks (
         Box3D domain, std::vector<AtomicBlock3D*> atomicBlocks )
 {
-    global::timer("collideAndStream").start();
     BlockLattice3D<T,Descriptor>& lattice =
         dynamic_cast<BlockLattice3D<T,Descriptor>&>(*atomicBlocks[0]);
+    if (lattice.getStorage() != LatticeStorage::cellArray) {
+        throw PlbLogicException("OnLinkExternalRhoJcollideAndStream3D requires a lattice with cell-array storage.");
+    }
+    global::timer("collideAndStream").start();
     ScalarField3D<T> const& rhoBarField =
         dynamic_cast<ScalarField3D<T> const&>(*atomicBlocks[1]);
     TensorField3D<T,3> const& jField =
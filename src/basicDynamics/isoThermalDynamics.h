@@ -131,6 +131,14 @@ public:
     virtual void collide(Cell<T,Descriptor>& cell,
                          BlockStatistics& statistics_);
 
+    /// Collision step on a sequence of cells, without virtual call per cell
+    virtual void collideSequence(Cell<T,Descriptor>* cells, plint numCells,
+                                 BlockStatistics& statistics_);
+
+    /// Vectorized collision step on a structure-of-arrays storage
+    virtual bool collidePopulationArrays(T* const* f, char const* takesStatistics,
+                                         plint numCells, BlockStatistics& statistics_);
+
     /// Implementation of the collision step, with imposed macroscopic variables
     virtual void collideExternal(Cell<T,Descriptor>& cell, T rhoBar,
                          Array<T,Descriptor<T>::d> const& j, T thetaBar, BlockStatistics& stat);
@@ -580,6 +588,10 @@ public:
     virtual void collide(Cell<T,Descriptor>& cell,
                          BlockStatistics& statistics_);
 
+    /// Vectorized collision step on a structure-of-arrays storage
+    virtual bool collidePopulationArrays(T* const* f, char const* takesStatistics,
+                                         plint numCells, BlockStatistics& statistics_);
+
     /// Implementation of the collision step, with imposed macroscopic variables
     virtual void collideExternal(Cell<T,Descriptor>& cell, T rhoBar,
                          Array<T,Descriptor<T>::d> const& j, T thetaBar, BlockStatistics& stat);
@@ -34,6 +34,7 @@
 #include "core/dynamicsIdentifiers.h"
 #include "latticeBoltzmann/dynamicsTemplates.h"
 #include "latticeBoltzmann/momentTemplates.h"
+#include "latticeBoltzmann/simdDynamicsTemplates.h"
 #include "latticeBoltzmann/externalForceTemplates.h"
 #include "latticeBoltzmann/offEquilibriumTemplates.h"
 #include "latticeBoltzmann/d3q13Templates.h"
@@ -41,6 +42,7 @@
 #include "core/latticeStatistics.h"
 #include <algorithm>
 #include <limits>
+#include <typeinfo>
 
 namespace plb {
 
@@ -329,6 +331,26 @@ void BGKdynamics<T,Descriptor>::collide (
     }
 }
 
+template<typename T, template<typename U> class Descriptor>
+void BGKdynamics<T,Descriptor>::collideSequence (
+        Cell<T,Descriptor>* cells, plint numCells, BlockStatistics& statistics )
+{
+    staticCollideSequence(*this, cells, numCells, statistics);
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool BGKdynamics<T,Descriptor>::collidePopulationArrays (
+        T* const* f, char const* takesStatistics, plint numCells, BlockStatistics& statistics )
+{
+    // Derived classes may have a different collision step.
+    if (typeid(*this)!=typeid(BGKdynamics<T,Descriptor>)) {
+        return false;
+    }
+    simdDynamicsTemplates<T,Descriptor>::bgk_ma2_collision (
+            f, takesStatistics, numCells, this->getOmega(), statistics );
+    return true;
+}
+
 template<typename T, template<typename U> class Descriptor>
 void BGKdynamics<T,Descriptor>::collideExternal (
         Cell<T,Descriptor>& cell, T rhoBar,
@@ -1418,6 +1440,19 @@ void IncBGKdynamics<T,Descriptor>::collide (
     }
 }
 
+template<typename T, template<typename U> class Descriptor>
+bool IncBGKdynamics<T,Descriptor>::collidePopulationArrays (
+        T* const* f, char const* takesStatistics, plint numCells, BlockStatistics& statistics )
+{
+    // Derived classes may have a different collision step.
+    if (typeid(*this)!=typeid(IncBGKdynamics<T,Descriptor>)) {
+        return false;
+    }
+    simdDynamicsTemplates<T,Descriptor>::bgk_inc_collision (
+            f, takesStatistics, numCells, this->getOmega(), invRho0, statistics );
+    return true;
+}
+
 template<typename T, template<typename U> class Descriptor>
 void IncBGKdynamics<T,Descriptor>::collideExternal (
         Cell<T,Descriptor>& cell, T rhoBar,
@@ -80,6 +80,10 @@ public:
     /// Implementation of the collision step
     virtual void collide(Cell<T,Descriptor>& cell,
                          BlockStatistics& statistics_);
+
+    /// Collision step on a sequence of cells, without virtual call per cell
+    virtual void collideSequence(Cell<T,Descriptor>* cells, plint numCells,
+                                 BlockStatistics& statistics_);
     
     /// Implementation of the collision step, with imposed macroscopic variables
     virtual void collideExternal(Cell<T,Descriptor>& cell, T rhoBar,
@@ -77,6 +77,13 @@ void MRTdynamics<T,Descriptor>::collide (
     }
 }
 
+template<typename T, template<typename U> class Descriptor>
+void MRTdynamics<T,Descriptor>::collideSequence (
+        Cell<T,Descriptor>* cells, plint numCells, BlockStatistics& statistics )
+{
+    staticCollideSequence(*this, cells, numCells, statistics);
+}
+
 template<typename T, template<typename U> class Descriptor>
 void MRTdynamics<T,Descriptor>::collideExternal (
         Cell<T,Descriptor>& cell, T rhoBar, Array<T,Descriptor<T>::d> const& j,
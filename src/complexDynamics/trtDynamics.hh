@@ -28,9 +28,11 @@
 #include "complexDynamics/trtDynamics.h"
 #include "latticeBoltzmann/dynamicsTemplates.h"
 #include "latticeBoltzmann/momentTemplates.h"
+#include "latticeBoltzmann/simdDynamicsTemplates.h"
 #include "core/latticeStatistics.h"
 #include <algorithm>
 #include <limits>
+#include <typeinfo>
 
 namespace plb {
 
@@ -98,6 +100,26 @@ void TRTdynamics<T,Descriptor>::collide (
     }
 }
 
+template<typename T, template<typename U> class Descriptor>
+void TRTdynamics<T,Descriptor>::collideSequence (
+        Cell<T,Descriptor>* cells, plint numCells, BlockStatistics& statistics )
+{
+    staticCollideSequence(*this, cells, numCells, statistics);
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool TRTdynamics<T,Descriptor>::collidePopulationArrays (
+        T* const* f, char const* takesStatistics, plint numCells, BlockStatistics& statistics )
+{
+    // Derived classes may have a different collision step.
+    if (typeid(*this)!=typeid(TRTdynamics<T,Descriptor>)) {
+        return false;
+    }
+    simdDynamicsTemplates<T,Descriptor>::trt_ma2_collision (
+            f, takesStatistics, numCells, this->getOmega(), sMinus, statistics );
+    return true;
+}
+
 template<typename T, template<typename U> class Descriptor>
 void TRTdynamics<T,Descriptor>::collideExternal (
         Cell<T,Descriptor>& cell, T rhoBar, Array<T,Descriptor<T>::d> const& j,
@@ -37,4 +37,59 @@ void copySerializedBlock(Block2D const& from, Block2D& to, IndexOrdering::Orderi
                               to.getBlockUnSerializer(to.getBoundingBox(), ordering) );
 }
 
+CachePolicy2D::CachePolicy2D(plint blockSize_, bool autoTune_, std::string name)
+    : tileShape(blockSize_, blockSize_),
+      autoTune(autoTune_),
+      tuner(name, tuningCandidates(tileShape))
+{ }
+
+void CachePolicy2D::setBlockSize(plint blockSize_) {
+    setTileShape(Dot2D(blockSize_, blockSize_));
+}
+
+void CachePolicy2D::setTileShape(Dot2D tileShape_) {
+    tileShape = tileShape_;
+    autoTune = false;
+}
+
+void CachePolicy2D::setAutoTune(bool autoTune_) {
+    autoTune = autoTune_;
+    if (autoTune) {
+        tuner.reset();
+    }
+}
+
+Dot2D CachePolicy2D::startSweep(plint numCells) {
+    if (!autoTune) {
+        return tileShape;
+    }
+    CachePolicyTuner::Shape shape = tuner.startSweep(numCells);
+    return Dot2D(shape[0], shape[1]);
+}
+
+void CachePolicy2D::stopSweep(plint numCells) {
+    if (autoTune) {
+        tuner.stopSweep(numCells);
+    }
+}
+
+/// The default shape comes first: it is used by the other threads while
+///   thread 0 takes the time measurements.
+std::vector<CachePolicyTuner::Shape> CachePolicy2D::tuningCandidates(Dot2D defaultShape) {
+    plint extents[][2] = {
+        {defaultShape.x, defaultShape.y},
+        {0, 0},
+        {16, 16}, {32, 32}, {64, 64}, {128, 128}, {256, 256},
+        {16, 256}, {32, 1024}, {8, 4096}
+    };
+    std::vector<CachePolicyTuner::Shape> candidates;
+    for (pluint i=0; i<sizeof(extents)/sizeof(extents[0]); ++i) {
+        CachePolicyTuner::Shape shape(extents[i], extents[i]+2);
+        if (std::find(candidates.begin(), candidates.end(), shape) == candidates.end()) {
+            candidates.push_back(shape);
+        }
+    }
+    return candidates;
+}
+
 }  // namespace plb
@@ -31,6 +31,8 @@
 #include "core/serializer.h"
 #include "core/blockStatistics.h"
 #include "core/geometry2D.h"
+#include "core/cachePolicyTuner.h"
+#include <string>
 
 namespace plb {
 
@@ -49,18 +51,48 @@ void copySerializedBlock( Block2D const& from, Block2D& to,
 
 /// Some end-user implementations of the Block2D have a static cache-policy class,
 ///   which can be access to fine-tune the performance on a given platform.
+/** The tile shape of the block-wise algorithm is either fixed, or it is
+ *  auto-tuned with a CachePolicyTuner: candidate tile shapes, cubic and
+ *  elongated ones, are timed on the target machine, separately for each size
+ *  of the domain. The selections can be stored in a file (see
+ *  CachePolicyTuner::setFileName()). The components of a tile shape are the
+ *  extents of the tiles along x and along y+a*x, where a is the skew factor
+ *  of the traversal. A tile shape of 0 stands for a traversal without
+ *  blocking.
+ */
 class CachePolicy2D {
 public:
-    CachePolicy2D(plint blockSize_) : blockSize(blockSize_)
-    { }
-    void setBlockSize(plint blockSize_) {
-        blockSize = blockSize_;
-    }
+    /// The name identifies the policy in the file of the CachePolicyTuner.
+    CachePolicy2D(plint blockSize_, bool autoTune_=false, std::string name="CachePolicy2D");
+    /// Use fixed, square tiles. This switches off the auto-tuning.
+    void setBlockSize(plint blockSize_);
+    /// Extent along x of the fixed (or default) tile shape.
     plint getBlockSize() const {
-        return blockSize;
+        return tileShape.x;
+    }
+    /// Use a fixed tile shape. This switches off the auto-tuning.
+    void setTileShape(Dot2D tileShape_);
+    /// The fixed tile shape, or the default one during auto-tuning.
+    Dot2D getTileShape() const {
+        return tileShape;
     }
+    /// Switch the auto-tuning on (previous selections are forgotten, but the
+    ///   ones stored in the file are used) or off.
+    void setAutoTune(bool autoTune_);
+    bool isAutoTuned() const {
+        return autoTune;
+    }
+    /// Tile shape to be used for the next sweep over a domain of numCells cells.
+    ///   During auto-tuning, the sweep is timed until stopSweep() is called.
+    Dot2D startSweep(plint numCells);
+    /// End of a sweep over numCells cells which was started with startSweep().
+    void stopSweep(plint numCells);
+private:
+    static std::vector<CachePolicyTuner::Shape> tuningCandidates(Dot2D defaultShape);
 private:
-    plint blockSize;
+    Dot2D tileShape;
+    bool autoTune;
+    CachePolicyTuner tuner;
 };
 
 } // namespace plb
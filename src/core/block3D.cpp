@@ -37,4 +37,60 @@ void copySerializedBlock(Block3D const& from, Block3D& to, IndexOrdering::Orderi
                               to.getBlockUnSerializer(to.getBoundingBox(), ordering) );
 }
 
+
+CachePolicy3D::CachePolicy3D(plint blockSize_, bool autoTune_, std::string name)
+    : tileShape(blockSize_, blockSize_, blockSize_),
+      autoTune(autoTune_),
+      tuner(name, tuningCandidates(tileShape))
+{ }
+
+void CachePolicy3D::setBlockSize(plint blockSize_) {
+    setTileShape(Dot3D(blockSize_, blockSize_, blockSize_));
+}
+
+void CachePolicy3D::setTileShape(Dot3D tileShape_) {
+    tileShape = tileShape_;
+    autoTune = false;
+}
+
+void CachePolicy3D::setAutoTune(bool autoTune_) {
+    autoTune = autoTune_;
+    if (autoTune) {
+        tuner.reset();
+    }
+}
+
+Dot3D CachePolicy3D::startSweep(plint numCells) {
+    if (!autoTune) {
+        return tileShape;
+    }
+    CachePolicyTuner::Shape shape = tuner.startSweep(numCells);
+    return Dot3D(shape[0], shape[1], shape[2]);
+}
+
+void CachePolicy3D::stopSweep(plint numCells) {
+    if (autoTune) {
+        tuner.stopSweep(numCells);
+    }
+}
+
+/// The default shape comes first: it is used by the other threads while
+///   thread 0 takes the time measurements.
+std::vector<CachePolicyTuner::Shape> CachePolicy3D::tuningCandidates(Dot3D defaultShape) {
+    plint extents[][3] = {
+        {defaultShape.x, defaultShape.y, defaultShape.z},
+        {0, 0, 0},
+        {8, 8, 8}, {16, 16, 16}, {32, 32, 32}, {64, 64, 64},
+        {4, 16, 64}, {8, 16, 128}, {16, 32, 64}, {8, 32, 1024}, {2, 8, 1024}
+    };
+    std::vector<CachePolicyTuner::Shape> candidates;
+    for (pluint i=0; i<sizeof(extents)/sizeof(extents[0]); ++i) {
+        CachePolicyTuner::Shape shape(extents[i], extents[i]+3);
+        if (std::find(candidates.begin(), candidates.end(), shape) == candidates.end()) {
+            candidates.push_back(shape);
+        }
+    }
+    return candidates;
+}
+
 }  // namespace plb
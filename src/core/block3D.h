@@ -31,6 +31,8 @@
 #include "core/serializer.h"
 #include "core/blockStatistics.h"
 #include "core/geometry3D.h"
+#include "core/cachePolicyTuner.h"
+#include <string>
 
 namespace plb {
 
@@ -49,18 +51,48 @@ void copySerializedBlock( Block3D const& from, Block3D& to,
 
 /// Some end-user implementations of the Block3D have a static cache-policy class,
 ///   which can be access to fine-tune the performance on a given platform.
+/** The tile shape of the block-wise algorithm is either fixed, or it is
+ *  auto-tuned with a CachePolicyTuner: candidate tile shapes, cubic and
+ *  elongated ones, are timed on the target machine, separately for each size
+ *  of the domain. The selections can be stored in a file (see
+ *  CachePolicyTuner::setFileName()). The components of a tile shape are the
+ *  extents of the tiles along x, along y+a*x and along z+b*x+c*y, where a, b
+ *  and c are the skew factors of the traversal. A tile shape of 0 stands for
+ *  a traversal without blocking.
+ */
 class CachePolicy3D {
 public:
-    CachePolicy3D(plint blockSize_) : blockSize(blockSize_)
-    { }
-    void setBlockSize(plint blockSize_) {
-        blockSize = blockSize_;
-    }
+    /// The name identifies the policy in the file of the CachePolicyTuner.
+    CachePolicy3D(plint blockSize_, bool autoTune_=false, std::string name="CachePolicy3D");
+    /// Use fixed, cubic tiles. This switches off the auto-tuning.
+    void setBlockSize(plint blockSize_);
+    /// Extent along x of the fixed (or default) tile shape.
     plint getBlockSize() const {
-        return blockSize;
+        return tileShape.x;
+    }
+    /// Use a fixed tile shape. This switches off the auto-tuning.
+    void setTileShape(Dot3D tileShape_);
+    /// The fixed tile shape, or the default one during auto-tuning.
+    Dot3D getTileShape() const {
+        return tileShape;
     }
+    /// Switch the auto-tuning on (previous selections are forgotten, but the
+    ///   ones stored in the file are used) or off.
+    void setAutoTune(bool autoTune_);
+    bool isAutoTuned() const {
+        return autoTune;
+    }
+    /// Tile shape to be used for the next sweep over a domain of numCells cells.
+    ///   During auto-tuning, the sweep is timed until stopSweep() is called.
+    Dot3D startSweep(plint numCells);
+    /// End of a sweep over numCells cells which was started with startSweep().
+    void stopSweep(plint numCells);
+private:
+    static std::vector<CachePolicyTuner::Shape> tuningCandidates(Dot3D defaultShape);
 private:
-    plint blockSize;
+    Dot3D tileShape;
+    bool autoTune;
+    CachePolicyTuner tuner;
 };
 
 } // namespace plb
@@ -149,6 +149,21 @@ void BlockStatistics::evaluate (
     tmpNumCells = 0;
 }
 
+void BlockStatistics::setPublicStatistics (
+        std::vector<double> const& average, std::vector<double> const& sum,
+        std::vector<double> const& max, std::vector<plint> const& intSum )
+{
+    PLB_PRECONDITION ( averageVect.size() == average.size() );
+    PLB_PRECONDITION ( sumVect.size()     == sum.size() );
+    PLB_PRECONDITION ( maxVect.size()     == max.size() );
+    PLB_PRECONDITION ( intSumVect.size()  == intSum.size() );
+
+    averageVect = average;
+    sumVect     = sum;
+    maxVect     = max;
+    intSumVect  = intSum;
+}
+
 /** \return Identifier for this observable, to be used for gatherAverage() and getAverage().
  */
 plint BlockStatistics::subscribeAverage() {
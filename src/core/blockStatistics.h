@@ -85,6 +85,9 @@ public:
     /// Attribute a value to the public statistics, and reset running statistics to default.
     void evaluate(std::vector<double> const& average, std::vector<double> const& sum,
                   std::vector<double> const& max, std::vector<plint> const& intSum, pluint numCells_);
+    /// Attribute a value to the public statistics, and leave running statistics unchanged.
+    void setPublicStatistics(std::vector<double> const& average, std::vector<double> const& sum,
+                             std::vector<double> const& max, std::vector<plint> const& intSum);
     /// Contribute the values of the current cell to the statistics of an "average observable"
     void gatherAverage(plint whichAverage, double value);
     /// Contribute the values of the current cell to the statistics of a "sum observable"
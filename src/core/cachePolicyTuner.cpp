@@ -0,0 +1,284 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Run-time selection of the tile shape of block-wise algorithms -- implementation.
+ */
+#include "core/cachePolicyTuner.h"
+#include "core/plbDebug.h"
+#include "core/util.h"
+#include "parallelism/mpiManager.h"
+#include "parallelism/smpManager.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#ifdef PLB_USE_POSIX
+#include <unistd.h>
+#endif
+
+namespace plb {
+
+CachePolicyTuner::SizeClass::SizeClass()
+    : tuning(true),
+      currentCandidate(0),
+      numSweeps(0)
+{ }
+
+CachePolicyTuner::CachePolicyTuner(std::string name_, std::vector<Shape> const& candidates_)
+    : name(name_),
+      candidates(candidates_),
+      measuring(false)
+{
+    PLB_PRECONDITION( !candidates.empty() );
+}
+
+void CachePolicyTuner::reset() {
+#ifdef PLB_OPENMP
+    #pragma omp critical (plbCachePolicyTuner)
+#endif
+    {
+        sizeClasses.clear();
+        measuring = false;
+    }
+}
+
+CachePolicyTuner::Shape CachePolicyTuner::startSweep(plint numCells) {
+    Shape shape;
+#ifdef PLB_OPENMP
+    #pragma omp critical (plbCachePolicyTuner)
+#endif
+    {
+        SizeClass& sizeClass = getSizeClass(computeSizeClass(numCells));
+        if (sizeClass.tuning && global::smp().getThreadId()==0) {
+            measuring = true;
+            timer.restart();
+            shape = candidates[sizeClass.currentCandidate];
+        }
+        else {
+            shape = sizeClass.shape;
+        }
+    }
+    return shape;
+}
+
+void CachePolicyTuner::stopSweep(plint numCells) {
+    // Only thread 0 writes the flag measuring, and is therefore the only one to read it.
+    if (global::smp().getThreadId()!=0 || !measuring) {
+        return;
+    }
+    double time = timer.stop();
+#ifdef PLB_OPENMP
+    #pragma omp critical (plbCachePolicyTuner)
+#endif
+    {
+        measuring = false;
+        plint sizeClassId = computeSizeClass(numCells);
+        SizeClass& sizeClass = getSizeClass(sizeClassId);
+        if (sizeClass.tuning && numCells>0) {
+            // The fastest of a few sweeps is retained for each candidate, to
+            //   filter out perturbations like a cold cache.
+            static const plint sweepsPerCandidate = 3;
+            double newTimePerCell = time / (double)numCells;
+            double& candidateTime = sizeClass.timePerCell[sizeClass.currentCandidate];
+            if (candidateTime<0. || newTimePerCell<candidateTime) {
+                candidateTime = newTimePerCell;
+            }
+            if (++sizeClass.numSweeps == sweepsPerCandidate) {
+                sizeClass.numSweeps = 0;
+                ++sizeClass.currentCandidate;
+                if (sizeClass.currentCandidate==candidates.size()) {
+                    pluint fastest = std::min_element( sizeClass.timePerCell.begin(),
+                                                       sizeClass.timePerCell.end() )
+                                     - sizeClass.timePerCell.begin();
+                    sizeClass.shape = candidates[fastest];
+                    sizeClass.tuning = false;
+                    storeSelection(sizeClassId, sizeClass.shape);
+                }
+            }
+        }
+    }
+}
+
+void CachePolicyTuner::setFileName(std::string fileName_) {
+#ifdef PLB_OPENMP
+    #pragma omp critical (plbCachePolicyTuner)
+#endif
+    {
+        fileName() = fileName_;
+    }
+}
+
+std::string CachePolicyTuner::getFileName() {
+    return fileName();
+}
+
+plint CachePolicyTuner::computeSizeClass(plint numCells) {
+    plint sizeClassId = 0;
+    while (numCells > 1) {
+        numCells /= 2;
+        ++sizeClassId;
+    }
+    return sizeClassId;
+}
+
+/// Must be called from inside the critical section.
+CachePolicyTuner::SizeClass& CachePolicyTuner::getSizeClass(plint sizeClassId) {
+    std::map<plint,SizeClass>::iterator it = sizeClasses.find(sizeClassId);
+    if (it != sizeClasses.end()) {
+        return it->second;
+    }
+    SizeClass& sizeClass = sizeClasses[sizeClassId];
+    std::map<std::string, Shape>& entries = fileEntries();
+    std::map<std::string, Shape>::const_iterator entry = entries.find(fileKey(sizeClassId));
+    if (entry != entries.end() && entry->second.size()==candidates[0].size()) {
+        sizeClass.shape = entry->second;
+        sizeClass.tuning = false;
+    }
+    else {
+        sizeClass.shape = candidates[0];
+        sizeClass.timePerCell.resize(candidates.size(), -1.);
+    }
+    return sizeClass;
+}
+
+std::string CachePolicyTuner::fileKey(plint sizeClassId) const {
+    return machineId() + " " + name + " " + util::val2str(sizeClassId);
+}
+
+/// Key "machine name sizeClass" of a line of the file; returns false if the
+///   line cannot be parsed.
+static bool parseFileKey(std::istringstream& lineStream, std::string& key) {
+    std::string machine, lineName;
+    plint sizeClassId;
+    if (!(lineStream >> machine >> lineName >> sizeClassId)) {
+        return false;
+    }
+    key = machine + " " + lineName + " " + util::val2str(sizeClassId);
+    return true;
+}
+
+/// Writes a line "machine name sizeClass shape[0] shape[1] ..." to the file,
+///   which replaces a previous line with the same key. The file is written by
+///   the main processor only, which stores the selections of its own machine.
+void CachePolicyTuner::storeSelection(plint sizeClassId, Shape const& shape) const {
+    fileEntries()[fileKey(sizeClassId)] = shape;
+    if (fileName().empty() || !global::mpi().isMainProcessor()) {
+        return;
+    }
+    std::vector<std::string> lines;
+    std::ifstream ifile(fileName().c_str());
+    std::string line;
+    while (std::getline(ifile, line)) {
+        std::istringstream lineStream(line);
+        std::string key;
+        if (!parseFileKey(lineStream, key) || key != fileKey(sizeClassId)) {
+            lines.push_back(line);
+        }
+    }
+    ifile.close();
+    std::ostringstream newLine;
+    newLine << fileKey(sizeClassId);
+    for (pluint i=0; i<shape.size(); ++i) {
+        newLine << " " << shape[i];
+    }
+    lines.push_back(newLine.str());
+
+    std::ofstream ofile(fileName().c_str());
+    for (pluint iLine=0; iLine<lines.size(); ++iLine) {
+        ofile << lines[iLine] << "\n";
+    }
+}
+
+/// The file is read at the first access, and after a change of the file name.
+///   Lines which cannot be parsed are ignored, and later lines override earlier
+///   ones.
+std::map<std::string, CachePolicyTuner::Shape>& CachePolicyTuner::fileEntries() {
+    static std::map<std::string, Shape> entries;
+    static std::string loadedFile;
+    static bool loaded = false;
+    if (!loaded || loadedFile != fileName()) {
+        entries.clear();
+        loaded = true;
+        loadedFile = fileName();
+        std::ifstream ifile(loadedFile.c_str());
+        std::string line;
+        while (!loadedFile.empty() && std::getline(ifile, line)) {
+            std::istringstream lineStream(line);
+            std::string key;
+            if (!parseFileKey(lineStream, key)) continue;
+            Shape shape;
+            plint extent;
+            while (lineStream >> extent) {
+                shape.push_back(extent);
+            }
+            if (!shape.empty()) {
+                entries[key] = shape;
+            }
+        }
+    }
+    return entries;
+}
+
+std::string& CachePolicyTuner::fileName() {
+    static std::string fileNameSingleton;
+    return fileNameSingleton;
+}
+
+/// The host name is known with POSIX only, and the CPU model on Linux only.
+///   Blanks are replaced, as they separate the fields of the file.
+std::string const& CachePolicyTuner::machineId() {
+    static std::string machineIdSingleton;
+    if (machineIdSingleton.empty()) {
+        std::string hostName("unknownHost");
+#ifdef PLB_USE_POSIX
+        char hostNameBuffer[256];
+        if (gethostname(hostNameBuffer, sizeof(hostNameBuffer))==0) {
+            hostNameBuffer[sizeof(hostNameBuffer)-1] = '\0';
+            hostName = hostNameBuffer;
+        }
+#endif
+        std::string cpuModel("unknownCpu");
+        std::ifstream cpuInfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuInfo, line)) {
+            std::string::size_type colon = line.find(':');
+            if (line.compare(0, 10, "model name")==0 && colon != std::string::npos) {
+                std::string::size_type start = line.find_first_not_of(" \t", colon+1);
+                if (start != std::string::npos) {
+                    cpuModel = line.substr(start);
+                }
+                break;
+            }
+        }
+        machineIdSingleton = hostName + "/" + cpuModel;
+        for (pluint i=0; i<machineIdSingleton.size(); ++i) {
+            if (machineIdSingleton[i]==' ' || machineIdSingleton[i]=='\t') {
+                machineIdSingleton[i] = '_';
+            }
+        }
+    }
+    return machineIdSingleton;
+}
+
+}  // namespace plb
@@ -0,0 +1,101 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Run-time selection of the tile shape of block-wise algorithms -- header file.
+ */
+#ifndef CACHE_POLICY_TUNER_H
+#define CACHE_POLICY_TUNER_H
+
+#include "core/globalDefs.h"
+#include "core/plbTimer.h"
+#include <string>
+#include <vector>
+#include <map>
+
+namespace plb {
+
+/// Selects at run-time the fastest tile shape of a block-wise algorithm.
+/** The first sweeps over a domain are timed with a series of candidate tile
+ *  shapes, and the fastest one is kept. The selection is made separately for
+ *  each size class of the domain (the number of cells, rounded down to a power
+ *  of two). On request (see setFileName()), the result is stored in a small
+ *  file, which is read by the next runs, so that they skip the time
+ *  measurements. The entries of the file are specific to a machine (host name
+ *  and CPU model), so that the file can be shared by heterogeneous machines.
+ *
+ *  The time measurements are taken on thread 0 only; the other threads use
+ *  the current tile shape. All methods can be called from concurrent threads.
+ */
+class CachePolicyTuner {
+public:
+    typedef std::vector<plint> Shape;
+public:
+    /// The name identifies the algorithm in the file, and must therefore be
+    ///   unique (it usually contains the name of the descriptor).
+    CachePolicyTuner(std::string name_, std::vector<Shape> const& candidates_);
+    /// Forget the selections made so far. The selections stored in the file
+    ///   are still used.
+    void reset();
+    /// Tile shape for the next sweep over a domain of numCells cells. During
+    ///   the tuning, the sweep is timed until stopSweep() is called.
+    Shape startSweep(plint numCells);
+    /// End of a sweep over numCells cells which was started with startSweep().
+    void stopSweep(plint numCells);
+    /// File in which the selected tile shapes are stored, for example
+    ///   "plbCachePolicy.dat". With an empty name (the default), the results
+    ///   are neither read from nor written to a file.
+    static void setFileName(std::string fileName_);
+    static std::string getFileName();
+private:
+    /// Tuning state for one size class of domains.
+    struct SizeClass {
+        SizeClass();
+        Shape shape;
+        bool tuning;
+        pluint currentCandidate;
+        plint numSweeps;
+        std::vector<double> timePerCell;
+    };
+private:
+    static plint computeSizeClass(plint numCells);
+    SizeClass& getSizeClass(plint sizeClassId);
+    std::string fileKey(plint sizeClassId) const;
+    void storeSelection(plint sizeClassId, Shape const& shape) const;
+    /// Selections read from the file, indexed by fileKey().
+    static std::map<std::string, Shape>& fileEntries();
+    static std::string& fileName();
+    /// Identifier of the machine in the file, made of its host name and CPU model.
+    static std::string const& machineId();
+private:
+    std::string name;
+    std::vector<Shape> candidates;
+    std::map<plint,SizeClass> sizeClasses;
+    bool measuring;
+    global::PlbTimer timer;
+};
+
+}  // namespace plb
+
+#endif  // CACHE_POLICY_TUNER_H
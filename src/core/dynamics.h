@@ -102,6 +102,20 @@ struct Dynamics {
     virtual void collide(Cell<T,Descriptor>& cell,
                          BlockStatistics& statistics_) =0;
 
+    /// Collision step on numCells cells which are contiguous in memory, and
+    ///   which all refer to this dynamics object. The default implementation
+    ///   calls collide() on each cell; the common bulk dynamics override it
+    ///   with a loop in which the collision is not a virtual call.
+    virtual void collideSequence(Cell<T,Descriptor>* cells, plint numCells,
+                                 BlockStatistics& statistics_);
+
+    /// Collision step on numCells consecutive cells of a structure-of-arrays
+    ///   storage, in which f[iPop][iCell] is the population iPop of the cell iCell.
+    ///   Returns false, and leaves the populations untouched, if the dynamics
+    ///   has no implementation for this kind of storage (default).
+    virtual bool collidePopulationArrays(T* const* f, char const* takesStatistics,
+                                         plint numCells, BlockStatistics& statistics_);
+
     /// Implementation of the collision step, with imposed macroscopic variables
     virtual void collideExternal(Cell<T,Descriptor>& cell, T rhoBar,
                          Array<T,Descriptor<T>::d> const& j, T thetaBar, BlockStatistics& stat);
@@ -788,6 +802,15 @@ private:
     static int id;
 };
 
+/// Collision step on a sequence of cells, in which the collision of the class
+///   DynamicsT is called non-virtually, and can therefore be inlined. If the
+///   dynamic type of the object is not exactly DynamicsT (for example a class
+///   derived from DynamicsT which overrides collide()), the generic version
+///   Dynamics::collideSequence() is used instead.
+template<class DynamicsT, typename T, template<typename U> class Descriptor>
+void staticCollideSequence(DynamicsT& dynamics, Cell<T,Descriptor>* cells,
+                           plint numCells, BlockStatistics& statistics);
+
 /// Get all the IDs of the dynamics which are part of a composite dynamics construct.
 template<typename T, template<typename U> class Descriptor>
 void constructIdChain(Dynamics<T,Descriptor> const& dynamics, std::vector<int>& chain);
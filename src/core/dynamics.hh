@@ -39,6 +39,7 @@
 #include "multiGrid/multiGridUtil.h"
 #include <algorithm>
 #include <limits>
+#include <typeinfo>
 
 namespace plb {
 
@@ -127,6 +128,22 @@ void Dynamics<T,Descriptor>::unserialize(HierarchicUnserializer& unserializer)
     this->setOmega(unserializer.readValue<T>());
 }
 
+template<typename T, template<typename U> class Descriptor>
+void Dynamics<T,Descriptor>::collideSequence (
+        Cell<T,Descriptor>* cells, plint numCells, BlockStatistics& statistics )
+{
+    for (plint iCell=0; iCell<numCells; ++iCell) {
+        collide(cells[iCell], statistics);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool Dynamics<T,Descriptor>::collidePopulationArrays (
+        T* const* f, char const* takesStatistics, plint numCells, BlockStatistics& statistics )
+{
+    return false;
+}
+
 template<typename T, template<typename U> class Descriptor>
 void Dynamics<T,Descriptor>::collideExternal (
         Cell<T,Descriptor>& cell, T rhoBar,
@@ -1106,6 +1123,20 @@ void NoDynamics<T,Descriptor>::rescale (
         std::vector<T>& rawData, T xDxInv, T xDt, plint order ) const
 { }
 
+template<class DynamicsT, typename T, template<typename U> class Descriptor>
+void staticCollideSequence(DynamicsT& dynamics, Cell<T,Descriptor>* cells,
+                           plint numCells, BlockStatistics& statistics)
+{
+    if (typeid(dynamics)==typeid(DynamicsT)) {
+        for (plint iCell=0; iCell<numCells; ++iCell) {
+            dynamics.DynamicsT::collide(cells[iCell], statistics);
+        }
+    }
+    else {
+        dynamics.Dynamics<T,Descriptor>::collideSequence(cells, numCells, statistics);
+    }
+}
+
 template<typename T, template<typename U> class Descriptor>
 void constructIdChain(Dynamics<T,Descriptor> const& dynamics, std::vector<int>& chain)
 {
@@ -117,7 +117,7 @@ struct Box3D {
         z0 = array[4]; z1 = array[5];
     }
 
-    bool operator==(Box3D const& rhs) {
+    bool operator==(Box3D const& rhs) const {
         return x0 == rhs.x0 && y0 == rhs.y0 && z0 == rhs.z0 &&
                x1 == rhs.x1 && y1 == rhs.y1 && z1 == rhs.z1;
     }
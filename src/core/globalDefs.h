@@ -162,6 +162,48 @@ namespace IndexOrdering {
     enum OrderingT {forward, backward, memorySaving};
 }
 
+/// Memory layout of the cells of a block-lattice.
+/** Signification of constants:
+ *    - cellArray: Array of Cell objects. The populations, the external scalars
+ *                 and the pointer to the dynamics object of a cell are
+ *                 contiguous in memory.
+ *    - populationArrays: Each population direction and each external scalar
+ *                        is stored in a separate, aligned array, and the
+ *                        dynamics objects are referred to through an array
+ *                        of integer ids.
+ *    - twoPopulationArrays: Same as populationArrays, with a second set of
+ *                           population arrays. The collision-streaming step
+ *                           reads one set and writes the other one (AB
+ *                           pattern), in a single pass over memory.
+ *    - floatPopulationArrays, twoFloatPopulationArrays: Same as populationArrays
+ *                           and twoPopulationArrays, with the populations
+ *                           stored in single precision. The collision and the
+ *                           reductions are computed in the precision of the
+ *                           lattice.
+ *    - sparsePopulationArrays: Same as populationArrays, with memory allocated
+ *                              for active cells only. Solid cells (no-dynamics
+ *                              and bounce-back) surrounded by solid cells are
+ *                              inactive, and the streaming step follows an
+ *                              explicit list of neighbors.
+ **/
+namespace LatticeStorage {
+    enum StorageT { cellArray, populationArrays, twoPopulationArrays,
+                    floatPopulationArrays, twoFloatPopulationArrays,
+                    sparsePopulationArrays };
+    /// Whether the storage uses two sets of population arrays (AB pattern).
+    inline bool usesTwoLattices(StorageT storage) {
+        return storage==twoPopulationArrays || storage==twoFloatPopulationArrays;
+    }
+    /// Whether the populations are stored in single precision.
+    inline bool usesSinglePrecision(StorageT storage) {
+        return storage==floatPopulationArrays || storage==twoFloatPopulationArrays;
+    }
+    /// Whether only the active cells are stored.
+    inline bool usesSparseStorage(StorageT storage) {
+        return storage==sparsePopulationArrays;
+    }
+}
+
 /// Sub-domain of an atomic-block, on which for example a data processor is executed.
 /** Signification of constants:
  *      - bulk: Refers to bulk-nodes, without envelope.
@@ -41,6 +41,7 @@
 #include "core/blockLatticeBase3D.h"
 #include "core/latticeStatistics.h"
 #include "core/plbTimer.h"
+#include "core/plbBlockProfiler.h"
 #include "core/plbRandom.h"
 #include "core/plbLogFiles.h"
 #include "core/indexUtil.h"
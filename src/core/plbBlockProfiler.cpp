@@ -0,0 +1,118 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+ * Per-block timers and cell-update counters -- implementation.
+ */
+
+#include "core/plbBlockProfiler.h"
+#include "core/util.h"
+#include "parallelism/mpiManager.h"
+#include "parallelism/smpManager.h"
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+
+namespace plb {
+
+namespace global {
+
+BlockProfiler::BlockProfiler() {
+    turnOff();
+    setReportFile("plbBlockProfile");
+}
+
+void BlockProfiler::turnOn() {
+    profilingFlag = true;
+}
+
+void BlockProfiler::turnOff() {
+    profilingFlag = false;
+}
+
+double BlockProfiler::getTime() const {
+#if defined(PLB_OPENMP)
+    return smp().getTime();
+#elif defined(PLB_MPI_PARALLEL)
+    return mpi().getTime();
+#else
+    return (double)clock() / (double)CLOCKS_PER_SEC;
+#endif
+}
+
+void BlockProfiler::add( id_t multiBlockId, plint blockId, std::string const& category,
+                         double time, plint numCells )
+{
+    BlockProfileEntry& entry = table[std::make_pair(multiBlockId,blockId)][category];
+    ++entry.numCalls;
+    entry.numCells += numCells;
+    entry.time += time;
+}
+
+BlockProfiler::Table const& BlockProfiler::getTable() const {
+    return table;
+}
+
+std::map<plint,double> BlockProfiler::getTimes(id_t multiBlockId) const {
+    std::map<plint,double> times;
+    Table::const_iterator it = table.lower_bound(std::make_pair(multiBlockId,(plint)0));
+    for (; it!=table.end() && it->first.first==multiBlockId; ++it) {
+        double& time = times[it->first.second];
+        for (CategoryMap::const_iterator category=it->second.begin(); category!=it->second.end(); ++category) {
+            time += category->second.time;
+        }
+    }
+    return times;
+}
+
+void BlockProfiler::reset() {
+    table.clear();
+}
+
+void BlockProfiler::setReportFile(FileName const& reportFile_) {
+    reportFile = reportFile_;
+    reportFile.defaultPath(directories().getOutputDir());
+    reportFile.defaultExt("dat");
+}
+
+void BlockProfiler::writeReport() const {
+    FileName fileName(reportFile);
+    fileName.setName(reportFile.getName()+"_"+util::val2str(mpi().getRank()));
+    std::ofstream ofile(fileName.get().c_str());
+    ofile << "# multiBlock block category calls cells time cellsPerSecond" << std::endl;
+    ofile << std::setprecision(6);
+    for (Table::const_iterator it=table.begin(); it!=table.end(); ++it) {
+        for (CategoryMap::const_iterator category=it->second.begin(); category!=it->second.end(); ++category) {
+            BlockProfileEntry const& entry = category->second;
+            ofile << it->first.first << " " << it->first.second << " " << category->first << " "
+                  << entry.numCalls << " " << entry.numCells << " " << entry.time << " "
+                  << (entry.time>0. ? (double)entry.numCells/entry.time : 0.) << std::endl;
+        }
+    }
+}
+
+}  // namespace global
+
+}  // namespace plb
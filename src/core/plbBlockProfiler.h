@@ -0,0 +1,111 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+ * Per-block timers and cell-update counters -- header file.
+ */
+
+#ifndef PLB_BLOCK_PROFILER_H
+#define PLB_BLOCK_PROFILER_H
+
+#include "core/globalDefs.h"
+#include "io/plbFiles.h"
+#include <map>
+#include <string>
+#include <utility>
+
+namespace plb {
+
+namespace global {
+
+/// Accumulated execution time and number of updated cells of one category
+///   of work on one block.
+struct BlockProfileEntry {
+    BlockProfileEntry() : numCalls(0), numCells(0), time(0.) { }
+    plint numCalls;
+    plint numCells;
+    double time;
+};
+
+/// Time spent and cells updated on each local atomic-block, per category of work.
+/**
+ * The entries are identified by the id of the multi-block, the id of the
+ * atomic-block, and the category:
+ * "collideAndStream",
+ * "collideAndStreamShell",
+ * "collideAndStreamInterior":       Collision-streaming step (or its parts when
+ *                                   communication is overlapped with it).
+ * "internalProcessors<level>":      Internal data processors of a given level
+ *                                   (the cells are those of the bulk).
+ * "envelopePacking":                Packing of the data sent to other processes.
+ * "envelopeUnpacking":              Unpacking of the data received from other processes.
+ * "envelopeCopy":                   Copy of the data between local blocks.
+ *
+ * The envelope entries are only recorded by the parallel block-communicator.
+ * Each process records its own blocks, and writes its own report.
+ **/
+class BlockProfiler {
+public:
+    typedef std::map<std::string,BlockProfileEntry> CategoryMap;
+    typedef std::map<std::pair<id_t,plint>,CategoryMap> Table;
+public:
+    void turnOn();
+    void turnOff();
+    bool doProfiling() const {
+        return profilingFlag;
+    }
+    /// Wall-clock time in seconds.
+    double getTime() const;
+    /// Add the work done on a block. Must not be called concurrently by
+    ///   several threads.
+    void add( id_t multiBlockId, plint blockId, std::string const& category,
+              double time, plint numCells );
+    Table const& getTable() const;
+    /// Time spent on each local block of a multi-block, summed over all categories.
+    std::map<plint,double> getTimes(id_t multiBlockId) const;
+    void reset();
+    void setReportFile(FileName const& reportFile_);
+    /// Write the table of the current process into the report file, with the
+    ///   rank appended to its name.
+    void writeReport() const;
+private:
+    BlockProfiler();
+private:
+    bool profilingFlag;
+    FileName reportFile;
+    Table table;
+friend BlockProfiler& blockProfiler();
+};
+
+inline BlockProfiler& blockProfiler() {
+    static BlockProfiler instance;
+    return instance;
+}
+
+}  // namespace global
+
+}  // namespace plb
+
+#endif  // PLB_BLOCK_PROFILER_H
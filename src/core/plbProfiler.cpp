@@ -24,6 +24,7 @@
 
 #include "core/plbProfiler.h"
 #include "parallelism/mpiManager.h"
+#include "parallelism/smpManager.h"
 #include "core/runTimeDiagnostics.h"
 #include "algorithm/statistics.h"
 #include "libraryInterfaces/TINYXML_xmlIO.hh"
@@ -45,6 +46,7 @@ Profiler::Profiler() {
     validTimers.insert("collStream");
     validTimers.insert("cycle");
     validTimers.insert("dataProcessor");
+    validTimers.insert("envelope-update");
     validTimers.insert("mpiCommunication");
     validTimers.insert("io");
     validTimers.insert("totalTime");
@@ -59,6 +61,30 @@ void Profiler::turnOff() {
     profilingFlag = false;
 }
 
+void Profiler::startTimer(char const* timer) {
+    if (smp().getThreadId()==0) {
+        verifyTimer(timer);
+        plbTimer(timer).start();
+    }
+}
+
+void Profiler::stopTimer(char const* timer) {
+    if (smp().getThreadId()==0) {
+        verifyTimer(timer);
+        plbTimer(timer).stop();
+    }
+}
+
+void Profiler::incrementCounter(char const* counter, plint value) {
+#ifdef PLB_OPENMP
+    #pragma omp critical (plbProfilerCounters)
+#endif
+    {
+        verifyCounter(counter);
+        plbCounter(counter).increment(value);
+    }
+}
+
 void Profiler::automaticCycling() {
     manualCycleFlag = false;
 }
@@ -69,26 +69,22 @@ public:
     }
     void start(char const* timer) {
         if (doProfiling()) {
-            verifyTimer(timer);
-            plbTimer(timer).start();
+            startTimer(timer);
         }
     }
     void stop(char const* timer) {
         if (doProfiling()) {
-            verifyTimer(timer);
-            plbTimer(timer).stop();
+            stopTimer(timer);
         }
     }
     void increment(char const* counter) {
         if (doProfiling()) {
-            verifyCounter(counter);
-            plbCounter(counter).increment();
+            incrementCounter(counter, 1);
         }
     }
     void increment(char const* counter, plint value) {
         if (doProfiling()) {
-            verifyCounter(counter);
-            plbCounter(counter).increment(value);
+            incrementCounter(counter, value);
         }
     }
     plint getCounter(char const* counter) {
@@ -102,6 +98,11 @@ public:
     void setReportFile(FileName const& reportFile_);
     void writeReport();
 private:
+    /// Timers are only operated by the master thread of an SMP parallel region.
+    void startTimer(char const* timer);
+    void stopTimer(char const* timer);
+    /// Counters are incremented by all threads of an SMP parallel region.
+    void incrementCounter(char const* counter, plint value);
     void verifyTimer(std::string const& timer);
     void verifyCounter(std::string const& counter);
     void addStatisticalValue(XMLwriter& writer, std::string name, double value);
@@ -396,6 +396,92 @@ std::vector<plint> const& subIndexOutgoingInternalCorner3D() {
     return subIndexOutgoingInternalCorner3DSingleton.indices;
 }
 
+/// Skew of the block-wise traversal used with the swap-streaming algorithm in 2D.
+/** Same as SwapStreamingSkew3D: the y-range of a block is shifted by -xShiftY
+ *  at each x-increment (1 on D2Q9).
+ */
+template <typename Descriptor>
+class SwapStreamingSkew2D {
+public:
+    SwapStreamingSkew2D()
+        : xShiftY(0)
+    {
+        for (plint iPop=1; iPop<=Descriptor::q/2; ++iPop) {
+            int cx = Descriptor::c[iPop][0];
+            int cy = Descriptor::c[iPop][1];
+            if (cx<0) {
+                plint shift = cy>0 ? (cy-cx-1)/(-cx) : 0;
+                xShiftY = std::max(xShiftY, shift);
+            }
+        }
+    }
+    plint getXshiftY() const { return xShiftY; }
+private:
+    plint xShiftY;
+};
+
+template <typename Descriptor>
+SwapStreamingSkew2D<Descriptor> const& swapStreamingSkew2D() {
+    static SwapStreamingSkew2D<Descriptor> swapStreamingSkew2DSingleton;
+    return swapStreamingSkew2DSingleton;
+}
+
+/// Skew of the block-wise traversal used with the swap-streaming algorithm in 3D.
+/** During swap-streaming, a cell exchanges populations with its neighbors in
+ *  the directions 1 to q/2, which must have been collided already. In a
+ *  block-wise traversal, this is guaranteed if the y-range of a block is
+ *  shifted by -xShiftY at each x-increment, and the z-range by -xShiftZ at
+ *  each x-increment and by -yShiftZ at each y-increment. The shifts are
+ *  computed from the velocity set of the descriptor, and are the smallest
+ *  ones which fulfill this condition (1,1,1 on D3Q19, 1,2,1 on D3Q27).
+ */
+template <typename Descriptor>
+class SwapStreamingSkew3D {
+public:
+    SwapStreamingSkew3D()
+        : xShiftY(0), xShiftZ(0), yShiftZ(0)
+    {
+        for (plint iPop=1; iPop<=Descriptor::q/2; ++iPop) {
+            int cx = Descriptor::c[iPop][0];
+            int cy = Descriptor::c[iPop][1];
+            int cz = Descriptor::c[iPop][2];
+            if (cx<0) {
+                xShiftY = std::max(xShiftY, ceilDiv(cy, -cx));
+            }
+            else if (cx==0 && cy<0) {
+                yShiftZ = std::max(yShiftZ, ceilDiv(cz, -cy));
+            }
+        }
+        for (plint iPop=1; iPop<=Descriptor::q/2; ++iPop) {
+            int cx = Descriptor::c[iPop][0];
+            int cy = Descriptor::c[iPop][1];
+            int cz = Descriptor::c[iPop][2];
+            if (cx<0) {
+                xShiftZ = std::max(xShiftZ, ceilDiv(cz+yShiftZ*cy, -cx));
+            }
+        }
+    }
+    plint getXshiftY() const { return xShiftY; }
+    plint getXshiftZ() const { return xShiftZ; }
+    plint getYshiftZ() const { return yShiftZ; }
+private:
+    /// Integer division rounded toward plus infinity, for a positive denominator.
+    static plint ceilDiv(plint numerator, plint denominator) {
+        if (numerator >= 0) {
+            return (numerator+denominator-1)/denominator;
+        }
+        return -((-numerator)/denominator);
+    }
+private:
+    plint xShiftY, xShiftZ, yShiftZ;
+};
+
+template <typename Descriptor>
+SwapStreamingSkew3D<Descriptor> const& swapStreamingSkew3D() {
+    static SwapStreamingSkew3D<Descriptor> swapStreamingSkew3DSingleton;
+    return swapStreamingSkew3DSingleton;
+}
+
 }  // namespace indexTemplates
 
 }  // namespace plb
@@ -0,0 +1,316 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Vectorized collision kernels, which act on several cells at once. They
+ * operate on a structure-of-arrays storage (see PopulationArrays3D), in
+ * which the same population of consecutive cells is contiguous in memory.
+ *
+ * The instruction set is chosen at compile time: AVX-512, AVX or SSE2,
+ * depending on the flags of the compiler (e.g. -march=native). Without
+ * any of these, or if PLB_NO_SIMD is defined, the kernels fall back to
+ * scalar code. The results are the same as the ones of the scalar
+ * templates in dynamicsTemplates.h, up to round-off errors.
+ */
+#ifndef SIMD_DYNAMICS_TEMPLATES_H
+#define SIMD_DYNAMICS_TEMPLATES_H
+
+#include "core/globalDefs.h"
+#include "core/blockStatistics.h"
+#include "core/latticeStatistics.h"
+#include <algorithm>
+
+#ifndef PLB_NO_SIMD
+#if defined(__AVX512F__) || defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#define PLB_SIMD_X86
+#endif
+#endif
+
+namespace plb {
+
+namespace simd {
+
+/// Vector of width 1, used in absence of SIMD instructions and for the
+///   remainder of a sequence of cells.
+template<typename T>
+struct ScalarPack {
+    enum { width = 1 };
+    ScalarPack() { }
+    explicit ScalarPack(T value) : v(value) { }
+    static ScalarPack load(T const* p) { return ScalarPack(*p); }
+    void store(T* p) const { *p = v; }
+    T v;
+};
+
+template<typename T>
+inline ScalarPack<T> operator+(ScalarPack<T> a, ScalarPack<T> b) { return ScalarPack<T>(a.v+b.v); }
+template<typename T>
+inline ScalarPack<T> operator-(ScalarPack<T> a, ScalarPack<T> b) { return ScalarPack<T>(a.v-b.v); }
+template<typename T>
+inline ScalarPack<T> operator*(ScalarPack<T> a, ScalarPack<T> b) { return ScalarPack<T>(a.v*b.v); }
+
+/// Widest vector type available for T.
+template<typename T>
+struct NativePack {
+    typedef ScalarPack<T> type;
+};
+
+#ifdef PLB_SIMD_X86
+
+#if defined(__AVX512F__)
+#define PLB_SIMD_PACK(NAME, T, VEC, WIDTH, SUFFIX) \
+    struct NAME { \
+        enum { width = WIDTH }; \
+        NAME() { } \
+        explicit NAME(T value) : v(_mm512_set1_##SUFFIX(value)) { } \
+        NAME(VEC v_) : v(v_) { } \
+        static NAME load(T const* p) { return NAME(_mm512_loadu_##SUFFIX(p)); } \
+        void store(T* p) const { _mm512_storeu_##SUFFIX(p, v); } \
+        VEC v; \
+    }; \
+    inline NAME operator+(NAME a, NAME b) { return NAME(_mm512_add_##SUFFIX(a.v,b.v)); } \
+    inline NAME operator-(NAME a, NAME b) { return NAME(_mm512_sub_##SUFFIX(a.v,b.v)); } \
+    inline NAME operator*(NAME a, NAME b) { return NAME(_mm512_mul_##SUFFIX(a.v,b.v)); }
+PLB_SIMD_PACK(DoublePack, double, __m512d, 8, pd)
+PLB_SIMD_PACK(FloatPack,  float,  __m512,  16, ps)
+#elif defined(__AVX__)
+#define PLB_SIMD_PACK(NAME, T, VEC, WIDTH, SUFFIX) \
+    struct NAME { \
+        enum { width = WIDTH }; \
+        NAME() { } \
+        explicit NAME(T value) : v(_mm256_set1_##SUFFIX(value)) { } \
+        NAME(VEC v_) : v(v_) { } \
+        static NAME load(T const* p) { return NAME(_mm256_loadu_##SUFFIX(p)); } \
+        void store(T* p) const { _mm256_storeu_##SUFFIX(p, v); } \
+        VEC v; \
+    }; \
+    inline NAME operator+(NAME a, NAME b) { return NAME(_mm256_add_##SUFFIX(a.v,b.v)); } \
+    inline NAME operator-(NAME a, NAME b) { return NAME(_mm256_sub_##SUFFIX(a.v,b.v)); } \
+    inline NAME operator*(NAME a, NAME b) { return NAME(_mm256_mul_##SUFFIX(a.v,b.v)); }
+PLB_SIMD_PACK(DoublePack, double, __m256d, 4, pd)
+PLB_SIMD_PACK(FloatPack,  float,  __m256,  8, ps)
+#else
+#define PLB_SIMD_PACK(NAME, T, VEC, WIDTH, SUFFIX) \
+    struct NAME { \
+        enum { width = WIDTH }; \
+        NAME() { } \
+        explicit NAME(T value) : v(_mm_set1_##SUFFIX(value)) { } \
+        NAME(VEC v_) : v(v_) { } \
+        static NAME load(T const* p) { return NAME(_mm_loadu_##SUFFIX(p)); } \
+        void store(T* p) const { _mm_storeu_##SUFFIX(p, v); } \
+        VEC v; \
+    }; \
+    inline NAME operator+(NAME a, NAME b) { return NAME(_mm_add_##SUFFIX(a.v,b.v)); } \
+    inline NAME operator-(NAME a, NAME b) { return NAME(_mm_sub_##SUFFIX(a.v,b.v)); } \
+    inline NAME operator*(NAME a, NAME b) { return NAME(_mm_mul_##SUFFIX(a.v,b.v)); }
+PLB_SIMD_PACK(DoublePack, double, __m128d, 2, pd)
+PLB_SIMD_PACK(FloatPack,  float,  __m128,  4, ps)
+#endif
+
+#undef PLB_SIMD_PACK
+
+template<>
+struct NativePack<double> {
+    typedef DoublePack type;
+};
+
+template<>
+struct NativePack<float> {
+    typedef FloatPack type;
+};
+
+#endif  // PLB_SIMD_X86
+
+}  // namespace simd
+
+/// Collision models implemented in simdDynamicsTemplates.
+namespace SimdCollision {
+    enum ModelT {bgk_ma2, bgk_inc, trt_ma2};
+}
+
+/// Vectorized collision on a sequence of cells of a structure-of-arrays storage.
+/** In all functions, f[iPop][iCell] is the population iPop of the cell
+ *  number iCell, for 0 <= iCell < numCells. Statistics are gathered for the
+ *  cells for which takesStatistics[iCell] is non-zero, in the same way as in
+ *  the corresponding Dynamics::collide() methods. The lattice must be such
+ *  that the populations iPop and iPop+q/2 are opposite, for 0 < iPop <= q/2.
+ */
+template<typename T, template<typename U> class Descriptor>
+struct simdDynamicsTemplates {
+
+/// Same as dynamicsTemplates::bgk_ma2_collision(), used by BGKdynamics.
+static void bgk_ma2_collision( T* const* f, char const* takesStatistics, plint numCells,
+                               T omega, BlockStatistics& statistics )
+{
+    collide(SimdCollision::bgk_ma2, f, takesStatistics, numCells, omega, T(), T(), statistics);
+}
+
+/// Same as dynamicsTemplates::bgk_inc_collision(), used by IncBGKdynamics.
+static void bgk_inc_collision( T* const* f, char const* takesStatistics, plint numCells,
+                               T omega, T invRho0, BlockStatistics& statistics )
+{
+    collide(SimdCollision::bgk_inc, f, takesStatistics, numCells, omega, T(), invRho0, statistics);
+}
+
+/// Same collision as TRTdynamics::collide().
+static void trt_ma2_collision( T* const* f, char const* takesStatistics, plint numCells,
+                               T sPlus, T sMinus, BlockStatistics& statistics )
+{
+    collide(SimdCollision::trt_ma2, f, takesStatistics, numCells, sPlus, sMinus, T(), statistics);
+}
+
+private:
+
+/// The cells are processed in chunks, to keep the values of rhoBar and uSqr
+///   required for the statistics on the stack.
+static void collide( SimdCollision::ModelT model, T* const* f, char const* takesStatistics,
+                     plint numCells, T omega, T sMinus, T invRho0, BlockStatistics& statistics )
+{
+    typedef typename simd::NativePack<T>::type Pack;
+    static const plint chunkSize = 64;
+    T rhoBar[chunkSize], uSqr[chunkSize];
+    for (plint chunkStart=0; chunkStart<numCells; chunkStart+=chunkSize) {
+        plint chunkEnd = std::min(chunkStart+chunkSize, numCells);
+        plint iCell = chunkStart;
+        for (; iCell+Pack::width <= chunkEnd; iCell+=Pack::width) {
+            collidePack<Pack> (
+                model, f, iCell, omega, sMinus, invRho0,
+                rhoBar+(iCell-chunkStart), uSqr+(iCell-chunkStart) );
+        }
+        for (; iCell<chunkEnd; ++iCell) {
+            collidePack<simd::ScalarPack<T> > (
+                model, f, iCell, omega, sMinus, invRho0,
+                rhoBar+(iCell-chunkStart), uSqr+(iCell-chunkStart) );
+        }
+        for (iCell=chunkStart; iCell<chunkEnd; ++iCell) {
+            if (takesStatistics[iCell]) {
+                gatherStatistics(statistics, rhoBar[iCell-chunkStart], uSqr[iCell-chunkStart]);
+            }
+        }
+    }
+}
+
+/// Collision of Pack::width consecutive cells, starting at iCell.
+template<class Pack>
+static void collidePack( SimdCollision::ModelT model, T* const* f, plint iCell,
+                         T omega, T sMinus, T invRho0, T* rhoBarOut, T* uSqrOut )
+{
+    static const int q = Descriptor<T>::q;
+    static const int d = Descriptor<T>::d;
+    static const int half = Descriptor<T>::q/2;
+    const T invCs2 = Descriptor<T>::invCs2;
+
+    // Moments rhoBar and j.
+    Pack rhoBar = Pack::load(f[0]+iCell);
+    Pack j[d];
+    for (int iD=0; iD<d; ++iD) {
+        j[iD] = Pack((T)0);
+    }
+    for (int iPop=1; iPop<q; ++iPop) {
+        Pack fi = Pack::load(f[iPop]+iCell);
+        rhoBar = rhoBar + fi;
+        for (int iD=0; iD<d; ++iD) {
+            int c = Descriptor<T>::c[iPop][iD];
+            if (c==1)       j[iD] = j[iD] + fi;
+            else if (c==-1) j[iD] = j[iD] - fi;
+            else if (c!=0)  j[iD] = j[iD] + Pack((T)c)*fi;
+        }
+    }
+    Pack jSqr = j[0]*j[0];
+    for (int iD=1; iD<d; ++iD) {
+        jSqr = jSqr + j[iD]*j[iD];
+    }
+
+    // 1/rho depends on the round-off policy of the lattice, and is therefore
+    //   evaluated cell by cell.
+    Pack invRho;
+    if (model==SimdCollision::bgk_inc) {
+        invRho = Pack(invRho0);
+    }
+    else {
+        T rhoBarValues[Pack::width], invRhoValues[Pack::width];
+        rhoBar.store(rhoBarValues);
+        for (int i=0; i<Pack::width; ++i) {
+            invRhoValues[i] = Descriptor<T>::invRho(rhoBarValues[i]);
+        }
+        invRho = Pack::load(invRhoValues);
+    }
+
+    // The equilibrium of the population i is t_i*(base + c_j*invCs2 + c_j^2*k2),
+    //   with c_j = c_i.j.
+    Pack base = rhoBar - Pack(invCs2/(T)2)*invRho*jSqr;
+    Pack k2   = Pack(invCs2*invCs2/(T)2)*invRho;
+
+    Pack f0 = Pack::load(f[0]+iCell);
+    Pack eq0 = Pack(Descriptor<T>::t[0])*base;
+    if (model==SimdCollision::trt_ma2) {
+        Pack sPlus(omega);
+        f0 = f0 - sPlus*f0 + sPlus*eq0;
+    }
+    else {
+        f0 = f0*Pack((T)1-omega) + Pack(omega)*eq0;
+    }
+    f0.store(f[0]+iCell);
+
+    for (int iPop=1; iPop<=half; ++iPop) {
+        Pack c_j((T)0);
+        for (int iD=0; iD<d; ++iD) {
+            int c = Descriptor<T>::c[iPop][iD];
+            if (c==1)       c_j = c_j + j[iD];
+            else if (c==-1) c_j = c_j - j[iD];
+            else if (c!=0)  c_j = c_j + Pack((T)c)*j[iD];
+        }
+        Pack t(Descriptor<T>::t[iPop]);
+        // Even and odd part of the equilibrium.
+        Pack eqPlus  = t*(base + k2*c_j*c_j);
+        Pack eqMinus = t*(Pack(invCs2)*c_j);
+        Pack fi   = Pack::load(f[iPop]+iCell);
+        Pack fOpp = Pack::load(f[iPop+half]+iCell);
+        if (model==SimdCollision::trt_ma2) {
+            Pack fPlus  = Pack((T)0.5)*(fi+fOpp);
+            Pack fMinus = Pack((T)0.5)*(fi-fOpp);
+            Pack relaxPlus  = Pack(omega)*(fPlus-eqPlus);
+            Pack relaxMinus = Pack(sMinus)*(fMinus-eqMinus);
+            fi   = fi   - relaxPlus - relaxMinus;
+            fOpp = fOpp - relaxPlus + relaxMinus;
+        }
+        else {
+            Pack oneMinusOmega((T)1-omega);
+            fi   = fi*oneMinusOmega   + Pack(omega)*(eqPlus+eqMinus);
+            fOpp = fOpp*oneMinusOmega + Pack(omega)*(eqPlus-eqMinus);
+        }
+        fi.store(f[iPop]+iCell);
+        fOpp.store(f[iPop+half]+iCell);
+    }
+
+    rhoBar.store(rhoBarOut);
+    (jSqr*invRho*invRho).store(uSqrOut);
+}
+
+};  // struct simdDynamicsTemplates
+
+}  // namespace plb
+
+#endif  // SIMD_DYNAMICS_TEMPLATES_H
@@ -45,6 +45,38 @@ struct BlockCommunicator3D {
      *  is being transmitted.
      **/
     virtual void duplicateOverlaps(MultiBlock3D& multiBlock, modif::ModifT whichData) const =0;
+    /// Split-phase version of duplicateOverlaps(), to overlap communication with computations.
+    /** startDuplicateOverlaps() sends the content of the bulk cells which are duplicated
+     *  on other processes, and completeDuplicateOverlaps() duplicates the local overlaps
+     *  and receives the remote ones. In-between, the cells which are sent or received
+     *  must not be accessed. By default, all the work is done in completeDuplicateOverlaps().
+     **/
+    virtual void startDuplicateOverlaps(MultiBlock3D& multiBlock, modif::ModifT whichData) const { }
+    virtual void completeDuplicateOverlaps(MultiBlock3D& multiBlock, modif::ModifT whichData) const {
+        duplicateOverlaps(multiBlock, whichData);
+    }
+    /// Split-phase update of the envelopes after a collision-streaming step, in which only
+    ///   the static data streamed into the envelopes from outside the blocks is transmitted.
+    /** The rest of the static data of the envelopes is expected to be up to date (see
+     *  BlockDataTransfer3D::sendIncoming()). By default, all the static data is transmitted.
+     **/
+    virtual void startDuplicateIncoming(MultiBlock3D& multiBlock) const {
+        startDuplicateOverlaps(multiBlock, modif::staticVariables);
+    }
+    virtual void completeDuplicateIncoming(MultiBlock3D& multiBlock) const {
+        completeDuplicateOverlaps(multiBlock, modif::staticVariables);
+    }
+    /// Fill the overlaps of several multi-blocks with the same distribution (see
+    ///   MultiBlockManagement3D::getDistributionId()) in a single exchange.
+    /** The content of all multi-blocks is aggregated into one message per pair of
+     *  processes. Returns false if the communicator does not aggregate messages,
+     *  in which case the overlaps of each multi-block must be filled separately.
+     **/
+    virtual bool duplicateGroupOverlaps( std::vector<MultiBlock3D*> const& multiBlocks,
+                                         std::vector<modif::ModifT> const& whichData ) const
+    {
+        return false;
+    }
     /// Transmit data between two multi-blocks, according to a user-defined pattern.
     /** The variable whichData specifies which type of content (static/dynamic/full dynamics object)
      *  is being transmitted.
@@ -0,0 +1,227 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Execution of tasks on the local blocks of a multi-block by shared-memory
+ * threads, with work stealing -- implementation.
+ */
+
+#include "multiBlock/blockScheduler.h"
+#include "parallelism/smpManager.h"
+#include "core/plbBlockProfiler.h"
+#include "core/plbDebug.h"
+#include <algorithm>
+#include <deque>
+#include <utility>
+#ifdef PLB_OPENMP
+#include <omp.h>
+#endif
+
+namespace plb {
+
+/// Sort blocks by decreasing cost.
+struct BlockCostIsLarger {
+    bool operator()(std::pair<double,plint> const& a, std::pair<double,plint> const& b) const {
+        return a.first > b.first;
+    }
+};
+
+#ifdef PLB_OPENMP
+
+/// Per-thread queues of blocks, each one protected by a lock.
+class BlockStealingQueues {
+public:
+    BlockStealingQueues(std::vector<std::vector<plint> > const& blocks)
+        : queues(blocks.size()),
+          locks(blocks.size())
+    {
+        for (pluint iQueue=0; iQueue<queues.size(); ++iQueue) {
+            queues[iQueue].assign(blocks[iQueue].begin(), blocks[iQueue].end());
+            omp_init_lock(&locks[iQueue]);
+        }
+    }
+    ~BlockStealingQueues() {
+        for (pluint iQueue=0; iQueue<locks.size(); ++iQueue) {
+            omp_destroy_lock(&locks[iQueue]);
+        }
+    }
+    /// Take a block from the front of the own queue, or else steal one from
+    ///   the back of another queue. Returns -1 when all queues are empty.
+    plint next(pluint threadId) {
+        pluint numQueues = queues.size();
+        for (pluint iQueue=0; iQueue<numQueues; ++iQueue) {
+            pluint victim = (threadId+iQueue) % numQueues;
+            plint blockId = -1;
+            omp_set_lock(&locks[victim]);
+            if (!queues[victim].empty()) {
+                if (victim==threadId) {
+                    blockId = queues[victim].front();
+                    queues[victim].pop_front();
+                }
+                else {
+                    blockId = queues[victim].back();
+                    queues[victim].pop_back();
+                }
+            }
+            omp_unset_lock(&locks[victim]);
+            if (blockId>=0) {
+                return blockId;
+            }
+        }
+        return -1;
+    }
+private:
+    BlockStealingQueues(BlockStealingQueues const& rhs);
+    BlockStealingQueues& operator=(BlockStealingQueues const& rhs);
+private:
+    std::vector<std::deque<plint> > queues;
+    std::vector<omp_lock_t> locks;
+};
+
+#endif  // PLB_OPENMP
+
+BlockScheduler::BlockScheduler()
+    : accumulateCosts(false)
+{ }
+
+void BlockScheduler::execute( std::string const& taskName, std::vector<plint> const& blocks,
+                              ThreadAttribution const& attribution, BlockTask& task )
+{
+    int numThreads = global::smp().getNumThreads();
+#ifdef PLB_OPENMP
+    if (numThreads>1 && blocks.size()>1) {
+        std::map<plint,double>& taskCosts = costs[taskName];
+        BlockStealingQueues queues(fillQueues(taskCosts, blocks, attribution, numThreads));
+        std::vector<std::vector<std::pair<plint,double> > > measuredCosts(numThreads);
+        #pragma omp parallel num_threads(numThreads)
+        {
+            pluint threadId = global::smp().getThreadId();
+            std::vector<std::pair<plint,double> >& threadCosts = measuredCosts[threadId];
+            for (plint blockId = queues.next(threadId); blockId>=0; blockId = queues.next(threadId)) {
+                double startTime = global::blockProfiler().getTime();
+                task.execute(blockId);
+                threadCosts.push_back(std::make_pair(blockId, global::blockProfiler().getTime()-startTime));
+            }
+        }
+        taskCosts.clear();
+        for (pluint iThread=0; iThread<measuredCosts.size(); ++iThread) {
+            taskCosts.insert(measuredCosts[iThread].begin(), measuredCosts[iThread].end());
+        }
+        recordCosts(taskName, task, taskCosts);
+        return;
+    }
+#endif
+    if (accumulateCosts || global::blockProfiler().doProfiling()) {
+        std::map<plint,double>& taskCosts = costs[taskName];
+        taskCosts.clear();
+        for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+            double startTime = global::blockProfiler().getTime();
+            task.execute(blocks[iBlock]);
+            taskCosts[blocks[iBlock]] = global::blockProfiler().getTime()-startTime;
+        }
+        recordCosts(taskName, task, taskCosts);
+        return;
+    }
+    for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+        task.execute(blocks[iBlock]);
+    }
+}
+
+std::vector<std::vector<plint> > BlockScheduler::fillQueues (
+        std::map<plint,double> const& taskCosts, std::vector<plint> const& blocks,
+        ThreadAttribution const& attribution, int numThreads ) const
+{
+    std::vector<std::pair<double,plint> > blockCosts(blocks.size());
+    for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+        std::map<plint,double>::const_iterator it = taskCosts.find(blocks[iBlock]);
+        if (it == taskCosts.end()) {
+            // Without a complete cost estimate, stick to the thread attribution.
+            return distributeOverLocalThreads(blocks, attribution, numThreads);
+        }
+        blockCosts[iBlock] = std::make_pair(it->second, blocks[iBlock]);
+    }
+    // Attribute the most expensive blocks first, each one to the least loaded thread.
+    std::stable_sort(blockCosts.begin(), blockCosts.end(), BlockCostIsLarger());
+    std::vector<std::vector<plint> > threadBlocks(numThreads);
+    std::vector<double> threadLoads(numThreads, 0.);
+    for (pluint iBlock=0; iBlock<blockCosts.size(); ++iBlock) {
+        plint threadId = std::min_element(threadLoads.begin(), threadLoads.end()) - threadLoads.begin();
+        threadBlocks[threadId].push_back(blockCosts[iBlock].second);
+        threadLoads[threadId] += blockCosts[iBlock].first;
+    }
+    return threadBlocks;
+}
+
+void BlockScheduler::recordCosts( std::string const& taskName, BlockTask const& task,
+                                  std::map<plint,double> const& taskCosts )
+{
+    for (std::map<plint,double>::const_iterator it=taskCosts.begin(); it!=taskCosts.end(); ++it) {
+        if (accumulateCosts) {
+            accumulatedCosts[it->first] += it->second;
+        }
+        if (global::blockProfiler().doProfiling()) {
+            global::blockProfiler().add( task.getMultiBlockId(), it->first, taskName,
+                                         it->second, task.getNumCells(it->first) );
+        }
+    }
+}
+
+double BlockScheduler::getCost(std::string const& taskName, plint blockId) const {
+    std::map<std::string, std::map<plint,double> >::const_iterator it = costs.find(taskName);
+    if (it != costs.end()) {
+        std::map<plint,double>::const_iterator costIt = it->second.find(blockId);
+        if (costIt != it->second.end()) {
+            return costIt->second;
+        }
+    }
+    return -1.;
+}
+
+void BlockScheduler::resetCosts() {
+    costs.clear();
+}
+
+void BlockScheduler::toggleCostAccumulation(bool accumulate) {
+    accumulateCosts = accumulate;
+}
+
+bool BlockScheduler::isCostAccumulationOn() const {
+    return accumulateCosts;
+}
+
+std::map<plint,double> const& BlockScheduler::getAccumulatedCosts() const {
+    return accumulatedCosts;
+}
+
+void BlockScheduler::resetAccumulatedCosts() {
+    accumulatedCosts.clear();
+}
+
+void BlockScheduler::swap(BlockScheduler& rhs) {
+    costs.swap(rhs.costs);
+    std::swap(accumulateCosts, rhs.accumulateCosts);
+    accumulatedCosts.swap(rhs.accumulatedCosts);
+}
+
+}  // namespace plb
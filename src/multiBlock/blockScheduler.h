@@ -0,0 +1,99 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Execution of tasks on the local blocks of a multi-block by shared-memory
+ * threads, with work stealing -- header file.
+ */
+
+#ifndef BLOCK_SCHEDULER_H
+#define BLOCK_SCHEDULER_H
+
+#include "core/globalDefs.h"
+#include "multiBlock/threadAttribution.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace plb {
+
+/// A piece of work which is executed independently on each local block.
+struct BlockTask {
+    virtual ~BlockTask() { }
+    virtual void execute(plint blockId) =0;
+    /// Id of the multi-block to which the blocks belong, for the block profiler.
+    virtual id_t getMultiBlockId() const =0;
+    /// Number of cells updated on a block, for the block profiler.
+    virtual plint getNumCells(plint blockId) const =0;
+};
+
+/// Executes BlockTasks on the local blocks with the shared-memory threads of
+///   the current MPI process.
+/** Each thread starts with its own queue of blocks, and when its queue is
+ *  empty, it steals blocks from the end of the queues of the other threads.
+ *  The execution time of each block is measured, and used at the next execution
+ *  of the same task to fill the queues evenly (largest blocks first). As long as
+ *  no costs are known, the queues are filled according to the local thread ids
+ *  of the thread attribution.
+ *
+ *  Without SMP support, or with a single thread, the blocks are executed
+ *  sequentially and no costs are measured, unless the accumulation of the
+ *  costs or the block profiler (see global::BlockProfiler) is switched on.
+ *  The accumulated costs are the execution time of each block summed over
+ *  all tasks, and serve to balance the load among the MPI processes (see
+ *  DynamicLoadBalancer3D).
+ **/
+class BlockScheduler {
+public:
+    BlockScheduler();
+    void execute( std::string const& taskName, std::vector<plint> const& blocks,
+                  ThreadAttribution const& attribution, BlockTask& task );
+    /// Execution time (in seconds) of a block at the last execution of a task,
+    ///   or a negative value if it is unknown.
+    double getCost(std::string const& taskName, plint blockId) const;
+    /// Forget all measured costs, for example after the blocks have changed.
+    void resetCosts();
+    /// Switch on or off the accumulation of the execution time of the blocks.
+    void toggleCostAccumulation(bool accumulate);
+    bool isCostAccumulationOn() const;
+    /// Execution time (in seconds) of each local block, summed over all tasks
+    ///   executed since the accumulation was switched on or reset.
+    std::map<plint,double> const& getAccumulatedCosts() const;
+    void resetAccumulatedCosts();
+    void swap(BlockScheduler& rhs);
+private:
+    std::vector<std::vector<plint> > fillQueues (
+            std::map<plint,double> const& taskCosts, std::vector<plint> const& blocks,
+            ThreadAttribution const& attribution, int numThreads ) const;
+    void recordCosts( std::string const& taskName, BlockTask const& task,
+                      std::map<plint,double> const& taskCosts );
+private:
+    std::map<std::string, std::map<plint,double> > costs;
+    bool accumulateCosts;
+    std::map<plint,double> accumulatedCosts;
+};
+
+}  // namespace plb
+
+#endif  // BLOCK_SCHEDULER_H
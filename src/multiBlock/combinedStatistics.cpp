@@ -26,12 +26,19 @@
  * The CombinedStatistics class -- implementation.
  */
 #include "multiBlock/combinedStatistics.h"
+#include "core/plbDebug.h"
 #include <cmath>
 #include <numeric>
 #include <limits>
 
 namespace plb {
 
+CombinedStatistics::CombinedStatistics()
+{ }
+
+CombinedStatistics::CombinedStatistics(CombinedStatistics const& rhs)
+{ }
+
 CombinedStatistics::~CombinedStatistics()
 { }
 
@@ -138,6 +145,137 @@ void CombinedStatistics::combine (
         averageObservables, sumObservables, maxObservables, intSumObservables, 0 );
 }
 
+void CombinedStatistics::combine (
+            std::vector<std::vector<BlockStatistics const*> >& individualStatistics,
+            std::vector<BlockStatistics*> const& results ) const
+{
+    PLB_PRECONDITION( individualStatistics.size() == results.size() );
+    // The local statistics of all sets are concatenated, and reduced together.
+    std::vector<double> averageObservables, sumWeights, sumObservables, maxObservables;
+    std::vector<plint> intSumObservables;
+    for (pluint iSet=0; iSet<results.size(); ++iSet) {
+        std::vector<double> setAverages(results[iSet]->getAverageVect().size());
+        std::vector<double> setWeights(results[iSet]->getAverageVect().size());
+        computeLocalAverage(individualStatistics[iSet], setAverages, setWeights);
+        averageObservables.insert(averageObservables.end(), setAverages.begin(), setAverages.end());
+        sumWeights.insert(sumWeights.end(), setWeights.begin(), setWeights.end());
+
+        std::vector<double> setSums(results[iSet]->getSumVect().size());
+        computeLocalSum(individualStatistics[iSet], setSums);
+        sumObservables.insert(sumObservables.end(), setSums.begin(), setSums.end());
+
+        std::vector<double> setMaxima(results[iSet]->getMaxVect().size());
+        computeLocalMax(individualStatistics[iSet], setMaxima);
+        maxObservables.insert(maxObservables.end(), setMaxima.begin(), setMaxima.end());
+
+        std::vector<plint> setIntSums(results[iSet]->getIntSumVect().size());
+        computeLocalIntSum(individualStatistics[iSet], setIntSums);
+        intSumObservables.insert(intSumObservables.end(), setIntSums.begin(), setIntSums.end());
+    }
+
+    this->reduceStatistics (
+            averageObservables, sumWeights,
+            sumObservables,
+            maxObservables,
+            intSumObservables );
+
+    pluint averagePos=0, sumPos=0, maxPos=0, intSumPos=0;
+    for (pluint iSet=0; iSet<results.size(); ++iSet) {
+        pluint numAverages = results[iSet]->getAverageVect().size();
+        pluint numSums     = results[iSet]->getSumVect().size();
+        pluint numMaxima   = results[iSet]->getMaxVect().size();
+        pluint numIntSums  = results[iSet]->getIntSumVect().size();
+        results[iSet]->evaluate (
+            std::vector<double>(averageObservables.begin()+averagePos,
+                                averageObservables.begin()+averagePos+numAverages),
+            std::vector<double>(sumObservables.begin()+sumPos,
+                                sumObservables.begin()+sumPos+numSums),
+            std::vector<double>(maxObservables.begin()+maxPos,
+                                maxObservables.begin()+maxPos+numMaxima),
+            std::vector<plint>(intSumObservables.begin()+intSumPos,
+                               intSumObservables.begin()+intSumPos+numIntSums), 0 );
+        averagePos += numAverages;
+        sumPos     += numSums;
+        maxPos     += numMaxima;
+        intSumPos  += numIntSums;
+    }
+}
+
+void CombinedStatistics::startCombination (
+            std::vector<BlockStatistics const*>& individualStatistics,
+            std::vector<BlockStatistics*> const& results )
+{
+    PLB_PRECONDITION( !results.empty() );
+    completeCombination();
+    BlockStatistics& reference = *results[0];
+
+    pendingAverages.resize(reference.getAverageVect().size());
+    pendingWeights.resize(reference.getAverageVect().size());
+    computeLocalAverage(individualStatistics, pendingAverages, pendingWeights);
+
+    pendingSums.resize(reference.getSumVect().size());
+    computeLocalSum(individualStatistics, pendingSums);
+
+    pendingMaxima.resize(reference.getMaxVect().size());
+    computeLocalMax(individualStatistics, pendingMaxima);
+
+    pendingIntSums.resize(reference.getIntSumVect().size());
+    computeLocalIntSum(individualStatistics, pendingIntSums);
+
+    this->startReduction (
+            pendingAverages, pendingWeights,
+            pendingSums,
+            pendingMaxima,
+            pendingIntSums );
+
+    // The running statistics are reset now, because they may be used
+    //   again before the reduction is completed.
+    for (pluint iResult=0; iResult<results.size(); ++iResult) {
+        results[iResult]->evaluate (
+            pendingAverages, pendingSums, pendingMaxima, pendingIntSums, 0 );
+    }
+    pendingResults = results;
+}
+
+bool CombinedStatistics::completeCombination() {
+    if (pendingResults.empty()) {
+        return false;
+    }
+    this->completeReduction (
+            pendingAverages, pendingWeights,
+            pendingSums,
+            pendingMaxima,
+            pendingIntSums );
+    for (pluint iResult=0; iResult<pendingResults.size(); ++iResult) {
+        pendingResults[iResult]->setPublicStatistics (
+            pendingAverages, pendingSums, pendingMaxima, pendingIntSums );
+    }
+    pendingResults.clear();
+    return true;
+}
+
+void CombinedStatistics::startReduction (
+            std::vector<double>& averageObservables,
+            std::vector<double>& sumWeights,
+            std::vector<double>& sumObservables,
+            std::vector<double>& maxObservables,
+            std::vector<plint>& intSumObservables )
+{
+    this->reduceStatistics (
+            averageObservables, sumWeights,
+            sumObservables,
+            maxObservables,
+            intSumObservables );
+}
+
+void CombinedStatistics::completeReduction (
+            std::vector<double>& averageObservables,
+            std::vector<double>& sumWeights,
+            std::vector<double>& sumObservables,
+            std::vector<double>& maxObservables,
+            std::vector<plint>& intSumObservables )
+{ }
+
 
 SerialCombinedStatistics* SerialCombinedStatistics::clone() const {
     return new SerialCombinedStatistics(*this);
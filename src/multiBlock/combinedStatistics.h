@@ -36,11 +36,32 @@ namespace plb {
 
 class CombinedStatistics {
 public:
+    CombinedStatistics();
+    /// A pending combination of rhs is not copied.
+    CombinedStatistics(CombinedStatistics const& rhs);
     virtual ~CombinedStatistics();
     virtual CombinedStatistics* clone() const =0;
     void combine (
             std::vector<BlockStatistics const*>& individualStatistics,
             BlockStatistics& result ) const;
+    /// Combine several sets of statistics at once, with a single reduction
+    ///   across processes. The set individualStatistics[i] is combined into
+    ///   results[i].
+    void combine (
+            std::vector<std::vector<BlockStatistics const*> >& individualStatistics,
+            std::vector<BlockStatistics*> const& results ) const;
+    /// Split-phase version of combine().
+    /** The running statistics of the results are reset right away, and the
+     *  cross-process reduction is started. The public statistics of the
+     *  results are only attributed in completeCombination(). The results
+     *  must remain in place until then.
+     **/
+    void startCombination (
+            std::vector<BlockStatistics const*>& individualStatistics,
+            std::vector<BlockStatistics*> const& results );
+    /// Complete the pending combination, if any. Returns false if there
+    ///   was none.
+    bool completeCombination();
 protected:
     virtual void reduceStatistics (
             std::vector<double>& averageObservables,
@@ -48,6 +69,22 @@ protected:
             std::vector<double>& sumObservables,
             std::vector<double>& maxObservables,
             std::vector<plint>& intSumObservables ) const =0;
+    /// Start a non-blocking reduction of the observables. The arguments
+    ///   remain in place until completeReduction() is called. The default
+    ///   implementation executes reduceStatistics().
+    virtual void startReduction (
+            std::vector<double>& averageObservables,
+            std::vector<double>& sumWeights,
+            std::vector<double>& sumObservables,
+            std::vector<double>& maxObservables,
+            std::vector<plint>& intSumObservables );
+    /// Complete the reduction started with startReduction().
+    virtual void completeReduction (
+            std::vector<double>& averageObservables,
+            std::vector<double>& sumWeights,
+            std::vector<double>& sumObservables,
+            std::vector<double>& maxObservables,
+            std::vector<plint>& intSumObservables );
 private:
     void computeLocalAverage (
             std::vector<BlockStatistics const*> const& individualStatistics,
@@ -62,6 +99,10 @@ private:
     void computeLocalIntSum (
             std::vector<BlockStatistics const*> const& individualStatistics,
             std::vector<plint>& intSumObservables ) const;
+private:
+    std::vector<double> pendingAverages, pendingWeights, pendingSums, pendingMaxima;
+    std::vector<plint> pendingIntSums;
+    std::vector<BlockStatistics*> pendingResults;
 };
 
 class SerialCombinedStatistics : public CombinedStatistics {
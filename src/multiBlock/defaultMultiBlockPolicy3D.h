@@ -30,6 +30,7 @@
 
 #include "core/globalDefs.h"
 #include "parallelism/mpiManager.h"
+#include "parallelism/smpManager.h"
 #include "multiBlock/serialBlockCommunicator3D.h"
 #include "parallelism/parallelBlockCommunicator3D.h"
 #include "multiBlock/combinedStatistics.h"
@@ -118,17 +119,23 @@ public:
     }
 
     MultiBlockManagement3D getMultiBlockManagement(Box3D const& domain, plint envelopeWidth) {
-        return MultiBlockManagement3D (
-                createRegularDistribution3D(domain, numProcesses),
-                getThreadAttribution(),
-                envelopeWidth );
+        SparseBlockStructure3D blockStructure =
+            createRegularDistribution3D(domain, numProcesses);
+        ThreadAttribution* attribution =
+            topologyAwarePlacement && global::mpi().getSize()>1 ?
+                createTopologyAwareAttribution(blockStructure, numProcesses) :
+                getThreadAttribution();
+        MultiBlockManagement3D management (
+                blockStructure, attribution, envelopeWidth );
+        // On request, each MPI process gets one block per shared-memory thread.
+        if (splitBlocksForThreads && global::smp().getNumThreads()>1) {
+            return splitForThreads(management, global::smp().getNumThreads());
+        }
+        return management;
     }
 
     MultiBlockManagement3D getMultiBlockManagement(plint nx, plint ny, plint nz, plint envelopeWidth) {
-        return MultiBlockManagement3D (
-                createRegularDistribution3D(nx,ny,nz, numProcesses),
-                getThreadAttribution(),
-                envelopeWidth );
+        return getMultiBlockManagement(Box3D(0,nx-1, 0,ny-1, 0,nz-1), envelopeWidth);
     }
 
     void setNumGridPoints(plint numGridPoints_) {
@@ -150,11 +157,43 @@ public:
     int getNumProcesses() const {
         return numProcesses;
     }
+
+    /// Memory layout of the atomic-blocks of subsequently created multi-block lattices.
+    void setLatticeStorage(LatticeStorage::StorageT latticeStorage_) {
+        latticeStorage = latticeStorage_;
+    }
+
+    LatticeStorage::StorageT getLatticeStorage() const {
+        return latticeStorage;
+    }
+
+    /// Place neighboring blocks of subsequently created multi-blocks on
+    ///   processes of the same node (default: false).
+    void toggleTopologyAwarePlacement(bool topologyAwarePlacement_) {
+        topologyAwarePlacement = topologyAwarePlacement_;
+    }
+
+    bool usesTopologyAwarePlacement() const {
+        return topologyAwarePlacement;
+    }
+
+    /// Split the block of each MPI process of subsequently created multi-blocks
+    ///   into one block per shared-memory thread (default: false).
+    void toggleThreadSplitting(bool splitBlocksForThreads_) {
+        splitBlocksForThreads = splitBlocksForThreads_;
+    }
+
+    bool usesThreadSplitting() const {
+        return splitBlocksForThreads;
+    }
 private:
     DefaultMultiBlockPolicy3D()
         : numProcesses(global::mpi().getSize()),
           numGridPointsSpecified(false),
-          useBlockingCommunication(false)
+          useBlockingCommunication(false),
+          latticeStorage(LatticeStorage::cellArray),
+          topologyAwarePlacement(false),
+          splitBlocksForThreads(false)
     {
         numGridPoints = numProcesses;
     }
@@ -164,6 +203,9 @@ private:
     plint numGridPoints;
     bool numGridPointsSpecified;
     bool useBlockingCommunication;
+    LatticeStorage::StorageT latticeStorage;
+    bool topologyAwarePlacement;
+    bool splitBlocksForThreads;
 };
 
 inline DefaultMultiBlockPolicy3D& defaultMultiBlockPolicy3D() {
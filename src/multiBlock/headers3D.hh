@@ -34,4 +34,5 @@
 #include "multiBlock/reductiveMultiDataProcessorWrapper3D.hh"
 #include "multiBlock/nonLocalTransfer3D.hh"
 #include "multiBlock/multiBlockGenerator3D.hh"
+#include "multiBlock/redistribution3D.hh"
 
@@ -87,6 +87,15 @@ inline bool operator<(Overlap3D const& overlap1, Overlap3D const& overlap2)
                     (overlap1.getOriginalCoordinates() < overlap2.getOriginalCoordinates()) ) ) );
 }
 
+/// Two overlaps are equal if they relate the same regions of the same blocks.
+inline bool operator==(Overlap3D const& overlap1, Overlap3D const& overlap2)
+{
+    return overlap1.getOriginalId() == overlap2.getOriginalId() &&
+           overlap1.getOverlapId() == overlap2.getOverlapId() &&
+           overlap1.getOriginalCoordinates() == overlap2.getOriginalCoordinates() &&
+           overlap1.getOverlapCoordinates() == overlap2.getOverlapCoordinates();
+}
+
 /// This structure holds both overlap information and orientation of the boundary.
 /** In case of periodic overlaps, it is important to know the orientation of the
  *  boundary, additionally to the coordinates of the overlap region. This is
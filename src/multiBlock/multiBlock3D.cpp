@@ -278,12 +278,13 @@ MultiBlock3D::MultiBlock3D(MultiBlock3D const& rhs)
       maxProcessorLevel(rhs.maxProcessorLevel),
       storedProcessors(rhs.storedProcessors),
       blockCommunicator(rhs.blockCommunicator->clone()),
-      internalStatistics(rhs.internalStatistics),
+      internalStatistics(rhs.getInternalStatistics()),
       combinedStatistics(rhs.combinedStatistics -> clone()),
       statSubscriber(*this),
       statisticsOn(rhs.statisticsOn),
       periodicitySwitch(*this, rhs.periodicitySwitch),
-      internalModifT(rhs.internalModifT)
+      internalModifT(rhs.internalModifT),
+      blockScheduler(rhs.blockScheduler)
 { 
     id = multiBlockRegistration3D().announce(*this);
 }
@@ -304,6 +305,8 @@ MultiBlock3D::MultiBlock3D(MultiBlock3D const& rhs, Box3D subDomain, bool crop)
 }
 
 void MultiBlock3D::swap(MultiBlock3D& rhs) {
+    completeStatistics();
+    rhs.completeStatistics();
     multiBlockManagement.swap(rhs.multiBlockManagement);
     multiBlocksChangedByManualProcessors.swap(rhs.multiBlocksChangedByManualProcessors);
     multiBlocksChangedByAutomaticProcessors.swap(rhs.multiBlocksChangedByAutomaticProcessors);
@@ -315,9 +318,42 @@ void MultiBlock3D::swap(MultiBlock3D& rhs) {
     std::swap(statisticsOn, rhs.statisticsOn);
     std::swap(periodicitySwitch, rhs.periodicitySwitch);
     std::swap(internalModifT, rhs.internalModifT);
+    blockScheduler.swap(rhs.blockScheduler);
+}
+
+void MultiBlock3D::migrate(MultiBlockManagement3D const& newManagement) {
+    throw PlbLogicException("The multi-block "+getBlockName()+" cannot be migrated to a new distribution.");
+}
+
+void MultiBlock3D::adoptDistribution(MultiBlock3D& rhs) {
+    completeStatistics();
+    rhs.completeStatistics();
+    multiBlockManagement.swap(rhs.multiBlockManagement);
+    std::swap(blockCommunicator, rhs.blockCommunicator);
+    // The internal processors are attached to the former atomic-blocks, and are
+    //   replaced by the ones of rhs (that is, by none).
+    multiBlocksChangedByManualProcessors.swap(rhs.multiBlocksChangedByManualProcessors);
+    multiBlocksChangedByAutomaticProcessors.swap(rhs.multiBlocksChangedByAutomaticProcessors);
+    std::swap(maxProcessorLevel, rhs.maxProcessorLevel);
+    storedProcessors.swap(rhs.storedProcessors);
+    // The measured costs refer to the former local blocks.
+    blockScheduler.resetCosts();
+    blockScheduler.resetAccumulatedCosts();
+    // The new atomic-blocks must offer the statistics subscribed so far.
+    std::vector<plint> const& blocks = getLocalInfo().getBlocks();
+    for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+        BlockStatistics statistics(internalStatistics);
+        statistics.evaluate();
+        getComponent(blocks[iBlock]).getInternalStatistics().swap(statistics);
+    }
+    // The content of the blocks has been transferred without their envelopes.
+    signalPeriodicity();
+    duplicateOverlaps(modif::dataStructure);
 }
 
 MultiBlock3D::~MultiBlock3D() {
+    // A pending reduction of the statistics is completed by the destructor of
+    //   combinedStatistics: the components may already be destroyed at this point.
     delete blockCommunicator;
     delete combinedStatistics;
     multiBlockRegistration3D().release(*this);
@@ -363,11 +399,21 @@ SparseBlockStructure3D const& MultiBlock3D::getSparseBlockStructure() const {
     return multiBlockManagement.getSparseBlockStructure();
 }
 
+BlockScheduler& MultiBlock3D::getBlockScheduler() {
+    return blockScheduler;
+}
+
+BlockScheduler const& MultiBlock3D::getBlockScheduler() const {
+    return blockScheduler;
+}
+
 BlockStatistics& MultiBlock3D::getInternalStatistics() {
+    completeStatistics();
     return internalStatistics;
 }
 
 BlockStatistics const& MultiBlock3D::getInternalStatistics() const {
+    completeStatistics();
     return internalStatistics;
 }
 
@@ -387,6 +433,26 @@ void MultiBlock3D::duplicateOverlaps(modif::ModifT whichData) {
     this->getBlockCommunicator().duplicateOverlaps(*this, whichData);
 }
 
+void MultiBlock3D::startDuplicateOverlaps(modif::ModifT whichData) {
+    this->getBlockCommunicator().startDuplicateOverlaps(*this, whichData);
+}
+
+void MultiBlock3D::completeDuplicateOverlaps(modif::ModifT whichData) {
+    this->getBlockCommunicator().completeDuplicateOverlaps(*this, whichData);
+}
+
+void MultiBlock3D::startDuplicateIncoming() {
+    this->getBlockCommunicator().startDuplicateIncoming(*this);
+}
+
+void MultiBlock3D::completeDuplicateIncoming() {
+    this->getBlockCommunicator().completeDuplicateIncoming(*this);
+}
+
+bool MultiBlock3D::hasInternalProcessors() const {
+    return maxProcessorLevel>=0;
+}
+
 void MultiBlock3D::signalPeriodicity() {
     getBlockCommunicator().signalPeriodicity();
 }
@@ -417,6 +483,7 @@ void MultiBlock3D::getDynamicsDict(Box3D domain, std::map<std::string,int>& dict
 }
 
 void MultiBlock3D::evaluateStatistics() {
+    completeStatistics();
     std::vector<plint> const& blocks = getLocalInfo().getBlocks();
     for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
         plint blockId = blocks[iBlock];
@@ -434,14 +501,20 @@ void MultiBlock3D::reduceStatistics() {
         individualStatistics.push_back(&getComponent(blockId).getInternalStatistics());
     }
 
-    // Execute reduction operation on all individual statistics and store result into
-    //   statistics of current MultiBlock.
-    combinedStatistics -> combine(individualStatistics, this->getInternalStatistics());
-    // Copy result to each individual statistics
+    // Start the reduction operation on all individual statistics. The result is
+    //   stored into the statistics of the current MultiBlock and of each individual
+    //   block once the reduction is completed, in completeStatistics().
+    std::vector<BlockStatistics*> results;
+    results.push_back(&internalStatistics);
     for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
         plint blockId = blocks[iBlock];
-        (getComponent(blockId).getInternalStatistics()) = (this->getInternalStatistics());
+        results.push_back(&getComponent(blockId).getInternalStatistics());
     }
+    combinedStatistics -> startCombination(individualStatistics, results);
+}
+
+void MultiBlock3D::completeStatistics() const {
+    combinedStatistics -> completeCombination();
 }
 
 void MultiBlock3D::toggleInternalStatistics(bool statisticsOn_) {
@@ -490,12 +563,29 @@ void MultiBlock3D::executeInternalProcessors() {
     global::profiler().stop("dataProcessor");
 }
 
+InternalProcessorsTask3D::InternalProcessorsTask3D(MultiBlock3D& multiBlock_, plint level_)
+    : multiBlock(multiBlock_),
+      level(level_)
+{ }
+
+void InternalProcessorsTask3D::execute(plint blockId) {
+    multiBlock.getComponent(blockId).executeInternalProcessors(level);
+}
+
+id_t InternalProcessorsTask3D::getMultiBlockId() const {
+    return multiBlock.getId();
+}
+
+plint InternalProcessorsTask3D::getNumCells(plint blockId) const {
+    return multiBlock.getMultiBlockManagement().getBulk(blockId).nCells();
+}
+
 void MultiBlock3D::executeInternalProcessors(plint level, bool communicate) {
-    std::vector<plint> const& blocks = getLocalInfo().getBlocks();
-    for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
-        plint blockId = blocks[iBlock];
-        getComponent(blockId).executeInternalProcessors(level);
-    }
+    completeStatistics();
+    InternalProcessorsTask3D task(*this, level);
+    blockScheduler.execute( "internalProcessors"+util::val2str(level),
+                            getLocalInfo().getBlocks(),
+                            getMultiBlockManagement().getThreadAttribution(), task );
     if (communicate) {
         duplicateOverlapsInModifiedMultiBlocks(level);
     }
@@ -599,35 +689,86 @@ void MultiBlock3D::duplicateOverlapsInModifiedMultiBlocks(plint level) {
 void MultiBlock3D::duplicateOverlapsInModifiedMultiBlocks (
         std::vector<BlockAndModif>& multiBlocks )
 {
+    std::vector<MultiBlock3D*> updatedBlocks(multiBlocks.size());
+    std::vector<modif::ModifT> typeOfModification(multiBlocks.size());
     for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
-        multiBlocks[iBlock].first->duplicateOverlaps (
-                multiBlocks[iBlock].second );
+        updatedBlocks[iBlock] = multiBlocks[iBlock].first;
+        typeOfModification[iBlock] = multiBlocks[iBlock].second;
     }
+    plb::duplicateOverlaps(updatedBlocks, typeOfModification);
 }
 
 
 void MultiBlock3D::duplicateOverlapsAtLevelZero (
         std::vector<BlockAndModif>& multiBlocks )
 {
+    std::vector<MultiBlock3D*> updatedBlocks;
+    std::vector<modif::ModifT> typeOfModification;
     bool treatedThis = false;
     for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
         MultiBlock3D* modifiedBlock = multiBlocks[iBlock].first;
         modif::ModifT modificationType = multiBlocks[iBlock].second;
+        updatedBlocks.push_back(modifiedBlock);
         if (modifiedBlock==this) {
             treatedThis = true;
             // If it's the current multi-block we are treating, make sure
             //   type of modification is equal to internalModifT or stronger.
-            this->duplicateOverlaps(combine(modificationType, internalModifT));
+            typeOfModification.push_back(combine(modificationType, internalModifT));
         }
         else {
-            modifiedBlock->duplicateOverlaps(modificationType);
+            typeOfModification.push_back(modificationType);
         }
     }
     // If current multi-block has not already been treated, duplicate
     //   overlaps explicitly (because overlaps are expected to be duplicated
     //   in any case at level 0).
     if (!treatedThis) {
-        this->duplicateOverlaps(internalModifT);
+        updatedBlocks.push_back(this);
+        typeOfModification.push_back(internalModifT);
+    }
+    plb::duplicateOverlaps(updatedBlocks, typeOfModification);
+}
+
+void duplicateOverlaps( std::vector<MultiBlock3D*> const& multiBlocks,
+                        std::vector<modif::ModifT> const& whichData )
+{
+    PLB_PRECONDITION( multiBlocks.size() == whichData.size() );
+    // Group the multi-blocks by distribution, in the order of their first
+    //   appearance, which is the same on all processes.
+    std::vector<std::vector<MultiBlock3D*> > groups;
+    std::vector<std::vector<modif::ModifT> > groupModifs;
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        MultiBlock3D* multiBlock = multiBlocks[iBlock];
+        id_t distribution = multiBlock->getMultiBlockManagement().getDistributionId();
+        pluint iGroup=0;
+        while ( iGroup<groups.size() &&
+                groups[iGroup][0]->getMultiBlockManagement().getDistributionId() != distribution )
+        {
+            ++iGroup;
+        }
+        if (iGroup==groups.size()) {
+            groups.push_back(std::vector<MultiBlock3D*>());
+            groupModifs.push_back(std::vector<modif::ModifT>());
+        }
+        std::vector<MultiBlock3D*>& group = groups[iGroup];
+        pluint iMember = std::find(group.begin(), group.end(), multiBlock) - group.begin();
+        if (iMember<group.size()) {
+            groupModifs[iGroup][iMember] = combine(groupModifs[iGroup][iMember], whichData[iBlock]);
+        }
+        else {
+            group.push_back(multiBlock);
+            groupModifs[iGroup].push_back(whichData[iBlock]);
+        }
+    }
+    for (pluint iGroup=0; iGroup<groups.size(); ++iGroup) {
+        std::vector<MultiBlock3D*> const& group = groups[iGroup];
+        if ( group.size()==1 ||
+             !group[0]->getBlockCommunicator().duplicateGroupOverlaps(group, groupModifs[iGroup]) )
+        {
+            for (pluint iMember=0; iMember<group.size(); ++iMember) {
+                group[iMember]->duplicateOverlaps(groupModifs[iGroup][iMember]);
+            }
+        }
     }
 }
 
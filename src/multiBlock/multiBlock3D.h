@@ -35,6 +35,7 @@
 #include "multiBlock/multiBlockManagement3D.h"
 #include "multiBlock/blockCommunicator3D.h"
 #include "multiBlock/combinedStatistics.h"
+#include "multiBlock/blockScheduler.h"
 #include "atomicBlock/dataProcessor3D.h"
 #include "core/block3D.h"
 #include "core/blockStatistics.h"
@@ -125,6 +126,14 @@ public:
     virtual int getStaticId() const =0;
     virtual MultiBlock3D* clone() const =0;
     virtual MultiBlock3D* clone(MultiBlockManagement3D const& newManagement) const =0;
+    /// Move the content of the multi-block to a new distribution of the same blocks.
+    /** The multi-block keeps its identity, statistics and periodicity, but loses
+     *  its internal data processors: use migrateMultiBlocks() to migrate a group
+     *  of coupled multi-blocks together with their processors. By default, a
+     *  PlbLogicException is thrown, for the multi-blocks whose content cannot
+     *  be transferred between processes. Collective on all processes.
+     **/
+    virtual void migrate(MultiBlockManagement3D const& newManagement);
     /// Initialize block content by executing internal processors once.
     void initialize();
 public:
@@ -161,7 +170,13 @@ public:
     /// Get object to subscribe new internal statistics.
     StatSubscriber& internalStatSubscription();
     /// Copy running statistics to public statistics, and reset running stats.
+    /** The reduction across processes is only started here; it is completed
+     *  when the statistics are accessed, or before the next data processors
+     *  or statistics evaluation.
+     **/
     void evaluateStatistics();
+    /// Complete the reduction started by evaluateStatistics(), if any.
+    void completeStatistics() const;
     CombinedStatistics const& getCombinedStatistics() const;
     void toggleInternalStatistics(bool statisticsOn_);
     bool isInternalStatisticsOn() const;
@@ -189,12 +204,25 @@ private:
     void duplicateOverlapsInModifiedMultiBlocks(std::vector<BlockAndModif>& multiBlocks);
     void duplicateOverlapsAtLevelZero(std::vector<BlockAndModif>& multiBlocks);
     void reduceStatistics();
+protected:
+    /// Take over the distribution of rhs, which is a clone of this multi-block
+    ///   (without processors) on a new block-management, once the atomic-blocks
+    ///   have been exchanged with it. Used to implement migrate().
+    void adoptDistribution(MultiBlock3D& rhs);
 public:
     BlockCommunicator3D const& getBlockCommunicator() const;
     virtual void copyReceive (
                 MultiBlock3D const& fromBlock, Box3D const& fromDomain,
                 Box3D const& toDomain, modif::ModifT whichData=modif::dataStructure ) =0;
     void duplicateOverlaps(modif::ModifT whichData);
+    /// Split-phase version of duplicateOverlaps() (see BlockCommunicator3D).
+    void startDuplicateOverlaps(modif::ModifT whichData);
+    void completeDuplicateOverlaps(modif::ModifT whichData);
+    /// Update of the envelope with the static data streamed into it (see BlockCommunicator3D).
+    void startDuplicateIncoming();
+    void completeDuplicateIncoming();
+    /// Whether there are internal dataProcessors at positive or zero level.
+    bool hasInternalProcessors() const;
     void signalPeriodicity();
     virtual DataSerializer* getBlockSerializer (
             Box3D const& domain, IndexOrdering::OrderingT ordering ) const;
@@ -209,6 +237,9 @@ public:
     /// Get one or two string identifiers for the template parameters of the block.
     ///   E.g. "double" and "d3q19"
     virtual std::vector<std::string> getTypeInfo() const =0;
+    /// Scheduler which distributes the local blocks among the shared-memory threads.
+    BlockScheduler& getBlockScheduler();
+    BlockScheduler const& getBlockScheduler() const;
 private:
     MultiBlockManagement3D multiBlockManagement;
     /// List of MultiBlocks which are modified by the manual processors and require
@@ -226,9 +257,30 @@ private:
     bool statisticsOn;
     PeriodicitySwitch3D periodicitySwitch;
     modif::ModifT internalModifT;
+    BlockScheduler blockScheduler;
     id_t id;
 };
 
+/// Execution of the internal processors of a given level on a local block.
+class InternalProcessorsTask3D : public BlockTask {
+public:
+    InternalProcessorsTask3D(MultiBlock3D& multiBlock_, plint level_);
+    virtual void execute(plint blockId);
+    virtual id_t getMultiBlockId() const;
+    /// The cells of the bulk of the block.
+    virtual plint getNumCells(plint blockId) const;
+private:
+    MultiBlock3D& multiBlock;
+    plint level;
+};
+
+/// Fill the overlaps of several multi-blocks.
+/** The multi-blocks which have the same distribution are updated together, with
+ *  a single message per pair of processes (see BlockCommunicator3D::duplicateGroupOverlaps()).
+ **/
+void duplicateOverlaps( std::vector<MultiBlock3D*> const& multiBlocks,
+                        std::vector<modif::ModifT> const& whichData );
+
 class MultiBlockRegistration3D {
 public:
     id_t announce(MultiBlock3D& block);
@@ -40,6 +40,7 @@
 namespace plb {
 
 template<typename T, template<typename U> class Descriptor> class BlockLattice3D;
+template<typename T, template<typename U> class Descriptor> class CollideAndStreamTask3D;
 
 
 template<typename T, template<typename U> class Descriptor>
@@ -78,12 +79,21 @@ public:
                         CombinedStatistics* combinedStatistics_,
                         MultiCellAccess3D<T,Descriptor>* multiCellAccess_,
                         Dynamics<T,Descriptor>* backgroundDynamics_);
+    /// Same as above, with an explicit choice of the memory layout of the
+    ///   atomic-blocks, instead of the one of the default policy.
+    MultiBlockLattice3D(MultiBlockManagement3D const& multiBlockManagement,
+                        BlockCommunicator3D* blockCommunicator_,
+                        CombinedStatistics* combinedStatistics_,
+                        MultiCellAccess3D<T,Descriptor>* multiCellAccess_,
+                        Dynamics<T,Descriptor>* backgroundDynamics_,
+                        LatticeStorage::StorageT latticeStorage_);
     MultiBlockLattice3D(plint nx, plint ny, plint nz, Dynamics<T,Descriptor>* backgroundDynamics_);
     ~MultiBlockLattice3D();
     MultiBlockLattice3D(MultiBlockLattice3D<T,Descriptor> const& rhs);
     MultiBlockLattice3D(MultiBlock3D const& rhs);
     MultiBlockLattice3D<T,Descriptor>* clone() const;
     MultiBlockLattice3D<T,Descriptor>* clone(MultiBlockManagement3D const& newManagement) const;
+    virtual void migrate(MultiBlockManagement3D const& newManagement);
     /// Extract sub-domain from rhs and construct a multi-block-lattice with the same
     ///  data distribution and policy-classes; but the data itself and the data-processors
     ///  are not copied. MultiCellAccess takes default value.
@@ -96,6 +106,19 @@ public:
     MultiBlockLattice3D<T,Descriptor>& operator=(MultiBlockLattice3D<T,Descriptor> const& rhs);
 
     Dynamics<T,Descriptor> const& getBackgroundDynamics() const;
+    /// Memory layout of the atomic-blocks.
+    LatticeStorage::StorageT getLatticeStorage() const;
+    /// Update the envelopes after collideAndStream() with the populations which
+    ///   stream into them only (for D3Q19, 5 of the 19 populations on a face).
+    /** The other populations of the envelope are computed locally, which gives the
+     *  same result as long as the envelope is only modified by the collision-streaming
+     *  step and by full updates of the envelope (such as the ones which follow the
+     *  execution of a data processor), and as long as the envelopes are covered by
+     *  other blocks or are outside the domain. The external scalars are not updated.
+     *  The selective update is only used if there are no internal data processors.
+     **/
+    void toggleSelectiveEnvelopeUpdate(bool selective);
+    bool usesSelectiveEnvelopeUpdate() const;
     virtual Cell<T,Descriptor>& get(plint iX, plint iY, plint iZ);
     virtual Cell<T,Descriptor> const& get(plint iX, plint iY, plint iZ) const;
     virtual void specifyStatisticsStatus(Box3D domain, bool status);
@@ -128,12 +151,44 @@ private:
     void allocateAndInitialize();
     void eliminateStatisticsInEnvelope();
     Box3D extendPeriodic(Box3D const& box, plint envelopeWidth) const;
+    /// Collision-streaming on the full domain of a local block, including active envelopes.
+    void collideAndStreamComponent(plint blockId);
+    /// Split version of collideAndStreamComponent(): the shell contains the cells
+    ///   which are communicated to other blocks.
+    void collideAndStreamComponentShell(plint blockId);
+    void collideAndStreamComponentInterior(plint blockId);
+    /// Whether the communication of the envelope can be overlapped with the
+    ///   collision-streaming step in the interior of the blocks.
+    bool canOverlapCommunication() const;
+    /// Whether the envelopes can be updated selectively after collideAndStream().
+    bool canUpdateEnvelopeSelectively() const;
 private:
     Dynamics<T,Descriptor>* backgroundDynamics;
     MultiCellAccess3D<T,Descriptor>* multiCellAccess;
+    LatticeStorage::StorageT latticeStorage;
+    bool selectiveEnvelopeUpdate;
     BlockMap blockLattices;
 public:
     static const int staticId;
+friend class CollideAndStreamTask3D<T,Descriptor>;
+};
+
+/// Execution of the collision-streaming step on a local block of a multi-block lattice.
+/** The step is executed on the full block, or, if it is split to overlap
+ *  communication with computations, on the shell or on the interior of the block.
+ */
+template<typename T, template<typename U> class Descriptor>
+class CollideAndStreamTask3D : public BlockTask {
+public:
+    enum PartT { fullBlock, shell, interior };
+public:
+    CollideAndStreamTask3D(MultiBlockLattice3D<T,Descriptor>& lattice_, PartT part_=fullBlock);
+    virtual void execute(plint blockId);
+    virtual id_t getMultiBlockId() const;
+    virtual plint getNumCells(plint blockId) const;
+private:
+    MultiBlockLattice3D<T,Descriptor>& lattice;
+    PartT part;
 };
 
 template<typename T, template<typename U> class Descriptor>
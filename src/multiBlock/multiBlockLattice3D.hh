@@ -38,6 +38,7 @@
 #include "core/multiBlockIdentifiers3D.h"
 #include "core/plbProfiler.h"
 #include "core/dynamicsIdentifiers.h"
+#include "parallelism/mpiManager.h"
 #include "dataProcessors/metaStuffWrapper3D.h"
 #include "coProcessors/coProcessor3D.h"
 #include <algorithm>
@@ -65,7 +66,28 @@ MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D (
         Dynamics<T,Descriptor>* backgroundDynamics_ )
     : MultiBlock3D(multiBlockManagement_, blockCommunicator_, combinedStatistics_ ),
       backgroundDynamics(backgroundDynamics_),
-      multiCellAccess(multiCellAccess_)
+      multiCellAccess(multiCellAccess_),
+      latticeStorage(defaultMultiBlockPolicy3D().getLatticeStorage()),
+      selectiveEnvelopeUpdate(false)
+{
+    allocateAndInitialize();
+    eliminateStatisticsInEnvelope();
+    this->evaluateStatistics(); // Reset statistics to default.
+}
+
+template<typename T, template<typename U> class Descriptor>
+MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D (
+        MultiBlockManagement3D const& multiBlockManagement_,
+        BlockCommunicator3D* blockCommunicator_,
+        CombinedStatistics* combinedStatistics_,
+        MultiCellAccess3D<T,Descriptor>* multiCellAccess_,
+        Dynamics<T,Descriptor>* backgroundDynamics_,
+        LatticeStorage::StorageT latticeStorage_ )
+    : MultiBlock3D(multiBlockManagement_, blockCommunicator_, combinedStatistics_ ),
+      backgroundDynamics(backgroundDynamics_),
+      multiCellAccess(multiCellAccess_),
+      latticeStorage(latticeStorage_),
+      selectiveEnvelopeUpdate(false)
 {
     allocateAndInitialize();
     eliminateStatisticsInEnvelope();
@@ -78,7 +100,9 @@ MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D (
         Dynamics<T,Descriptor>* backgroundDynamics_ )
     : MultiBlock3D(nx,ny,nz,Descriptor<T>::vicinity),
       backgroundDynamics(backgroundDynamics_),
-      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>())
+      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>()),
+      latticeStorage(defaultMultiBlockPolicy3D().getLatticeStorage()),
+      selectiveEnvelopeUpdate(false)
 {
     allocateAndInitialize();
     eliminateStatisticsInEnvelope();
@@ -101,7 +125,9 @@ MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D(MultiBlockLattice3D<T,Des
     : BlockLatticeBase3D<T,Descriptor>(rhs),
       MultiBlock3D(rhs),
       backgroundDynamics(rhs.backgroundDynamics->clone()),
-      multiCellAccess(rhs.multiCellAccess->clone())
+      multiCellAccess(rhs.multiCellAccess->clone()),
+      latticeStorage(rhs.latticeStorage),
+      selectiveEnvelopeUpdate(rhs.selectiveEnvelopeUpdate)
 {
     for ( typename  BlockMap::const_iterator it = rhs.blockLattices.begin();
           it != rhs.blockLattices.end(); ++it )
@@ -115,7 +141,9 @@ MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D(MultiBlock3D const& rhs)
       // Use MultiBlock's sub-domain constructor to avoid that the data-processors are copied
     : MultiBlock3D(rhs, rhs.getBoundingBox(), false),
       backgroundDynamics(new NoDynamics<T,Descriptor>),
-      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>())
+      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>()),
+      latticeStorage(defaultMultiBlockPolicy3D().getLatticeStorage()),
+      selectiveEnvelopeUpdate(false)
 {
     allocateAndInitialize();
     eliminateStatisticsInEnvelope();
@@ -125,7 +153,9 @@ template<typename T, template<typename U> class Descriptor>
 MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D(MultiBlock3D const& rhs, Box3D subDomain, bool crop)
     : MultiBlock3D(rhs, subDomain, crop),
       backgroundDynamics(new NoDynamics<T,Descriptor>),
-      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>())
+      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>()),
+      latticeStorage(defaultMultiBlockPolicy3D().getLatticeStorage()),
+      selectiveEnvelopeUpdate(false)
 {
     allocateAndInitialize();
     eliminateStatisticsInEnvelope();
@@ -137,6 +167,8 @@ void MultiBlockLattice3D<T,Descriptor>::swap(MultiBlockLattice3D<T,Descriptor>&
     MultiBlock3D::swap(rhs);
     std::swap(backgroundDynamics, rhs.backgroundDynamics);
     std::swap(multiCellAccess, rhs.multiCellAccess);
+    std::swap(latticeStorage, rhs.latticeStorage);
+    std::swap(selectiveEnvelopeUpdate, rhs.selectiveEnvelopeUpdate);
     blockLattices.swap(rhs.blockLattices);
 }
 
@@ -166,17 +198,44 @@ MultiBlockLattice3D<T,Descriptor>*
                 this->getBlockCommunicator().clone(),
                 this->getCombinedStatistics().clone(),
                 multiCellAccess->clone(),
-                getBackgroundDynamics().clone() );
+                getBackgroundDynamics().clone(),
+                latticeStorage );
     copy(*this, this->getBoundingBox(), *newLattice, newLattice->getBoundingBox(), modif::dataStructure);
     return newLattice;
 }
 
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::migrate(MultiBlockManagement3D const& newManagement)
+{
+    MultiBlockLattice3D<T,Descriptor>* newLattice = clone(newManagement);
+    blockLattices.swap(newLattice->blockLattices);
+    std::swap(multiCellAccess, newLattice->multiCellAccess);
+    this->adoptDistribution(*newLattice);
+    eliminateStatisticsInEnvelope();
+    delete newLattice;
+}
+
 
 template<typename T, template<typename U> class Descriptor>
 Dynamics<T,Descriptor> const& MultiBlockLattice3D<T,Descriptor>::getBackgroundDynamics() const {
     return *backgroundDynamics;
 }
 
+template<typename T, template<typename U> class Descriptor>
+LatticeStorage::StorageT MultiBlockLattice3D<T,Descriptor>::getLatticeStorage() const {
+    return latticeStorage;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::toggleSelectiveEnvelopeUpdate(bool selective) {
+    selectiveEnvelopeUpdate = selective;
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool MultiBlockLattice3D<T,Descriptor>::usesSelectiveEnvelopeUpdate() const {
+    return selectiveEnvelopeUpdate;
+}
+
 template<typename T, template<typename U> class Descriptor>
 Cell<T,Descriptor>& MultiBlockLattice3D<T,Descriptor>::get(plint iX, plint iY, plint iZ) {
     return multiCellAccess -> getDistributedCell(iX,iY,iZ, this->getMultiBlockManagement(), blockLattices);
@@ -307,6 +366,7 @@ template<typename T, template<typename U> class Descriptor>
 void MultiBlockLattice3D<T,Descriptor>::collideAndStream() {
     global::profiler().start("cycle");
     ThreadAttribution const& threadAttribution=this->getMultiBlockManagement().getThreadAttribution();
+    bool envelopeIsUpdated = false;
     if (threadAttribution.hasCoProcessors()) {
         for ( typename BlockMap::iterator it = blockLattices.begin();
               it != blockLattices.end(); ++it )
@@ -317,28 +377,63 @@ void MultiBlockLattice3D<T,Descriptor>::collideAndStream() {
                  global::defaultCoProcessor3D<T>().collideAndStream(handle);
             }
             else {
-                SmartBulk3D bulk(this->getMultiBlockManagement(), blockId);
-                // CollideAndStream must be applied to full domain,
-                //   including currently active envelopes.
-                Box3D domain = extendPeriodic(bulk.computeNonPeriodicEnvelope(),
-                                              this->getMultiBlockManagement().getEnvelopeWidth());
-                it->second -> collideAndStream( bulk.toLocal(domain) );
+                collideAndStreamComponent(blockId);
             }
         }
     }
+    else if (canOverlapCommunication()) {
+        // The cells which are sent to other processes are computed first.
+        //   Their communication is started, and completed after the
+        //   computation of the interior of the blocks.
+        CollideAndStreamTask3D<T,Descriptor> shellTask (
+                *this, CollideAndStreamTask3D<T,Descriptor>::shell );
+        this->getBlockScheduler().execute( "collideAndStreamShell", this->getLocalInfo().getBlocks(),
+                                           threadAttribution, shellTask );
+        global::profiler().start("dataProcessor");
+        global::profiler().start("envelope-update");
+        if (canUpdateEnvelopeSelectively()) {
+            this->startDuplicateIncoming();
+        }
+        else {
+            this->startDuplicateOverlaps(this->getInternalTypeOfModification());
+        }
+        global::profiler().stop("envelope-update");
+        global::profiler().stop("dataProcessor");
+        CollideAndStreamTask3D<T,Descriptor> interiorTask (
+                *this, CollideAndStreamTask3D<T,Descriptor>::interior );
+        this->getBlockScheduler().execute( "collideAndStreamInterior", this->getLocalInfo().getBlocks(),
+                                           threadAttribution, interiorTask );
+        global::profiler().start("dataProcessor");
+        global::profiler().start("envelope-update");
+        if (canUpdateEnvelopeSelectively()) {
+            this->completeDuplicateIncoming();
+        }
+        else {
+            this->completeDuplicateOverlaps(this->getInternalTypeOfModification());
+        }
+        global::profiler().stop("envelope-update");
+        global::profiler().stop("dataProcessor");
+        envelopeIsUpdated = true;
+    }
     else  {
-        for ( typename BlockMap::iterator it = blockLattices.begin();
-              it != blockLattices.end(); ++it)
-        {
-            SmartBulk3D bulk(this->getMultiBlockManagement(), it->first);
-            // CollideAndStream must be applied to full domain,
-            //   including currently active envelopes.
-            Box3D domain = extendPeriodic(bulk.computeNonPeriodicEnvelope(),
-                                          this->getMultiBlockManagement().getEnvelopeWidth());
-            it->second -> collideAndStream( bulk.toLocal(domain) );
+        // The local blocks are executed by the shared-memory threads
+        //   of this process.
+        CollideAndStreamTask3D<T,Descriptor> task(*this);
+        this->getBlockScheduler().execute( "collideAndStream", this->getLocalInfo().getBlocks(),
+                                           threadAttribution, task );
+        if (canUpdateEnvelopeSelectively()) {
+            global::profiler().start("dataProcessor");
+            global::profiler().start("envelope-update");
+            this->startDuplicateIncoming();
+            this->completeDuplicateIncoming();
+            global::profiler().stop("envelope-update");
+            global::profiler().stop("dataProcessor");
+            envelopeIsUpdated = true;
         }
     }
-    this->executeInternalProcessors();
+    if (!envelopeIsUpdated) {
+        this->executeInternalProcessors();
+    }
     this->evaluateStatistics();
     this->incrementTime();
     if (global::profiler().cyclingIsAutomatic()) {
@@ -347,6 +442,62 @@ void MultiBlockLattice3D<T,Descriptor>::collideAndStream() {
     global::profiler().stop("cycle");
 }
 
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::collideAndStreamComponent(plint blockId) {
+    SmartBulk3D bulk(this->getMultiBlockManagement(), blockId);
+    // CollideAndStream must be applied to full domain,
+    //   including currently active envelopes.
+    Box3D domain = extendPeriodic(bulk.computeNonPeriodicEnvelope(),
+                                  this->getMultiBlockManagement().getEnvelopeWidth());
+    getComponent(blockId).collideAndStream( bulk.toLocal(domain) );
+}
+
+/** The bulk cells which are duplicated in the envelope of other blocks are
+ *  at a distance smaller than twice the envelope width from the border of
+ *  the domain.
+ */
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::collideAndStreamComponentShell(plint blockId) {
+    SmartBulk3D bulk(this->getMultiBlockManagement(), blockId);
+    plint envelopeWidth = this->getMultiBlockManagement().getEnvelopeWidth();
+    Box3D domain = extendPeriodic(bulk.computeNonPeriodicEnvelope(), envelopeWidth);
+    getComponent(blockId).collideAndStreamShell( bulk.toLocal(domain), 2*envelopeWidth );
+}
+
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::collideAndStreamComponentInterior(plint blockId) {
+    SmartBulk3D bulk(this->getMultiBlockManagement(), blockId);
+    plint envelopeWidth = this->getMultiBlockManagement().getEnvelopeWidth();
+    Box3D domain = extendPeriodic(bulk.computeNonPeriodicEnvelope(), envelopeWidth);
+    getComponent(blockId).collideAndStreamInterior( bulk.toLocal(domain), 2*envelopeWidth );
+}
+
+/** The overlap replaces the execution of the internal processors, and is
+ *  therefore only possible if the only work after the collision-streaming
+ *  step is the update of the envelope. It is only worth it with several
+ *  MPI processes.
+ */
+template<typename T, template<typename U> class Descriptor>
+bool MultiBlockLattice3D<T,Descriptor>::canOverlapCommunication() const {
+#ifdef PLB_MPI_PARALLEL
+    return global::mpi().getSize()>1 && !this->hasInternalProcessors() &&
+           this->getMultiBlockManagement().getEnvelopeWidth() >= Descriptor<T>::vicinity;
+#else
+    return false;
+#endif
+}
+
+/** Like the overlap of the communication, the selective update replaces the
+ *  execution of the internal processors. The envelope must be wide enough for
+ *  the populations streamed from the envelope into the bulk to be computed locally.
+ */
+template<typename T, template<typename U> class Descriptor>
+bool MultiBlockLattice3D<T,Descriptor>::canUpdateEnvelopeSelectively() const {
+    return selectiveEnvelopeUpdate && !this->hasInternalProcessors() &&
+           this->getInternalTypeOfModification()==modif::staticVariables &&
+           this->getMultiBlockManagement().getEnvelopeWidth() >= Descriptor<T>::vicinity;
+}
+
 template<typename T, template<typename U> class Descriptor>
 void MultiBlockLattice3D<T,Descriptor>::incrementTime() {
     for ( typename BlockMap::iterator it = blockLattices.begin();
@@ -382,7 +533,7 @@ void MultiBlockLattice3D<T,Descriptor>::allocateAndInitialize()
         BlockLattice3D<T,Descriptor>* newLattice
             = new BlockLattice3D<T,Descriptor> (
                     envelope.getNx(), envelope.getNy(), envelope.getNz(),
-                    backgroundDynamics->clone() );
+                    backgroundDynamics->clone(), latticeStorage );
         newLattice -> setLocation(Dot3D(envelope.x0, envelope.y0, envelope.z0));
         blockLattices[blockId] = newLattice;
     }
@@ -535,6 +686,55 @@ double getStoredMaxVelocity(MultiBlockLattice3D<T,Descriptor> const& blockLattic
                              LatticeStatistics::maxUSqr ) );
 }
 
+////////////////////// Class CollideAndStreamTask3D /////////////////////
+
+template<typename T, template<typename U> class Descriptor>
+CollideAndStreamTask3D<T,Descriptor>::CollideAndStreamTask3D (
+        MultiBlockLattice3D<T,Descriptor>& lattice_, PartT part_ )
+    : lattice(lattice_),
+      part(part_)
+{ }
+
+template<typename T, template<typename U> class Descriptor>
+void CollideAndStreamTask3D<T,Descriptor>::execute(plint blockId) {
+    switch (part) {
+        case shell:
+            lattice.collideAndStreamComponentShell(blockId);
+            break;
+        case interior:
+            lattice.collideAndStreamComponentInterior(blockId);
+            break;
+        default:
+            lattice.collideAndStreamComponent(blockId);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+id_t CollideAndStreamTask3D<T,Descriptor>::getMultiBlockId() const {
+    return lattice.getId();
+}
+
+template<typename T, template<typename U> class Descriptor>
+plint CollideAndStreamTask3D<T,Descriptor>::getNumCells(plint blockId) const {
+    SmartBulk3D bulk(lattice.getMultiBlockManagement(), blockId);
+    plint envelopeWidth = lattice.getMultiBlockManagement().getEnvelopeWidth();
+    Box3D domain = lattice.extendPeriodic(bulk.computeNonPeriodicEnvelope(), envelopeWidth);
+    if (part==fullBlock) {
+        return domain.nCells();
+    }
+    // Same decomposition as in BlockLattice3D::decomposeShell(): if the block is
+    //   too small, the shell covers the full block.
+    static const plint vicinity = Descriptor<T>::vicinity;
+    plint thickness = 2*envelopeWidth + vicinity;
+    plint minExtent = 2*thickness + 2*vicinity;
+    plint interiorCells = 0;
+    if (domain.getNx()>=minExtent && domain.getNy()>=minExtent && domain.getNz()>=minExtent) {
+        interiorCells = (domain.getNx()-2*thickness) * (domain.getNy()-2*thickness) *
+                        (domain.getNz()-2*thickness);
+    }
+    return part==interior ? interiorCells : domain.nCells()-interiorCells;
+}
+
 }  // namespace plb
 
 #endif  // MULTI_BLOCK_LATTICE_3D_HH
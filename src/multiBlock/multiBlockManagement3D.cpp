@@ -34,6 +34,10 @@
 
 namespace plb {
 
+static id_t newDistributionId() {
+    static id_t currentId = 0;
+    return ++currentId;
+}
 
 MultiBlockManagement3D::MultiBlockManagement3D (
         SparseBlockStructure3D const& sparseBlock_,
@@ -43,7 +47,8 @@ MultiBlockManagement3D::MultiBlockManagement3D (
       sparseBlock(sparseBlock_),
       threadAttribution(threadAttribution_),
       localInfo(sparseBlock, getThreadAttribution(), envelopeWidth),
-      refinementLevel(refinementLevel_)
+      refinementLevel(refinementLevel_),
+      distributionId(newDistributionId())
 { }
 
 MultiBlockManagement3D::MultiBlockManagement3D(MultiBlockManagement3D const& rhs)
@@ -51,7 +56,8 @@ MultiBlockManagement3D::MultiBlockManagement3D(MultiBlockManagement3D const& rhs
       sparseBlock(rhs.sparseBlock),
       threadAttribution(rhs.threadAttribution->clone()),
       localInfo(rhs.localInfo),
-      refinementLevel(rhs.refinementLevel)
+      refinementLevel(rhs.refinementLevel),
+      distributionId(rhs.distributionId)
 { }
 
 MultiBlockManagement3D& MultiBlockManagement3D::operator=(MultiBlockManagement3D const& rhs) {
@@ -66,6 +72,7 @@ void MultiBlockManagement3D::swap(MultiBlockManagement3D& rhs) {
     std::swap(threadAttribution, rhs.threadAttribution);
     localInfo.swap(rhs.localInfo);
     std::swap(refinementLevel, rhs.refinementLevel);
+    std::swap(distributionId, rhs.distributionId);
 }
 
 MultiBlockManagement3D::~MultiBlockManagement3D() {
@@ -124,6 +131,7 @@ ThreadAttribution const& MultiBlockManagement3D::getThreadAttribution() const {
 
 void MultiBlockManagement3D::setCoProcessors(std::map<plint,int> const& coProcessors) {
     threadAttribution->setCoProcessors(coProcessors);
+    distributionId = newDistributionId();
 }
 
 bool MultiBlockManagement3D::findInLocalBulk (
@@ -192,6 +200,11 @@ plint MultiBlockManagement3D::getRefinementLevel() const {
 
 void MultiBlockManagement3D::setRefinementLevel(plint newLevel) {
     refinementLevel = newLevel;
+    distributionId = newDistributionId();
+}
+
+id_t MultiBlockManagement3D::getDistributionId() const {
+    return distributionId;
 }
 
 MultiBlockManagement3D scale(MultiBlockManagement3D const& originalManagement, plint relativeLevel)
@@ -374,6 +387,44 @@ MultiBlockManagement3D reparallelize(MultiBlockManagement3D const& management,
             management.getEnvelopeWidth(), management.getRefinementLevel() );
 }
 
+MultiBlockManagement3D splitForThreads(MultiBlockManagement3D const& management, int numThreads)
+{
+    PLB_PRECONDITION( numThreads>0 );
+    SparseBlockStructure3D const& structure = management.getSparseBlockStructure();
+    ThreadAttribution const& attribution = management.getThreadAttribution();
+    SparseBlockStructure3D resultStructure(structure.getBoundingBox());
+    ExplicitThreadAttribution* threadAttribution = new ExplicitThreadAttribution;
+
+    std::map<plint,Box3D> const& bulks = structure.getBulks();
+    std::map<plint,Box3D>::const_iterator it = bulks.begin();
+    for (; it != bulks.end(); ++it) {
+        plint blockId = it->first;
+        Box3D bulk = it->second;
+        plint mpiProcess = attribution.getMpiProcess(blockId);
+        plint minLength = std::min(bulk.getNx(), std::min(bulk.getNy(), bulk.getNz()));
+        if (minLength < numThreads) {
+            plint newId = resultStructure.nextIncrementalId();
+            resultStructure.addBlock(bulk, newId);
+            threadAttribution->addBlock(newId, mpiProcess);
+        }
+        else {
+            SparseBlockStructure3D subStructure =
+                createRegularDistribution3D(bulk, numThreads);
+            std::map<plint,Box3D> const& subBulks = subStructure.getBulks();
+            std::map<plint,Box3D>::const_iterator subIt = subBulks.begin();
+            for (plint iThread=0; subIt != subBulks.end(); ++subIt, ++iThread) {
+                plint newId = resultStructure.nextIncrementalId();
+                resultStructure.addBlock(subIt->second, newId);
+                threadAttribution->addBlock(newId, mpiProcess, iThread);
+            }
+        }
+    }
+
+    return MultiBlockManagement3D (
+            resultStructure, threadAttribution,
+            management.getEnvelopeWidth(), management.getRefinementLevel() );
+}
+
 SmartBulk3D::SmartBulk3D( MultiBlockManagement3D const& management,
                           plint blockId )
     : sparseBlock(management.getSparseBlockStructure()),
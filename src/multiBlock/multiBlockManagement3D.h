@@ -68,12 +68,18 @@ public:
             std::vector<plint>& foundZ ) const;
     plint getRefinementLevel() const;
     void setRefinementLevel(plint newLevel);
+    /// Identifier of the distribution of the blocks. A new identifier is
+    ///   generated when a block-management is created or modified, and is
+    ///   kept by its copies. It is used to detect that a communication
+    ///   pattern computed for a block-management is still valid.
+    id_t getDistributionId() const;
 private:
     plint                  envelopeWidth;
     SparseBlockStructure3D sparseBlock;
     ThreadAttribution*     threadAttribution;
     LocalMultiBlockInfo3D  localInfo;
     plint                  refinementLevel;
+    id_t                   distributionId;
 };
 
 MultiBlockManagement3D scale(MultiBlockManagement3D const& originalManagement, plint relativeLevel);
@@ -133,6 +139,13 @@ MultiBlockManagement3D align( std::vector<Box3D> const& originalDomain,
 MultiBlockManagement3D reparallelize(MultiBlockManagement3D const& management,
                                      plint blockLx, plint blockLy, plint blockLz);
 
+/// Subdivide each block into numThreads blocks for the shared-memory threads of its MPI process.
+/** The new blocks stay on the MPI process of the original block, and each of them
+ *  is attributed to a different local thread. Blocks which are too small to be
+ *  subdivided are kept as they are.
+ **/
+MultiBlockManagement3D splitForThreads(MultiBlockManagement3D const& management, int numThreads);
+
 
 /// Compute envelope and things alike.
 class SmartBulk3D {
@@ -77,6 +77,11 @@ MultiProcessing3D<OriginalGenerator,MutableGenerator>::MultiProcessing3D (
     PLB_PRECONDITION( multiBlocks.size()>=1 );
     firstMultiBlock = multiBlocks[0];
 
+    // The data processors may read the statistics of the atomic-blocks.
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        multiBlocks[iBlock]->completeStatistics();
+    }
+
     // Subdivide the original generator into smaller generators which act
     //   on the intersection of all implied blocks. At this stage, all coordinates
     //   are global, thus relative to the multi-block, not to the individual
@@ -310,9 +315,7 @@ void MultiProcessing3D<OriginalGenerator,MutableGenerator>::updateEnvelopesWhere
     std::vector<MultiBlock3D*> updatedMultiBlocks;
     std::vector<modif::ModifT> typeOfModification;
     multiBlocksWhichRequireUpdate(updatedMultiBlocks, typeOfModification);
-    for (pluint iBlock=0; iBlock<updatedMultiBlocks.size(); ++iBlock) {
-        updatedMultiBlocks[iBlock]->duplicateOverlaps(typeOfModification[iBlock]);
-    }
+    duplicateOverlaps(updatedMultiBlocks, typeOfModification);
 }
 
 
@@ -398,6 +401,60 @@ void executeDataProcessor( ReductiveDataProcessorGenerator3D& generator,
     executeDataProcessor(generator, objects);
 }
 
+void executeDataProcessors( std::vector<ReductiveDataProcessorGenerator3D*> const& generators,
+                            std::vector<MultiBlock3D*> multiBlocks )
+{
+    typedef MultiProcessing3D<ReductiveDataProcessorGenerator3D, ReductiveDataProcessorGenerator3D >
+        ReductiveMultiProcessing3D;
+    std::vector<ReductiveMultiProcessing3D*> multiProcessings(generators.size());
+    // Sort the subdivided generators by the atomic-block of the first multi-block
+    //   on which they act, so that each atomic-block is processed by all generators
+    //   in a row.
+    std::map<plint, std::vector<std::pair<pluint,pluint> > > generatorsOnBlocks;
+    for (pluint iGen=0; iGen<generators.size(); ++iGen) {
+        multiProcessings[iGen] = new ReductiveMultiProcessing3D(*generators[iGen], multiBlocks);
+        std::vector<std::vector<plint> > const& atomicBlockNumbers =
+            multiProcessings[iGen]->getAtomicBlockNumbers();
+        for (pluint iGenerator=0; iGenerator<atomicBlockNumbers.size(); ++iGenerator) {
+            generatorsOnBlocks[atomicBlockNumbers[iGenerator][0]].push_back (
+                    std::make_pair(iGen, iGenerator) );
+        }
+    }
+
+    std::map<plint, std::vector<std::pair<pluint,pluint> > >::const_iterator it = generatorsOnBlocks.begin();
+    for (; it != generatorsOnBlocks.end(); ++it) {
+        for (pluint iEntry=0; iEntry<it->second.size(); ++iEntry) {
+            pluint iGen = it->second[iEntry].first;
+            pluint iGenerator = it->second[iEntry].second;
+            std::vector<plint> const& blockNumbers =
+                multiProcessings[iGen]->getAtomicBlockNumbers()[iGenerator];
+            std::vector<AtomicBlock3D*> extractedAtomicBlocks(multiBlocks.size());
+            for (pluint iBlock=0; iBlock<extractedAtomicBlocks.size(); ++iBlock) {
+                extractedAtomicBlocks[iBlock] = &multiBlocks[iBlock]->getComponent(blockNumbers[iBlock]);
+            }
+            plb::executeDataProcessor (
+                    *multiProcessings[iGen]->getRetainedGenerators()[iGenerator], extractedAtomicBlocks );
+        }
+    }
+
+    std::vector<std::vector<BlockStatistics const*> > individualStatistics(generators.size());
+    std::vector<BlockStatistics*> results(generators.size());
+    for (pluint iGen=0; iGen<generators.size(); ++iGen) {
+        std::vector<ReductiveDataProcessorGenerator3D*> const& retainedGenerators =
+            multiProcessings[iGen]->getRetainedGenerators();
+        for (pluint iGenerator=0; iGenerator<retainedGenerators.size(); ++iGenerator) {
+            individualStatistics[iGen].push_back(&retainedGenerators[iGenerator]->getStatistics());
+        }
+        results[iGen] = &generators[iGen]->getStatistics();
+    }
+    multiBlocks[0]->getCombinedStatistics().combine(individualStatistics, results);
+
+    for (pluint iGen=0; iGen<generators.size(); ++iGen) {
+        multiProcessings[iGen]->updateEnvelopesWhereRequired();
+        delete multiProcessings[iGen];
+    }
+}
+
 
 void addInternalProcessor( DataProcessorGenerator3D const& generator, MultiBlock3D& actor,
                            std::vector<MultiBlock3D*> multiBlockArgs, plint level )
@@ -58,6 +58,14 @@ void executeDataProcessor( ReductiveDataProcessorGenerator3D& generator,
 void executeDataProcessor( ReductiveDataProcessorGenerator3D& generator,
                            MultiBlock3D& object1, MultiBlock3D& object2 );
 
+/// Execute several reductive data processors on the same multi-blocks.
+/** The atomic-blocks are traversed once, each of them being processed by
+ *  all data processors in turn, and the statistics of all generators are
+ *  combined with a single reduction across processes.
+ **/
+void executeDataProcessors( std::vector<ReductiveDataProcessorGenerator3D*> const& generators,
+                            std::vector<MultiBlock3D*> multiBlocks );
+
 
 void addInternalProcessor( DataProcessorGenerator3D const& generator,
                            std::vector<MultiBlock3D*> multiBlocks, plint level=0 );
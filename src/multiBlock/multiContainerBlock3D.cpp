@@ -40,13 +40,15 @@ MultiContainerBlock3D::MultiContainerBlock3D (
 
     : MultiBlock3D(multiBlockManagement_,
                    defaultMultiBlockPolicy3D().getBlockCommunicator(),
-                   combinedStatistics_)
+                   combinedStatistics_),
+      dataPrototype(0)
 {
     allocateBlocks();
 }
 
 MultiContainerBlock3D::~MultiContainerBlock3D() {
     deAllocateBlocks();
+    delete dataPrototype;
 }
 
 MultiContainerBlock3D::MultiContainerBlock3D(plint nx_, plint ny_, plint nz_)
@@ -54,13 +56,15 @@ MultiContainerBlock3D::MultiContainerBlock3D(plint nx_, plint ny_, plint nz_)
             // Default envelope-width to 0
             defaultMultiBlockPolicy3D().getMultiBlockManagement(nx_,ny_,nz_, 0),
             defaultMultiBlockPolicy3D().getBlockCommunicator(),
-            defaultMultiBlockPolicy3D().getCombinedStatistics() )
+            defaultMultiBlockPolicy3D().getCombinedStatistics() ),
+      dataPrototype(0)
 {
     allocateBlocks();
 }
 
 MultiContainerBlock3D::MultiContainerBlock3D(MultiBlock3D const& rhs)
-    : MultiBlock3D(rhs)
+    : MultiBlock3D(rhs),
+      dataPrototype(0)
 {
     allocateBlocks();
 }
@@ -69,13 +73,15 @@ MultiContainerBlock3D::MultiContainerBlock3D(MultiBlock3D const& rhs, Box3D subD
     : MultiBlock3D (
             intersect(rhs.getMultiBlockManagement(), subDomain, crop),
             rhs.getBlockCommunicator().clone(),
-            rhs.getCombinedStatistics().clone() )
+            rhs.getCombinedStatistics().clone() ),
+      dataPrototype(0)
 {
     allocateBlocks();
 }
 
 MultiContainerBlock3D::MultiContainerBlock3D(MultiContainerBlock3D const& rhs)
-    : MultiBlock3D(rhs)
+    : MultiBlock3D(rhs),
+      dataPrototype(rhs.dataPrototype ? rhs.dataPrototype->clone() : 0)
 {
     allocateBlocks();
 }
@@ -103,9 +109,37 @@ MultiContainerBlock3D* MultiContainerBlock3D::clone (
 
 void MultiContainerBlock3D::swap(MultiContainerBlock3D& rhs) {
     blocks.swap(rhs.blocks);
+    std::swap(dataPrototype, rhs.dataPrototype);
     MultiBlock3D::swap(rhs);
 }
 
+void MultiContainerBlock3D::migrate(MultiBlockManagement3D const& newManagement) {
+    MultiContainerBlock3D newContainer(newManagement, getCombinedStatistics().clone());
+    std::map<plint,Box3D> const& domains = newManagement.getSparseBlockStructure().getBulks();
+    std::map<plint,Box3D>::const_iterator it = domains.begin();
+    for (plint pos=0; it != domains.end(); ++it, ++pos) {
+        plint id = it->first;
+        if (!newManagement.getThreadAttribution().isLocal(id)) continue;
+        BlockMap::iterator oldBlock = blocks.find(id);
+        if (oldBlock != blocks.end()) {
+            // The block has the same envelope in both distributions.
+            std::swap(oldBlock->second, newContainer.blocks[id]);
+        }
+        else if (dataPrototype) {
+            ContainerBlockData* nextData = dataPrototype->clone();
+            nextData->setUniqueID(pos);
+            newContainer.getComponent(id).setData(nextData);
+        }
+    }
+    blocks.swap(newContainer.blocks);
+    adoptDistribution(newContainer);
+}
+
+void MultiContainerBlock3D::setDataPrototype(ContainerBlockData* prototype) {
+    delete dataPrototype;
+    dataPrototype = prototype;
+}
+
 void MultiContainerBlock3D::allocateBlocks() 
 {
     for (pluint iBlock=0; iBlock<this->getLocalInfo().getBlocks().size(); ++iBlock)
@@ -193,7 +227,7 @@ MultiContainerBlock3D* createContainerBlock(MultiBlock3D& templ, ContainerBlockD
         }
     }
 
-    delete data;
+    dataContainer->setDataPrototype(data);
     return dataContainer;
 }
 
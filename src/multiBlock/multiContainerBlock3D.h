@@ -52,6 +52,14 @@ public:
     MultiContainerBlock3D* clone() const;
     MultiContainerBlock3D* clone(MultiBlockManagement3D const& multiBlockManagement) const;
     void swap(MultiContainerBlock3D& rhs);
+    /// The data of the blocks which stay on the same process is kept. The data of
+    ///   the blocks which move to another process cannot be transmitted: it is
+    ///   re-created from the data the container was created with (see
+    ///   createContainerBlock()), or left empty.
+    virtual void migrate(MultiBlockManagement3D const& newManagement);
+    /// Data from which the data of the atomic-blocks is re-created after a
+    ///   migration. The container takes ownership of the object.
+    void setDataPrototype(ContainerBlockData* prototype);
 public:
     virtual AtomicContainerBlock3D& getComponent(plint iBlock);
     virtual AtomicContainerBlock3D const& getComponent(plint iBlock) const;
@@ -68,6 +76,7 @@ private:
     void deAllocateBlocks();
 private:
     BlockMap blocks;
+    ContainerBlockData* dataPrototype;
 };
 
 MultiContainerBlock3D* createContainerBlock(MultiBlock3D& templ, ContainerBlockData* data);
@@ -77,6 +77,7 @@ public:
     MultiScalarField3D<T>& operator=(MultiScalarField3D<T> const& rhs);
     MultiScalarField3D<T>* clone() const;
     MultiScalarField3D<T>* clone(MultiBlockManagement3D const& newMultiBlockManagement) const;
+    virtual void migrate(MultiBlockManagement3D const& newMultiBlockManagement);
     void swap(MultiScalarField3D<T>& rhs);
 public: 
     virtual void reset();
@@ -153,6 +154,7 @@ public:
     MultiTensorField3D<T,nDim>& operator=(MultiTensorField3D<T,nDim> const& rhs);
     MultiTensorField3D<T,nDim>* clone() const;
     MultiTensorField3D<T,nDim>* clone(MultiBlockManagement3D const& newMultiBlockManagement) const;
+    virtual void migrate(MultiBlockManagement3D const& newMultiBlockManagement);
     void swap(MultiTensorField3D<T,nDim>& rhs);
 public:
     virtual void reset();
@@ -231,6 +233,7 @@ public:
     MultiNTensorField3D<T>& operator=(MultiNTensorField3D<T> const& rhs);
     MultiNTensorField3D<T>* clone() const;
     MultiNTensorField3D<T>* clone(MultiBlockManagement3D const& newMultiBlockManagement) const;
+    virtual void migrate(MultiBlockManagement3D const& newMultiBlockManagement);
     void swap(MultiNTensorField3D<T>& rhs);
 public:
     virtual void reset();
@@ -136,6 +136,16 @@ MultiScalarField3D<T>* MultiScalarField3D<T>::clone(MultiBlockManagement3D const
     return newField;
 }
 
+template<typename T>
+void MultiScalarField3D<T>::migrate(MultiBlockManagement3D const& newMultiBlockManagement)
+{
+    MultiScalarField3D<T>* newField = clone(newMultiBlockManagement);
+    fields.swap(newField->fields);
+    std::swap(multiScalarAccess, newField->multiScalarAccess);
+    this->adoptDistribution(*newField);
+    delete newField;
+}
+
 template<typename T>
 void MultiScalarField3D<T>::swap(MultiScalarField3D<T>& rhs) {
     MultiBlock3D::swap(rhs);
@@ -381,6 +391,16 @@ MultiTensorField3D<T,nDim>* MultiTensorField3D<T,nDim>::clone(MultiBlockManageme
     return newField;
 }
 
+template<typename T, int nDim>
+void MultiTensorField3D<T,nDim>::migrate(MultiBlockManagement3D const& newMultiBlockManagement)
+{
+    MultiTensorField3D<T,nDim>* newField = clone(newMultiBlockManagement);
+    fields.swap(newField->fields);
+    std::swap(multiTensorAccess, newField->multiTensorAccess);
+    this->adoptDistribution(*newField);
+    delete newField;
+}
+
 template<typename T, int nDim>
 void MultiTensorField3D<T,nDim>::swap(MultiTensorField3D<T,nDim>& rhs) {
     MultiBlock3D::swap(rhs);
@@ -642,6 +662,16 @@ MultiNTensorField3D<T>* MultiNTensorField3D<T>::clone(MultiBlockManagement3D con
     return newField;
 }
 
+template<typename T>
+void MultiNTensorField3D<T>::migrate(MultiBlockManagement3D const& newMultiBlockManagement)
+{
+    MultiNTensorField3D<T>* newField = clone(newMultiBlockManagement);
+    fields.swap(newField->fields);
+    std::swap(multiNTensorAccess, newField->multiNTensorAccess);
+    this->adoptDistribution(*newField);
+    delete newField;
+}
+
 template<typename T>
 void MultiNTensorField3D<T>::swap(MultiNTensorField3D<T>& rhs) {
     NTensorFieldBase3D<T>::swap(rhs);
@@ -85,6 +85,56 @@ std::vector<Overlap3D> copyDomainDataTransfer (
     return dataTransfer;
 }
 
+/// Pairs of domains of a data transfer between two multi-blocks, kept for
+///   the next transfers between the same distributions and domains.
+struct CachedDataTransfer3D {
+    id_t fromDistribution, toDistribution;
+    bool allData;
+    Box3D fromDomain, toDomain;
+    std::vector<Overlap3D> dataTransfer;
+};
+
+/// Same as copyAllDataTransfer (allData=true) or copyDomainDataTransfer, for the
+///   latest transfers between multi-blocks.
+static std::vector<Overlap3D> const& getCachedDataTransfer (
+        MultiBlockManagement3D const& fromManagement, Box3D const& fromDomain,
+        MultiBlockManagement3D const& toManagement, Box3D const& toDomain, bool allData )
+{
+    static const pluint maxCachedTransfers = 16;
+    static std::vector<CachedDataTransfer3D> cachedTransfers;
+    for (pluint iTransfer=0; iTransfer<cachedTransfers.size(); ++iTransfer) {
+        CachedDataTransfer3D const& transfer = cachedTransfers[iTransfer];
+        if ( transfer.fromDistribution == fromManagement.getDistributionId() &&
+             transfer.toDistribution == toManagement.getDistributionId() &&
+             transfer.allData == allData &&
+             (allData || (transfer.fromDomain == fromDomain && transfer.toDomain == toDomain)) )
+        {
+            return transfer.dataTransfer;
+        }
+    }
+    if (cachedTransfers.size() == maxCachedTransfers) {
+        cachedTransfers.erase(cachedTransfers.begin());
+    }
+    CachedDataTransfer3D transfer;
+    transfer.fromDistribution = fromManagement.getDistributionId();
+    transfer.toDistribution = toManagement.getDistributionId();
+    transfer.allData = allData;
+    transfer.fromDomain = fromDomain;
+    transfer.toDomain = toDomain;
+    if (allData) {
+        transfer.dataTransfer = copyAllDataTransfer (
+                fromManagement.getSparseBlockStructure(),
+                toManagement.getSparseBlockStructure() );
+    }
+    else {
+        transfer.dataTransfer = copyDomainDataTransfer (
+                fromManagement.getSparseBlockStructure(), fromDomain,
+                toManagement.getSparseBlockStructure(), toDomain );
+    }
+    cachedTransfers.push_back(transfer);
+    return cachedTransfers.back().dataTransfer;
+}
+
 void copy_generic (
         MultiBlock3D const& from, Box3D const& fromDomain,
         MultiBlock3D& to, Box3D const& toDomain, modif::ModifT typeOfModif )
@@ -92,9 +142,9 @@ void copy_generic (
     Box3D fromDomain_(fromDomain);
     Box3D toDomain_(toDomain);
     adjustEqualSize(fromDomain_, toDomain_);
-    std::vector<Overlap3D> dataTransfer = copyDomainDataTransfer (
-                from.getMultiBlockManagement().getSparseBlockStructure(), fromDomain_,
-                to.getMultiBlockManagement().getSparseBlockStructure(), toDomain_ );
+    std::vector<Overlap3D> const& dataTransfer = getCachedDataTransfer (
+                from.getMultiBlockManagement(), fromDomain_,
+                to.getMultiBlockManagement(), toDomain_, false );
     to.getBlockCommunicator().communicate (
             dataTransfer, from, to, typeOfModif );
     to.getBlockCommunicator().duplicateOverlaps(to, typeOfModif);
@@ -104,9 +154,9 @@ void copyNonLocal_generic (
         MultiBlock3D const& from, MultiBlock3D& to,
         Box3D const& domain, modif::ModifT typeOfModif )
 {
-    std::vector<Overlap3D> dataTransfer = copyAllDataTransfer (
-                from.getMultiBlockManagement().getSparseBlockStructure(),
-                to.getMultiBlockManagement().getSparseBlockStructure() );
+    std::vector<Overlap3D> const& dataTransfer = getCachedDataTransfer (
+                from.getMultiBlockManagement(), domain,
+                to.getMultiBlockManagement(), domain, true );
     to.getBlockCommunicator().communicate (
             dataTransfer, from, to, typeOfModif );
     to.getBlockCommunicator().duplicateOverlaps(to, typeOfModif);
@@ -28,7 +28,15 @@
 
 #include "core/globalDefs.h"
 #include "multiBlock/redistribution3D.h"
+#include "multiBlock/multiBlock3D.h"
+#include "multiBlock/multiBlockOperations3D.h"
+#include "core/plbDebug.h"
+#include "core/runTimeDiagnostics.h"
+#include "core/plbBlockProfiler.h"
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
+#include <set>
 
 namespace plb {
 
@@ -69,5 +77,574 @@ MultiBlockManagement3D RandomRedistribute3D::redistribute (
             original.getEnvelopeWidth(), original.getRefinementLevel() );
 }
 
-}  // namespace plb
+/* *************** Class GraphPartitionRedistribute3D ************************ */
+
+GraphPartitionRedistribute3D::GraphPartitionRedistribute3D (
+        std::map<plint,double> const& blockCosts_, double imbalanceTolerance_ )
+    : blockCosts(blockCosts_),
+      imbalanceTolerance(imbalanceTolerance_)
+{ }
+
+MultiBlockManagement3D GraphPartitionRedistribute3D::redistribute (
+        MultiBlockManagement3D const& original ) const
+{
+    SparseBlockStructure3D const& originalSparseBlock = original.getSparseBlockStructure();
+    ExplicitThreadAttribution* newAttribution = partitionBlockGraph (
+            originalSparseBlock, blockCosts, original.getEnvelopeWidth(),
+            global::mpi().getSize(), imbalanceTolerance );
+    return MultiBlockManagement3D (
+            originalSparseBlock, newAttribution,
+            original.getEnvelopeWidth(), original.getRefinementLevel() );
+}
+
+/* *************** Function partitionBlockGraph ****************************** */
+
+/// Undirected graph with weighted vertices and edges. The neighbors of vertex
+///   iVertex are adjacency[adjacencyStart[iVertex]] to adjacency[adjacencyStart[iVertex+1]-1].
+struct WeightedGraph {
+    plint getNumVertices() const { return (plint)vertexWeights.size(); }
+    std::vector<double> vertexWeights;
+    std::vector<plint>  adjacencyStart;
+    std::vector<plint>  adjacency;
+    std::vector<double> edgeWeights;
+};
+
+/// Fill the adjacency of a graph from one list of weighted neighbors per vertex.
+static void setAdjacency( std::vector<std::map<plint,double> > const& neighbors,
+                          WeightedGraph& graph )
+{
+    graph.adjacencyStart.assign(1, 0);
+    graph.adjacency.clear();
+    graph.edgeWeights.clear();
+    for (pluint iVertex=0; iVertex<neighbors.size(); ++iVertex) {
+        std::map<plint,double>::const_iterator it = neighbors[iVertex].begin();
+        for (; it!=neighbors[iVertex].end(); ++it) {
+            graph.adjacency.push_back(it->first);
+            graph.edgeWeights.push_back(it->second);
+        }
+        graph.adjacencyStart.push_back((plint)graph.adjacency.size());
+    }
+}
+
+/// Merge pairs of vertices connected by a heavy edge (heavy-edge matching). The
+///   vertices with few neighbors are matched first, and no merged vertex is
+///   heavier than maxVertexWeight.
+static void coarsenGraph( WeightedGraph const& fine, double maxVertexWeight,
+                          std::vector<plint>& coarseVertex, WeightedGraph& coarse )
+{
+    plint numVertices = fine.getNumVertices();
+    std::vector<std::pair<plint,plint> > order(numVertices);
+    for (plint iVertex=0; iVertex<numVertices; ++iVertex) {
+        plint degree = fine.adjacencyStart[iVertex+1]-fine.adjacencyStart[iVertex];
+        order[iVertex] = std::make_pair(degree, iVertex);
+    }
+    std::sort(order.begin(), order.end());
+
+    coarseVertex.assign(numVertices, -1);
+    coarse.vertexWeights.clear();
+    for (plint iOrder=0; iOrder<numVertices; ++iOrder) {
+        plint vertex = order[iOrder].second;
+        if (coarseVertex[vertex]>=0) continue;
+        plint match = -1;
+        double matchWeight = 0.;
+        for (plint iEdge=fine.adjacencyStart[vertex]; iEdge<fine.adjacencyStart[vertex+1]; ++iEdge) {
+            plint neighbor = fine.adjacency[iEdge];
+            if ( coarseVertex[neighbor]<0 && neighbor!=vertex &&
+                 fine.edgeWeights[iEdge]>matchWeight &&
+                 fine.vertexWeights[vertex]+fine.vertexWeights[neighbor] <= maxVertexWeight )
+            {
+                match = neighbor;
+                matchWeight = fine.edgeWeights[iEdge];
+            }
+        }
+        coarseVertex[vertex] = (plint)coarse.vertexWeights.size();
+        double weight = fine.vertexWeights[vertex];
+        if (match>=0) {
+            coarseVertex[match] = coarseVertex[vertex];
+            weight += fine.vertexWeights[match];
+        }
+        coarse.vertexWeights.push_back(weight);
+    }
+
+    std::vector<std::map<plint,double> > neighbors(coarse.vertexWeights.size());
+    for (plint iVertex=0; iVertex<numVertices; ++iVertex) {
+        for (plint iEdge=fine.adjacencyStart[iVertex]; iEdge<fine.adjacencyStart[iVertex+1]; ++iEdge) {
+            plint from = coarseVertex[iVertex];
+            plint to = coarseVertex[fine.adjacency[iEdge]];
+            if (from!=to) {
+                neighbors[from][to] += fine.edgeWeights[iEdge];
+            }
+        }
+    }
+    setAdjacency(neighbors, coarse);
+}
+
+/// Split a set of vertices into numParts parts of equal weight, by recursive
+///   bisection. Each bisection grows a region from a peripheral vertex, by adding
+///   the vertex which is most strongly connected to the region.
+static void bisectRecursively( WeightedGraph const& graph, std::vector<plint> const& vertices,
+                               plint firstPart, plint numParts, std::vector<plint>& parts )
+{
+    if (numParts==1 || vertices.empty()) {
+        for (pluint iVertex=0; iVertex<vertices.size(); ++iVertex) {
+            parts[vertices[iVertex]] = firstPart;
+        }
+        return;
+    }
+    // Vertices of the set are flagged with 1, and vertices of the region with 2.
+    std::vector<char> flags(graph.getNumVertices(), 0);
+    double totalWeight = 0.;
+    for (pluint iVertex=0; iVertex<vertices.size(); ++iVertex) {
+        flags[vertices[iVertex]] = 1;
+        totalWeight += graph.vertexWeights[vertices[iVertex]];
+    }
+    plint lowerParts = numParts/2;
+    double targetWeight = totalWeight*(double)lowerParts/(double)numParts;
+
+    // The last vertex reached by a breadth-first search is a peripheral vertex.
+    std::vector<plint> queue(1, vertices[0]);
+    std::vector<char> visited(graph.getNumVertices(), 0);
+    visited[vertices[0]] = 1;
+    for (pluint iQueue=0; iQueue<queue.size(); ++iQueue) {
+        plint vertex = queue[iQueue];
+        for (plint iEdge=graph.adjacencyStart[vertex]; iEdge<graph.adjacencyStart[vertex+1]; ++iEdge) {
+            plint neighbor = graph.adjacency[iEdge];
+            if (flags[neighbor]==1 && !visited[neighbor]) {
+                visited[neighbor] = 1;
+                queue.push_back(neighbor);
+            }
+        }
+    }
+
+    std::vector<double> connection(graph.getNumVertices(), 0.);
+    std::vector<plint> lowerVertices, upperVertices;
+    double regionWeight = 0.;
+    plint next = queue.back();
+    while (next>=0) {
+        double weight = graph.vertexWeights[next];
+        if ( !lowerVertices.empty() &&
+             std::fabs(regionWeight+weight-targetWeight) >= std::fabs(regionWeight-targetWeight) )
+        {
+            break;
+        }
+        flags[next] = 2;
+        lowerVertices.push_back(next);
+        regionWeight += weight;
+        for (plint iEdge=graph.adjacencyStart[next]; iEdge<graph.adjacencyStart[next+1]; ++iEdge) {
+            connection[graph.adjacency[iEdge]] += graph.edgeWeights[iEdge];
+        }
+        // Next vertex: the most strongly connected to the region, or, if the rest
+        //   of the set is not connected to the region, the first remaining one.
+        next = -1;
+        for (pluint iVertex=0; iVertex<vertices.size(); ++iVertex) {
+            plint vertex = vertices[iVertex];
+            if ( flags[vertex]==1 &&
+                 (next<0 || connection[vertex]>connection[next]) )
+            {
+                next = vertex;
+            }
+        }
+    }
+    for (pluint iVertex=0; iVertex<vertices.size(); ++iVertex) {
+        if (flags[vertices[iVertex]]==1) {
+            upperVertices.push_back(vertices[iVertex]);
+        }
+    }
+    bisectRecursively(graph, lowerVertices, firstPart, lowerParts, parts);
+    bisectRecursively(graph, upperVertices, firstPart+lowerParts, numParts-lowerParts, parts);
+}
+
+/// Move vertices at the boundary of the parts to a neighboring part, when this
+///   reduces the weight of the cut edges without exceeding maxPartWeight, or when
+///   their own part exceeds maxPartWeight. The vertices of an overweight part
+///   may also be exchanged with lighter vertices of a neighboring part.
+static void refinePartition( WeightedGraph const& graph, plint numParts,
+                             double maxPartWeight, std::vector<plint>& parts )
+{
+    static const plint maxPasses = 8;
+    plint numVertices = graph.getNumVertices();
+    std::vector<double> partWeights(numParts, 0.);
+    for (plint iVertex=0; iVertex<numVertices; ++iVertex) {
+        partWeights[parts[iVertex]] += graph.vertexWeights[iVertex];
+    }
+    std::vector<double> connection(numParts, 0.);
+    for (plint iPass=0; iPass<maxPasses; ++iPass) {
+        bool moved = false;
+        for (plint iVertex=0; iVertex<numVertices; ++iVertex) {
+            plint part = parts[iVertex];
+            double weight = graph.vertexWeights[iVertex];
+            bool overweight = partWeights[part] > maxPartWeight;
+            for (plint iEdge=graph.adjacencyStart[iVertex]; iEdge<graph.adjacencyStart[iVertex+1]; ++iEdge) {
+                connection[parts[graph.adjacency[iEdge]]] += graph.edgeWeights[iEdge];
+            }
+            plint bestPart = -1;
+            double bestGain = 0.;
+            for (plint iEdge=graph.adjacencyStart[iVertex]; iEdge<graph.adjacencyStart[iVertex+1]; ++iEdge) {
+                plint candidate = parts[graph.adjacency[iEdge]];
+                if (candidate==part) continue;
+                double gain = connection[candidate]-connection[part];
+                bool fits = partWeights[candidate]+weight <= maxPartWeight;
+                bool balances = overweight && partWeights[candidate]+weight < partWeights[part];
+                if ( (fits && gain>0.) || balances ) {
+                    if ( bestPart<0 || gain>bestGain ||
+                         (gain==bestGain && partWeights[candidate]<partWeights[bestPart]) )
+                    {
+                        bestPart = candidate;
+                        bestGain = gain;
+                    }
+                }
+            }
+            for (plint iEdge=graph.adjacencyStart[iVertex]; iEdge<graph.adjacencyStart[iVertex+1]; ++iEdge) {
+                connection[parts[graph.adjacency[iEdge]]] = 0.;
+            }
+            if (bestPart<0 && overweight) {
+                // When the vertex is too heavy to be moved, it can be exchanged
+                //   with a lighter neighbor of another part.
+                plint bestSwap = -1;
+                double bestMax = partWeights[part];
+                for (plint iEdge=graph.adjacencyStart[iVertex]; iEdge<graph.adjacencyStart[iVertex+1]; ++iEdge) {
+                    plint neighbor = graph.adjacency[iEdge];
+                    plint candidate = parts[neighbor];
+                    double difference = weight-graph.vertexWeights[neighbor];
+                    if (candidate==part || difference<=0.) continue;
+                    double newMax = std::max(partWeights[part]-difference, partWeights[candidate]+difference);
+                    if (newMax<bestMax) {
+                        bestSwap = neighbor;
+                        bestMax = newMax;
+                    }
+                }
+                if (bestSwap>=0) {
+                    plint candidate = parts[bestSwap];
+                    double difference = weight-graph.vertexWeights[bestSwap];
+                    partWeights[part] -= difference;
+                    partWeights[candidate] += difference;
+                    parts[iVertex] = candidate;
+                    parts[bestSwap] = part;
+                    moved = true;
+                    continue;
+                }
+                // Otherwise, an overweight part without lighter neighbors gives
+                //   the vertex to the lightest part.
+                plint lightest = std::min_element(partWeights.begin(), partWeights.end())-partWeights.begin();
+                if (partWeights[lightest]+weight < partWeights[part]) {
+                    bestPart = lightest;
+                }
+            }
+            if (bestPart>=0) {
+                partWeights[part] -= weight;
+                partWeights[bestPart] += weight;
+                parts[iVertex] = bestPart;
+                moved = true;
+            }
+        }
+        if (!moved) break;
+    }
+}
+
+ExplicitThreadAttribution* partitionBlockGraph (
+        SparseBlockStructure3D const& sparseBlock, std::map<plint,double> const& blockCosts,
+        plint envelopeWidth, int numProc, double imbalanceTolerance )
+{
+    PLB_PRECONDITION( numProc>0 );
+    std::map<plint,Box3D> const& bulks = sparseBlock.getBulks();
+    std::vector<plint> blockIds;
+    std::map<plint,plint> vertexOfBlock;
+    WeightedGraph graph;
+    for (std::map<plint,Box3D>::const_iterator it=bulks.begin(); it!=bulks.end(); ++it) {
+        vertexOfBlock[it->first] = (plint)blockIds.size();
+        blockIds.push_back(it->first);
+        std::map<plint,double>::const_iterator cost = blockCosts.find(it->first);
+        graph.vertexWeights.push_back (
+                cost==blockCosts.end() ? (double)it->second.nCells() : cost->second );
+    }
+    // The edges are weighted by the number of cells exchanged in both directions.
+    std::vector<std::map<plint,double> > neighbors(blockIds.size());
+    for (pluint iBlock=0; iBlock<blockIds.size(); ++iBlock) {
+        std::vector<plint> ids;
+        std::vector<Box3D> overlapsOnBulk, overlapsOnNeighbors;
+        sparseBlock.computeOverlaps( blockIds[iBlock], envelopeWidth,
+                                     ids, overlapsOnBulk, overlapsOnNeighbors );
+        for (pluint iOverlap=0; iOverlap<ids.size(); ++iOverlap) {
+            plint neighbor = vertexOfBlock[ids[iOverlap]];
+            if (neighbor==(plint)iBlock) continue;
+            double volume = (double)overlapsOnNeighbors[iOverlap].nCells();
+            neighbors[iBlock][neighbor] += volume;
+            neighbors[neighbor][iBlock] += volume;
+        }
+    }
+    setAdjacency(neighbors, graph);
+
+    double totalWeight = 0.;
+    for (pluint iVertex=0; iVertex<graph.vertexWeights.size(); ++iVertex) {
+        totalWeight += graph.vertexWeights[iVertex];
+    }
+    double maxPartWeight = (1.+imbalanceTolerance)*totalWeight/(double)numProc;
+
+    // Coarsening, as long as the graph is large and shrinks noticeably.
+    std::vector<WeightedGraph> graphs(1, graph);
+    std::vector<std::vector<plint> > coarseVertices;
+    plint coarsestSize = std::max((plint)20, (plint)8*numProc);
+    while (graphs.back().getNumVertices() > coarsestSize) {
+        std::vector<plint> coarseVertex;
+        WeightedGraph coarse;
+        coarsenGraph(graphs.back(), 0.5*totalWeight/(double)numProc, coarseVertex, coarse);
+        if (coarse.getNumVertices() > (plint)(0.95*(double)graphs.back().getNumVertices())) {
+            break;
+        }
+        coarseVertices.push_back(coarseVertex);
+        graphs.push_back(coarse);
+    }
+
+    // Initial partition of the coarsest graph, refined on each level of the uncoarsening.
+    std::vector<plint> parts(graphs.back().getNumVertices(), 0);
+    std::vector<plint> vertices(graphs.back().getNumVertices());
+    for (pluint iVertex=0; iVertex<vertices.size(); ++iVertex) {
+        vertices[iVertex] = (plint)iVertex;
+    }
+    bisectRecursively(graphs.back(), vertices, 0, numProc, parts);
+    refinePartition(graphs.back(), numProc, maxPartWeight, parts);
+    for (plint iLevel=(plint)coarseVertices.size()-1; iLevel>=0; --iLevel) {
+        std::vector<plint> fineParts(coarseVertices[iLevel].size());
+        for (pluint iVertex=0; iVertex<fineParts.size(); ++iVertex) {
+            fineParts[iVertex] = parts[coarseVertices[iLevel][iVertex]];
+        }
+        parts.swap(fineParts);
+        refinePartition(graphs[iLevel], numProc, maxPartWeight, parts);
+    }
+
+    ExplicitThreadAttribution* attribution = new ExplicitThreadAttribution;
+    for (pluint iBlock=0; iBlock<blockIds.size(); ++iBlock) {
+        attribution->addBlock(blockIds[iBlock], parts[iBlock]);
+    }
+    return attribution;
+}
 
+/* *************** Function getProfiledBlockCosts **************************** */
+
+std::map<plint,double> getProfiledBlockCosts(MultiBlock3D const& multiBlock) {
+    std::map<plint,Box3D> const& bulks = multiBlock.getSparseBlockStructure().getBulks();
+    std::map<plint,double> times = global::blockProfiler().getTimes(multiBlock.getId());
+    std::vector<double> costs(bulks.size(), 0.);
+    std::map<plint,Box3D>::const_iterator it = bulks.begin();
+    for (pluint pos=0; it!=bulks.end(); ++it, ++pos) {
+        std::map<plint,double>::const_iterator time = times.find(it->first);
+        if (time != times.end()) {
+            costs[pos] = time->second;
+        }
+    }
+#ifdef PLB_MPI_PARALLEL
+    global::mpi().allReduceVect(costs, MPI_SUM);
+#endif
+
+    std::map<plint,double> blockCosts;
+    it = bulks.begin();
+    for (pluint pos=0; it!=bulks.end(); ++it, ++pos) {
+        blockCosts[it->first] = costs[pos];
+    }
+    return blockCosts;
+}
+
+/* *************** Function migrateMultiBlocks ******************************* */
+
+void migrateMultiBlocks( std::vector<MultiBlock3D*> const& multiBlocks,
+                         ThreadAttribution const& newAttribution )
+{
+    std::set<id_t> migratedIds;
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        PLB_PRECONDITION( multiBlocks[iBlock]->getSparseBlockStructure().getBulks() ==
+                          multiBlocks[0]->getSparseBlockStructure().getBulks() );
+        migratedIds.insert(multiBlocks[iBlock]->getId());
+    }
+    // The processors are stored before the migration, because they are attached
+    //   to the atomic-blocks and disappear with them.
+    std::vector<std::vector<MultiBlock3D::ProcessorStorage3D> > processors(multiBlocks.size());
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        processors[iBlock] = multiBlocks[iBlock]->getStoredProcessors();
+        for (pluint iProcessor=0; iProcessor<processors[iBlock].size(); ++iProcessor) {
+            std::vector<id_t> const& ids = processors[iBlock][iProcessor].getMultiBlockIds();
+            for (pluint iId=0; iId<ids.size(); ++iId) {
+                if (migratedIds.find(ids[iId]) == migratedIds.end()) {
+                    throw PlbLogicException (
+                        "A data processor couples a migrated multi-block with a multi-block "
+                        "which is not migrated." );
+                }
+            }
+        }
+    }
+
+    std::map<id_t, MultiBlockManagement3D*> newManagements;
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        MultiBlockManagement3D const& management = multiBlocks[iBlock]->getMultiBlockManagement();
+        std::map<id_t, MultiBlockManagement3D*>::iterator it =
+            newManagements.find(management.getDistributionId());
+        if (it == newManagements.end()) {
+            it = newManagements.insert (
+                    std::make_pair( management.getDistributionId(),
+                                    new MultiBlockManagement3D (
+                                        management.getSparseBlockStructure(), newAttribution.clone(),
+                                        management.getEnvelopeWidth(), management.getRefinementLevel() ) ) ).first;
+        }
+        multiBlocks[iBlock]->migrate(*it->second);
+    }
+    for (std::map<id_t, MultiBlockManagement3D*>::iterator it=newManagements.begin();
+         it != newManagements.end(); ++it)
+    {
+        delete it->second;
+    }
+
+    // The processors are re-created once all multi-blocks they access are migrated.
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        for (pluint iProcessor=0; iProcessor<processors[iBlock].size(); ++iProcessor) {
+            MultiBlock3D::ProcessorStorage3D const& storage = processors[iBlock][iProcessor];
+            addInternalProcessor( storage.getGenerator(), *multiBlocks[iBlock],
+                                  storage.getMultiBlocks(), storage.getLevel() );
+        }
+    }
+}
+
+/* *************** Class DynamicLoadBalancer3D ******************************* */
+
+/// Load of the most loaded process divided by the average load.
+static double computeLoadImbalance( std::map<plint,double> const& costs,
+                                    ThreadAttribution const& attribution, int numProc )
+{
+    std::vector<double> loads(numProc, 0.);
+    double totalLoad = 0.;
+    for (std::map<plint,double>::const_iterator it=costs.begin(); it!=costs.end(); ++it) {
+        loads[attribution.getMpiProcess(it->first)] += it->second;
+        totalLoad += it->second;
+    }
+    if (totalLoad <= 0.) {
+        return 1.;
+    }
+    return *std::max_element(loads.begin(), loads.end()) * (double)numProc / totalLoad;
+}
+
+/// Attribute the parts of a new partition to the processes, in such a way that
+///   the blocks which stay on their current process carry as much cost as possible.
+static ExplicitThreadAttribution* attributeParts (
+        std::map<plint,double> const& costs, ThreadAttribution const& oldAttribution,
+        ExplicitThreadAttribution const& parts, int numProc )
+{
+    std::vector<std::vector<double> > sharedCost(numProc, std::vector<double>(numProc, 0.));
+    for (std::map<plint,double>::const_iterator it=costs.begin(); it!=costs.end(); ++it) {
+        sharedCost[parts.getMpiProcess(it->first)][oldAttribution.getMpiProcess(it->first)] += it->second;
+    }
+    std::vector<std::pair<double, std::pair<plint,plint> > > candidates;
+    for (plint iPart=0; iPart<numProc; ++iPart) {
+        for (plint iProc=0; iProc<numProc; ++iProc) {
+            if (sharedCost[iPart][iProc] > 0.) {
+                candidates.push_back(std::make_pair(-sharedCost[iPart][iProc], std::make_pair(iPart,iProc)));
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    std::vector<plint> procOfPart(numProc, -1);
+    std::vector<bool> procIsTaken(numProc, false);
+    for (pluint iCandidate=0; iCandidate<candidates.size(); ++iCandidate) {
+        plint iPart = candidates[iCandidate].second.first;
+        plint iProc = candidates[iCandidate].second.second;
+        if (procOfPart[iPart]<0 && !procIsTaken[iProc]) {
+            procOfPart[iPart] = iProc;
+            procIsTaken[iProc] = true;
+        }
+    }
+    plint nextProc = 0;
+    for (plint iPart=0; iPart<numProc; ++iPart) {
+        if (procOfPart[iPart]<0) {
+            while (procIsTaken[nextProc]) ++nextProc;
+            procOfPart[iPart] = nextProc;
+            procIsTaken[nextProc] = true;
+        }
+    }
+
+    ExplicitThreadAttribution* attribution = new ExplicitThreadAttribution;
+    for (std::map<plint,double>::const_iterator it=costs.begin(); it!=costs.end(); ++it) {
+        attribution->addBlock(it->first, procOfPart[parts.getMpiProcess(it->first)]);
+    }
+    return attribution;
+}
+
+DynamicLoadBalancer3D::DynamicLoadBalancer3D (
+        std::vector<MultiBlock3D*> const& multiBlocks_,
+        double imbalanceThreshold_, double imbalanceTolerance_ )
+    : multiBlocks(multiBlocks_),
+      imbalanceThreshold(imbalanceThreshold_),
+      imbalanceTolerance(imbalanceTolerance_)
+{
+    PLB_PRECONDITION( !multiBlocks.empty() );
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        multiBlocks[iBlock]->getBlockScheduler().toggleCostAccumulation(true);
+    }
+    resetMeasurement();
+}
+
+DynamicLoadBalancer3D::~DynamicLoadBalancer3D() {
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        multiBlocks[iBlock]->getBlockScheduler().toggleCostAccumulation(false);
+    }
+}
+
+void DynamicLoadBalancer3D::resetMeasurement() {
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        multiBlocks[iBlock]->getBlockScheduler().resetAccumulatedCosts();
+    }
+}
+
+std::map<plint,double> DynamicLoadBalancer3D::getMeasuredCosts() const {
+    std::map<plint,Box3D> const& bulks = multiBlocks[0]->getSparseBlockStructure().getBulks();
+    std::vector<double> costs(bulks.size(), 0.);
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        std::map<plint,double> const& blockCosts =
+            multiBlocks[iBlock]->getBlockScheduler().getAccumulatedCosts();
+        std::map<plint,Box3D>::const_iterator it = bulks.begin();
+        for (pluint pos=0; it!=bulks.end(); ++it, ++pos) {
+            std::map<plint,double>::const_iterator cost = blockCosts.find(it->first);
+            if (cost != blockCosts.end()) {
+                costs[pos] += cost->second;
+            }
+        }
+    }
+#ifdef PLB_MPI_PARALLEL
+    global::mpi().allReduceVect(costs, MPI_SUM);
+#endif
+
+    std::map<plint,double> measuredCosts;
+    std::map<plint,Box3D>::const_iterator it = bulks.begin();
+    for (pluint pos=0; it!=bulks.end(); ++it, ++pos) {
+        measuredCosts[it->first] = costs[pos];
+    }
+    return measuredCosts;
+}
+
+double DynamicLoadBalancer3D::computeImbalance() const {
+    return computeLoadImbalance (
+            getMeasuredCosts(), multiBlocks[0]->getMultiBlockManagement().getThreadAttribution(),
+            global::mpi().getSize() );
+}
+
+bool DynamicLoadBalancer3D::rebalance() {
+    std::map<plint,double> costs = getMeasuredCosts();
+    MultiBlockManagement3D const& management = multiBlocks[0]->getMultiBlockManagement();
+    ThreadAttribution const& attribution = management.getThreadAttribution();
+    int numProc = global::mpi().getSize();
+    double imbalance = computeLoadImbalance(costs, attribution, numProc);
+    bool migrated = false;
+    if (imbalance > 1.+imbalanceThreshold) {
+        ExplicitThreadAttribution* parts = partitionBlockGraph (
+                management.getSparseBlockStructure(), costs,
+                management.getEnvelopeWidth(), numProc, imbalanceTolerance );
+        ExplicitThreadAttribution* newAttribution = attributeParts(costs, attribution, *parts, numProc);
+        delete parts;
+        // The measured costs are the same on all processes, and so is the decision.
+        if (computeLoadImbalance(costs, *newAttribution, numProc) < imbalance) {
+            migrateMultiBlocks(multiBlocks, *newAttribution);
+            migrated = true;
+        }
+        delete newAttribution;
+    }
+    resetMeasurement();
+    return migrated;
+}
+
+}  // namespace plb
@@ -32,9 +32,15 @@
 #include "parallelism/mpiManager.h"
 #include "core/globalDefs.h"
 #include "multiBlock/multiBlockManagement3D.h"
+#include "multiBlock/threadAttribution.h"
+#include <map>
+#include <vector>
 
 namespace plb {
 
+class MultiBlock3D;
+template<typename T, template<typename U> class Descriptor> class MultiBlockLattice3D;
+
 struct MultiBlockRedistribute3D {
     virtual ~MultiBlockRedistribute3D() { }
     virtual MultiBlockManagement3D redistribute(MultiBlockManagement3D const& original) const=0;
@@ -48,6 +54,98 @@ private:
     pluint rseed;
 };
 
+/// Redistribution which balances the cost of the blocks among the processes,
+///   and minimizes the volume of the communications between them.
+/** The blocks are the vertices of a graph, weighted by their cost, and two
+ *  blocks are connected by an edge weighted by the number of cells they
+ *  exchange. The graph is partitioned with a multilevel algorithm (see
+ *  partitionBlockGraph()).
+ **/
+class GraphPartitionRedistribute3D : public MultiBlockRedistribute3D {
+public:
+    /// The cost of the blocks which are not listed in blockCosts_ (by default,
+    ///   all of them) is their number of cells. The costs computed by
+    ///   computeBlockCosts() account for the solid cells.
+    GraphPartitionRedistribute3D (
+            std::map<plint,double> const& blockCosts_ = std::map<plint,double>(),
+            double imbalanceTolerance_ = 0.03 );
+    virtual MultiBlockManagement3D redistribute(MultiBlockManagement3D const& original) const;
+private:
+    std::map<plint,double> blockCosts;
+    double imbalanceTolerance;
+};
+
+/// Attribute the blocks of a sparse block-structure to numProc processes,
+///   by partitioning the graph of the blocks.
+/** The graph is coarsened by heavy-edge matching, the coarsest graph is
+ *  partitioned by recursive bisection with graph growing, and the partition
+ *  is refined on each level of the uncoarsening by moving blocks at the
+ *  boundary of the parts. The costs of the parts differ from their average
+ *  by at most imbalanceTolerance, unless the blocks are too coarse for it.
+ *  The result is the same on all processes.
+ **/
+ExplicitThreadAttribution* partitionBlockGraph (
+        SparseBlockStructure3D const& sparseBlock, std::map<plint,double> const& blockCosts,
+        plint envelopeWidth, int numProc, double imbalanceTolerance=0.03 );
+
+/// Cost of the collision-streaming step of each block of a lattice, which is
+///   its number of cells, not counting the cells without dynamics and counting
+///   the bounce-back cells with the weight solidCost. Collective on all processes.
+template<typename T, template<typename U> class Descriptor>
+std::map<plint,double> computeBlockCosts (
+        MultiBlockLattice3D<T,Descriptor>& lattice, double solidCost=0.1 );
+
+/// Time spent on each block of a multi-block, summed over all categories of the
+///   block profiler (see global::BlockProfiler). The result can be used as block
+///   costs by GraphPartitionRedistribute3D. Collective on all processes.
+std::map<plint,double> getProfiledBlockCosts(MultiBlock3D const& multiBlock);
+
+/// Move the atomic-blocks of several multi-blocks to the processes specified
+///   by a new thread attribution, during a simulation.
+/** The multi-blocks must have the same sparse block-structure, and the list must
+ *  contain all the multi-blocks which are coupled by internal data processors:
+ *  the processors are removed during the migration, and re-created afterwards
+ *  from their generators. Multi-blocks which share a block-management before
+ *  the migration share one afterwards. Collective on all processes.
+ **/
+void migrateMultiBlocks( std::vector<MultiBlock3D*> const& multiBlocks,
+                         ThreadAttribution const& newAttribution );
+
+/// Redistributes a group of coupled multi-blocks during a simulation, according
+///   to the measured execution time of their blocks.
+/** The execution time of each block is accumulated by the block-schedulers
+ *  of the multi-blocks, from the construction of the load-balancer or from the
+ *  last call to resetMeasurement() or rebalance(). When the most loaded process
+ *  exceeds the average load by more than imbalanceThreshold, the blocks are
+ *  re-attributed with partitionBlockGraph(), keeping as many of them as possible
+ *  on their current process, and migrated with migrateMultiBlocks().
+ **/
+class DynamicLoadBalancer3D {
+public:
+    DynamicLoadBalancer3D( std::vector<MultiBlock3D*> const& multiBlocks_,
+                           double imbalanceThreshold_=0.1, double imbalanceTolerance_=0.03 );
+    ~DynamicLoadBalancer3D();
+    /// Start a new measurement window.
+    void resetMeasurement();
+    /// Execution time of each block during the current measurement window,
+    ///   summed over all multi-blocks. Collective on all processes.
+    std::map<plint,double> getMeasuredCosts() const;
+    /// Load of the most loaded process divided by the average load, during the
+    ///   current measurement window. Collective on all processes.
+    double computeImbalance() const;
+    /// Migrate the blocks if the imbalance exceeds the threshold and can be reduced,
+    ///   and start a new measurement window. Returns true if the blocks were
+    ///   migrated. Collective on all processes.
+    bool rebalance();
+private:
+    DynamicLoadBalancer3D(DynamicLoadBalancer3D const& rhs);
+    DynamicLoadBalancer3D& operator=(DynamicLoadBalancer3D const& rhs);
+private:
+    std::vector<MultiBlock3D*> multiBlocks;
+    double imbalanceThreshold;
+    double imbalanceTolerance;
+};
+
 }  // namespace plb
 
 #endif  // REDISTRIBUTION_3D_H
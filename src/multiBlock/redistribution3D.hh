@@ -0,0 +1,91 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Utilities for 3D multi data distributions -- generic implementation.
+ */
+
+#ifndef REDISTRIBUTION_3D_HH
+#define REDISTRIBUTION_3D_HH
+
+#include "multiBlock/redistribution3D.h"
+#include "multiBlock/multiBlockLattice3D.h"
+#include "multiBlock/multiBlockInfo3D.h"
+#include "core/dynamics.h"
+#include <algorithm>
+#include <vector>
+
+namespace plb {
+
+template<typename T, template<typename U> class Descriptor>
+std::map<plint,double> computeBlockCosts (
+        MultiBlockLattice3D<T,Descriptor>& lattice, double solidCost )
+{
+    static const int bounceBackId = BounceBack<T,Descriptor>().getId();
+    static const int noDynamicsId = NoDynamics<T,Descriptor>().getId();
+
+    MultiBlockManagement3D const& management = lattice.getMultiBlockManagement();
+    std::map<plint,Box3D> const& bulks = management.getSparseBlockStructure().getBulks();
+    std::vector<plint> const& localBlocks = lattice.getLocalInfo().getBlocks();
+    std::vector<double> costs(bulks.size(), 0.);
+    std::map<plint,Box3D>::const_iterator it = bulks.begin();
+    for (pluint pos=0; it!=bulks.end(); ++it, ++pos) {
+        plint blockId = it->first;
+        if (std::find(localBlocks.begin(), localBlocks.end(), blockId) == localBlocks.end()) {
+            continue;
+        }
+        BlockLattice3D<T,Descriptor> const& block = lattice.getComponent(blockId);
+        SmartBulk3D smartBulk(management, blockId);
+        Box3D domain(smartBulk.toLocal(smartBulk.getBulk()));
+        double cost = 0.;
+        for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+            for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+                for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                    int id = block.get(iX,iY,iZ).getDynamics().getId();
+                    if (id==bounceBackId) {
+                        cost += solidCost;
+                    }
+                    else if (id!=noDynamicsId) {
+                        cost += 1.;
+                    }
+                }
+            }
+        }
+        costs[pos] = cost;
+    }
+#ifdef PLB_MPI_PARALLEL
+    global::mpi().allReduceVect(costs, MPI_SUM);
+#endif
+
+    std::map<plint,double> blockCosts;
+    it = bulks.begin();
+    for (pluint pos=0; it!=bulks.end(); ++it, ++pos) {
+        blockCosts[it->first] = costs[pos];
+    }
+    return blockCosts;
+}
+
+}  // namespace plb
+
+#endif  // REDISTRIBUTION_3D_HH
@@ -45,6 +45,50 @@ void applyProcessingFunctional(ReductiveBoxProcessingFunctional3D& functional,
     functional.getStatistics() = generator.getFunctional().getStatistics();
 }
 
+void applyProcessingFunctionals (
+        std::vector<ReductiveBoxProcessingFunctional3D*> const& functionals,
+        Box3D domain,
+        std::vector<MultiBlock3D*> multiBlocks )
+{
+    // The functionals are interleaved block by block, which is only valid
+    //   if none of them writes data read by another one.
+    for (pluint iFunctional=0; iFunctional<functionals.size(); ++iFunctional) {
+        std::vector<modif::ModifT> modifications(multiBlocks.size(), modif::undefined);
+        functionals[iFunctional]->getTypeOfModification(modifications);
+        for (pluint iBlock=0; iBlock<modifications.size(); ++iBlock) {
+            PLB_ASSERT( modifications[iBlock] != modif::undefined );
+            if (modifications[iBlock] != modif::nothing) {
+                for (pluint jFunctional=0; jFunctional<functionals.size(); ++jFunctional) {
+                    applyProcessingFunctional(*functionals[jFunctional], domain, multiBlocks);
+                }
+                return;
+            }
+        }
+    }
+
+    std::vector<ReductiveDataProcessorGenerator3D*> generators(functionals.size());
+    for (pluint iFunctional=0; iFunctional<functionals.size(); ++iFunctional) {
+        generators[iFunctional] =
+            new ReductiveBoxProcessorGenerator3D(functionals[iFunctional]->clone(), domain);
+    }
+    executeDataProcessors(generators, multiBlocks);
+    for (pluint iFunctional=0; iFunctional<functionals.size(); ++iFunctional) {
+        // Recover reducted values from the generator's functional.
+        functionals[iFunctional]->getStatistics() = generators[iFunctional]->getStatistics();
+        delete generators[iFunctional];
+    }
+}
+
+void applyProcessingFunctionals (
+        std::vector<ReductiveBoxProcessingFunctional3D*> const& functionals,
+        Box3D domain,
+        MultiBlock3D& multiBlock )
+{
+    std::vector<MultiBlock3D*> multiBlocks(1);
+    multiBlocks[0] = &multiBlock;
+    applyProcessingFunctionals(functionals, domain, multiBlocks);
+}
+
 
 /* *************** DotProcessing, general case ***************************** */
 
@@ -57,6 +57,25 @@ void applyProcessingFunctional(ReductiveBoxProcessingFunctional3D& functional,
                                Box3D domain,
                                std::vector<MultiBlock3D*> multiBlocks);
 
+/// Apply several functionals on the same domain and multi-blocks. The
+/// atomic-blocks are traversed once, each of them being processed by all
+/// functionals in turn, and the values of all functionals are reduced
+/// across processes with a single collective operation. The reduced values
+/// are recovered from each functional, as with applyProcessingFunctional.
+/// This requires read-only functionals, whose result does not depend on the
+/// order of execution. If any of them modifies a multi-block (according to
+/// getTypeOfModification()), they are applied one after the other instead.
+void applyProcessingFunctionals (
+        std::vector<ReductiveBoxProcessingFunctional3D*> const& functionals,
+        Box3D domain,
+        std::vector<MultiBlock3D*> multiBlocks );
+
+/// Apply several functionals on the same domain of a single multi-block.
+void applyProcessingFunctionals (
+        std::vector<ReductiveBoxProcessingFunctional3D*> const& functionals,
+        Box3D domain,
+        MultiBlock3D& multiBlock );
+
 /// Apply a functional on a sequence of block-lattices. If the number
 /// of lattices is 1 or 2, you should prefer the _L and _LL version
 /// of the functional.
@@ -30,13 +30,16 @@
 #include "atomicBlock/dataField3D.hh"
 #include "algorithm/basicAlgorithms.h"
 #include <algorithm>
+#include <cstdlib>
+#include <queue>
 
 namespace plb {
 
 ////////////////////// function createRegularDistribution3D /////////////////////
 
 SparseBlockStructure3D createRegularDistribution3D (
-        Box3D const& domain, plint numBlocksX, plint numBlocksY, plint numBlocksZ )
+        Box3D const& domain, plint numBlocksX, plint numBlocksY, plint numBlocksZ,
+        BlockOrdering::OrderingT ordering )
 {
     SparseBlockStructure3D dataGeometry(domain);
     plint posX = domain.x0;
@@ -60,20 +63,31 @@ SparseBlockStructure3D createRegularDistribution3D (
         }
         posX += lx;
     }
-    return dataGeometry;
+    if (ordering == BlockOrdering::lexicographic) {
+        return dataGeometry;
+    }
+    // Renumber the blocks along the curve.
+    std::vector<plint> orderedBlocks = orderBlocks(dataGeometry, ordering);
+    std::map<plint,Box3D> const& bulks = dataGeometry.getBulks();
+    SparseBlockStructure3D orderedGeometry(domain);
+    for (pluint iBlock=0; iBlock<orderedBlocks.size(); ++iBlock) {
+        orderedGeometry.addBlock(bulks.find(orderedBlocks[iBlock])->second, (plint)iBlock);
+    }
+    return orderedGeometry;
 }
 
 SparseBlockStructure3D createRegularDistribution3D (
         plint nx, plint ny, plint nz,
-        plint numBlocksX, plint numBlocksY, plint numBlocksZ )
+        plint numBlocksX, plint numBlocksY, plint numBlocksZ,
+        BlockOrdering::OrderingT ordering )
 {
     return createRegularDistribution3D (
             Box3D(0, nx-1, 0, ny-1, 0, nz-1),
-            numBlocksX, numBlocksY, numBlocksZ);
+            numBlocksX, numBlocksY, numBlocksZ, ordering);
 }
 
 SparseBlockStructure3D createRegularDistribution3D (
-        Box3D const& domain, int numProc)
+        Box3D const& domain, int numProc, BlockOrdering::OrderingT ordering)
 {
     std::vector<plint> repartition = algorithm::evenRepartition(numProc, 3);
     std::vector<plint> newRepartition(3);
@@ -115,14 +129,449 @@ SparseBlockStructure3D createRegularDistribution3D (
     }
     return createRegularDistribution3D (
                  domain,
-                 newRepartition[0], newRepartition[1], newRepartition[2] );
+                 newRepartition[0], newRepartition[1], newRepartition[2], ordering );
 }
 
 SparseBlockStructure3D createRegularDistribution3D (
-        plint nx, plint ny, plint nz, int numProc)
+        plint nx, plint ny, plint nz, int numProc, BlockOrdering::OrderingT ordering)
 {
     return createRegularDistribution3D (
-            Box3D(0, nx-1, 0, ny-1, 0, nz-1), numProc );
+            Box3D(0, nx-1, 0, ny-1, 0, nz-1), numProc, ordering );
+}
+
+////////////////////// function orderBlocks /////////////////////
+
+/// Position of a point with integer coordinates on the Morton curve.
+static pluint mortonKey(Array<plint,3> const& coord, plint numBits)
+{
+    pluint key = 0;
+    for (plint iBit=numBits-1; iBit>=0; --iBit) {
+        for (plint iD=0; iD<3; ++iD) {
+            key = (key<<1) | (((pluint)coord[iD]>>iBit) & 1);
+        }
+    }
+    return key;
+}
+
+/// Position of a point with integer coordinates on the Hilbert curve.
+/** The coordinates are converted into the "transposed" Hilbert index with the
+ *  algorithm of J. Skilling (AIP Conf. Proc. 707, 2004), whose bits are then
+ *  interleaved like those of a Morton key.
+ **/
+static pluint hilbertKey(Array<plint,3> const& coord, plint numBits)
+{
+    Array<pluint,3> x((pluint)coord[0], (pluint)coord[1], (pluint)coord[2]);
+    pluint m = (pluint)1 << (numBits-1);
+    // Inverse undo.
+    for (pluint q=m; q>1; q>>=1) {
+        pluint p = q-1;
+        for (plint iD=0; iD<3; ++iD) {
+            if (x[iD] & q) {
+                x[0] ^= p;
+            }
+            else {
+                pluint t = (x[0]^x[iD]) & p;
+                x[0] ^= t;
+                x[iD] ^= t;
+            }
+        }
+    }
+    // Gray encode.
+    for (plint iD=1; iD<3; ++iD) {
+        x[iD] ^= x[iD-1];
+    }
+    pluint t = 0;
+    for (pluint q=m; q>1; q>>=1) {
+        if (x[2] & q) t ^= q-1;
+    }
+    for (plint iD=0; iD<3; ++iD) {
+        x[iD] ^= t;
+    }
+    return mortonKey(Array<plint,3>((plint)x[0], (plint)x[1], (plint)x[2]), numBits);
+}
+
+std::vector<plint> orderBlocks (
+        SparseBlockStructure3D const& blockStructure, BlockOrdering::OrderingT ordering )
+{
+    std::map<plint,Box3D> const& bulks = blockStructure.getBulks();
+    // The centers of the blocks (counted twice to stay with integers) are
+    //   mapped to a grid, by their rank among all center coordinates in
+    //   each direction. The blocks of irregular distributions are in this
+    //   way brought on a grid as compact as possible.
+    std::vector<plint> centers[3];
+    std::map<plint,Box3D>::const_iterator it = bulks.begin();
+    for (; it != bulks.end(); ++it) {
+        Box3D const& bulk = it->second;
+        centers[0].push_back(bulk.x0+bulk.x1);
+        centers[1].push_back(bulk.y0+bulk.y1);
+        centers[2].push_back(bulk.z0+bulk.z1);
+    }
+    plint gridSize = 1;
+    for (plint iD=0; iD<3; ++iD) {
+        std::sort(centers[iD].begin(), centers[iD].end());
+        centers[iD].erase(std::unique(centers[iD].begin(), centers[iD].end()), centers[iD].end());
+        gridSize = std::max(gridSize, (plint)centers[iD].size());
+    }
+    plint numBits = 1;
+    while (((plint)1<<numBits) < gridSize) ++numBits;
+    PLB_ASSERT( 3*numBits < (plint)(8*sizeof(pluint)) );
+
+    std::vector<std::pair<pluint,plint> > keys;
+    for (it = bulks.begin(); it != bulks.end(); ++it) {
+        Box3D const& bulk = it->second;
+        Array<plint,3> center(bulk.x0+bulk.x1, bulk.y0+bulk.y1, bulk.z0+bulk.z1);
+        Array<plint,3> coord;
+        for (plint iD=0; iD<3; ++iD) {
+            coord[iD] = std::lower_bound(centers[iD].begin(), centers[iD].end(), center[iD])
+                            - centers[iD].begin();
+        }
+        pluint key = 0;
+        switch (ordering) {
+            case BlockOrdering::lexicographic:
+                key = ( (pluint)coord[0]*centers[1].size() + coord[1] )
+                          * centers[2].size() + coord[2];
+                break;
+            case BlockOrdering::morton:
+                key = mortonKey(coord, numBits);
+                break;
+            case BlockOrdering::hilbert:
+                key = hilbertKey(coord, numBits);
+                break;
+            default:
+                PLB_ASSERT( false );
+        }
+        keys.push_back(std::make_pair(key, it->first));
+    }
+    // Blocks with the same key (if they have the same center) are sorted by id.
+    std::sort(keys.begin(), keys.end());
+    std::vector<plint> orderedBlocks(keys.size());
+    for (pluint iBlock=0; iBlock<keys.size(); ++iBlock) {
+        orderedBlocks[iBlock] = keys[iBlock].second;
+    }
+    return orderedBlocks;
+}
+
+////////////////////// function createCurveAttribution /////////////////////
+
+ThreadAttribution* createCurveAttribution (
+        SparseBlockStructure3D const& blockStructure, BlockOrdering::OrderingT ordering,
+        std::map<plint,double> const& blockCosts, int numProc )
+{
+    PLB_PRECONDITION( numProc>0 );
+    std::vector<plint> orderedBlocks = orderBlocks(blockStructure, ordering);
+    std::map<plint,Box3D> const& bulks = blockStructure.getBulks();
+    std::vector<double> costs(orderedBlocks.size());
+    double totalCost = 0.;
+    for (pluint iBlock=0; iBlock<orderedBlocks.size(); ++iBlock) {
+        plint blockId = orderedBlocks[iBlock];
+        std::map<plint,double>::const_iterator itCost = blockCosts.find(blockId);
+        costs[iBlock] = itCost==blockCosts.end() ?
+                            (double)bulks.find(blockId)->second.nCells() : itCost->second;
+        totalCost += costs[iBlock];
+    }
+
+    // Each block goes to the process on whose segment of the curve the middle
+    //   of the block falls. The segments have the same length in terms of
+    //   cumulative cost.
+    ExplicitThreadAttribution* attribution = new ExplicitThreadAttribution;
+    double cumulativeCost = 0.;
+    for (pluint iBlock=0; iBlock<orderedBlocks.size(); ++iBlock) {
+        int proc = 0;
+        if (totalCost > 0.) {
+            proc = (int)( (cumulativeCost+0.5*costs[iBlock]) / totalCost * numProc );
+        }
+        else {
+            proc = (int)( iBlock*numProc / orderedBlocks.size() );
+        }
+        proc = std::max(0, std::min(numProc-1, proc));
+        attribution->addBlock(orderedBlocks[iBlock], proc);
+        cumulativeCost += costs[iBlock];
+    }
+    return attribution;
+}
+
+////////////////////// function createTopologyAwareAttribution /////////////////////
+
+static void attributeBlocksToProcesses (
+        std::map<plint,Box3D> const& bulks, std::vector<plint> const& blocks,
+        std::vector<std::pair<int,int> > const& processes,
+        ExplicitThreadAttribution& attribution )
+{
+    if (blocks.empty()) return;
+    if (processes.size()==1) {
+        for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+            attribution.addBlock(blocks[iBlock], processes[0].second);
+        }
+        return;
+    }
+
+    // Split the processes at the node boundary closest to the middle, or
+    //   at the middle if all of them are on the same node.
+    pluint middle = processes.size()/2;
+    pluint splitProc = middle;
+    bool onNodeBoundary = false;
+    for (pluint iProc=1; iProc<processes.size(); ++iProc) {
+        if (processes[iProc].first != processes[iProc-1].first) {
+            plint distance = std::abs((plint)iProc-(plint)middle);
+            if (!onNodeBoundary || distance < std::abs((plint)splitProc-(plint)middle)) {
+                splitProc = iProc;
+                onNodeBoundary = true;
+            }
+        }
+    }
+
+    // Split the blocks across the longest extent of their centers, in the
+    //   same proportion as the processes. Centers are counted twice to stay
+    //   with integers.
+    Array<plint,3> minCenter, maxCenter;
+    for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+        Box3D const& bulk = bulks.find(blocks[iBlock])->second;
+        Array<plint,3> center(bulk.x0+bulk.x1, bulk.y0+bulk.y1, bulk.z0+bulk.z1);
+        for (plint iD=0; iD<3; ++iD) {
+            if (iBlock==0 || center[iD]<minCenter[iD]) minCenter[iD] = center[iD];
+            if (iBlock==0 || center[iD]>maxCenter[iD]) maxCenter[iD] = center[iD];
+        }
+    }
+    plint axis = 0;
+    for (plint iD=1; iD<3; ++iD) {
+        if (maxCenter[iD]-minCenter[iD] > maxCenter[axis]-minCenter[axis]) {
+            axis = iD;
+        }
+    }
+    std::vector<std::pair<plint,plint> > sortedBlocks(blocks.size());
+    for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+        Box3D const& bulk = bulks.find(blocks[iBlock])->second;
+        Array<plint,3> center(bulk.x0+bulk.x1, bulk.y0+bulk.y1, bulk.z0+bulk.z1);
+        sortedBlocks[iBlock] = std::make_pair(center[axis], blocks[iBlock]);
+    }
+    std::sort(sortedBlocks.begin(), sortedBlocks.end());
+    pluint splitBlock = (blocks.size()*splitProc + processes.size()/2) / processes.size();
+
+    std::vector<plint> lowerBlocks, upperBlocks;
+    for (pluint iBlock=0; iBlock<sortedBlocks.size(); ++iBlock) {
+        if (iBlock<splitBlock) {
+            lowerBlocks.push_back(sortedBlocks[iBlock].second);
+        }
+        else {
+            upperBlocks.push_back(sortedBlocks[iBlock].second);
+        }
+    }
+    std::vector<std::pair<int,int> > lowerProcesses(processes.begin(), processes.begin()+splitProc);
+    std::vector<std::pair<int,int> > upperProcesses(processes.begin()+splitProc, processes.end());
+    attributeBlocksToProcesses(bulks, lowerBlocks, lowerProcesses, attribution);
+    attributeBlocksToProcesses(bulks, upperBlocks, upperProcesses, attribution);
+}
+
+ThreadAttribution* createTopologyAwareAttribution (
+        SparseBlockStructure3D const& blockStructure, int numProc )
+{
+    PLB_PRECONDITION( numProc>0 );
+    // Processes are grouped by node, and ordered by rank within a node.
+    std::vector<std::pair<int,int> > processes(numProc);
+    for (int iProc=0; iProc<numProc; ++iProc) {
+        int nodeId = iProc<global::mpi().getSize() ? global::mpi().getNodeId(iProc) : iProc;
+        processes[iProc] = std::make_pair(nodeId, iProc);
+    }
+    std::sort(processes.begin(), processes.end());
+
+    std::map<plint,Box3D> const& bulks = blockStructure.getBulks();
+    std::vector<plint> blocks;
+    std::map<plint,Box3D>::const_iterator it = bulks.begin();
+    for (; it != bulks.end(); ++it) {
+        blocks.push_back(it->first);
+    }
+    ExplicitThreadAttribution* attribution = new ExplicitThreadAttribution;
+    attributeBlocksToProcesses(bulks, blocks, processes, *attribution);
+    return attribution;
+}
+
+////////////////////// function createAdaptiveDistribution3D /////////////////////
+
+/// Number of active cells in a box whose coordinates are expressed in cubes. The
+///   box is shrunk to the bounding box of the cubes which contain active cells.
+static plint shrinkToActiveCubes(ScalarField3D<int> const& numActiveCells, Box3D& cubes)
+{
+    plint numActive = 0;
+    Box3D activeCubes;
+    for (plint iX=cubes.x0; iX<=cubes.x1; ++iX) {
+        for (plint iY=cubes.y0; iY<=cubes.y1; ++iY) {
+            for (plint iZ=cubes.z0; iZ<=cubes.z1; ++iZ) {
+                plint numActiveInCube = numActiveCells.get(iX,iY,iZ);
+                if (numActiveInCube>0) {
+                    if (numActive==0) {
+                        activeCubes = Box3D(iX,iX, iY,iY, iZ,iZ);
+                    }
+                    else {
+                        activeCubes = bound(activeCubes, Box3D(iX,iX, iY,iY, iZ,iZ));
+                    }
+                    numActive += numActiveInCube;
+                }
+            }
+        }
+    }
+    if (numActive>0) {
+        cubes = activeCubes;
+    }
+    return numActive;
+}
+
+/// Convert a box whose coordinates are expressed in cubes into cell coordinates.
+static Box3D cubesToCells(Box3D const& cubes, Box3D const& domain, plint cubeSize)
+{
+    return Box3D( domain.x0+cubes.x0*cubeSize, std::min(domain.x1, domain.x0+(cubes.x1+1)*cubeSize-1),
+                  domain.y0+cubes.y0*cubeSize, std::min(domain.y1, domain.y0+(cubes.y1+1)*cubeSize-1),
+                  domain.z0+cubes.z0*cubeSize, std::min(domain.z1, domain.z0+(cubes.z1+1)*cubeSize-1) );
+}
+
+/// Add a block to the octree, and register it as a candidate for splitting if it
+///   is larger than one cube and has inactive cells or too many active cells.
+static void addOctreeBlock (
+        Box3D const& cubes, plint numActive, Box3D const& domain, plint cubeSize, plint maxActive,
+        std::vector<Box3D>& blocks, std::vector<plint>& blockActive,
+        std::priority_queue<std::pair<plint,plint> >& candidates )
+{
+    plint blockId = (plint)blocks.size();
+    blocks.push_back(cubes);
+    blockActive.push_back(numActive);
+    if (cubes.nCells() > 1) {
+        plint numInactive = cubesToCells(cubes, domain, cubeSize).nCells() - numActive;
+        plint excess = std::max((plint)0, numActive-maxActive);
+        if (numInactive+excess > 0) {
+            candidates.push(std::make_pair(numInactive+excess, blockId));
+        }
+    }
+}
+
+/// Split a range of cubes into two halves, or keep it if it has a single cube.
+static std::vector<std::pair<plint,plint> > splitCubeRange(plint x0, plint x1)
+{
+    std::vector<std::pair<plint,plint> > halves;
+    if (x0<x1) {
+        plint middle = (x0+x1)/2;
+        halves.push_back(std::make_pair(x0, middle));
+        halves.push_back(std::make_pair(middle+1, x1));
+    }
+    else {
+        halves.push_back(std::make_pair(x0, x1));
+    }
+    return halves;
+}
+
+SparseBlockStructure3D createAdaptiveDistribution3D (
+        ScalarField3D<int> const& numActiveCells, Box3D const& domain, plint cubeSize,
+        plint numBlocks, std::map<plint,double>& blockCosts )
+{
+    PLB_PRECONDITION( cubeSize>0 && numBlocks>0 );
+    plint nx = numActiveCells.getNx();
+    plint ny = numActiveCells.getNy();
+    plint nz = numActiveCells.getNz();
+    PLB_PRECONDITION( nx==(domain.getNx()+cubeSize-1)/cubeSize &&
+                      ny==(domain.getNy()+cubeSize-1)/cubeSize &&
+                      nz==(domain.getNz()+cubeSize-1)/cubeSize );
+
+    Box3D allCubes(0, nx-1, 0, ny-1, 0, nz-1);
+    plint totalActive = shrinkToActiveCubes(numActiveCells, allCubes);
+    // If this assertion fails, that means that there are no active cells.
+    PLB_ASSERT( totalActive>0 );
+    plint maxActive = (totalActive+numBlocks-1) / numBlocks;
+
+    // Octree refinement. Each block is shrunk to its active cubes. All created blocks
+    //   are kept in the vector, and the ones which have been split are flagged.
+    std::vector<Box3D> blocks;
+    std::vector<plint> blockActive;
+    std::vector<bool> isLeaf;
+    std::priority_queue<std::pair<plint,plint> > candidates;
+    addOctreeBlock(allCubes, totalActive, domain, cubeSize, maxActive, blocks, blockActive, candidates);
+    isLeaf.push_back(true);
+    plint numLeaves = 1;
+    while (numLeaves<numBlocks && !candidates.empty()) {
+        plint parentId = candidates.top().second;
+        candidates.pop();
+        Box3D parent = blocks[parentId];
+        isLeaf[parentId] = false;
+        --numLeaves;
+        std::vector<std::pair<plint,plint> > rangesX = splitCubeRange(parent.x0, parent.x1);
+        std::vector<std::pair<plint,plint> > rangesY = splitCubeRange(parent.y0, parent.y1);
+        std::vector<std::pair<plint,plint> > rangesZ = splitCubeRange(parent.z0, parent.z1);
+        for (pluint iX=0; iX<rangesX.size(); ++iX) {
+            for (pluint iY=0; iY<rangesY.size(); ++iY) {
+                for (pluint iZ=0; iZ<rangesZ.size(); ++iZ) {
+                    Box3D child(rangesX[iX].first, rangesX[iX].second,
+                                rangesY[iY].first, rangesY[iY].second,
+                                rangesZ[iZ].first, rangesZ[iZ].second);
+                    plint numActive = shrinkToActiveCubes(numActiveCells, child);
+                    if (numActive>0) {
+                        addOctreeBlock(child, numActive, domain, cubeSize, maxActive,
+                                       blocks, blockActive, candidates);
+                        isLeaf.push_back(true);
+                        ++numLeaves;
+                    }
+                }
+            }
+        }
+    }
+
+    // Merge adjacent leaves without inactive cells, if their union is a box. The
+    //   leaves are found through the position of their lower corner.
+    std::map<plint,plint> leafAtCorner;
+    for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+        if (isLeaf[iBlock]) {
+            Box3D const& cubes = blocks[iBlock];
+            leafAtCorner[(cubes.x0*ny+cubes.y0)*nz+cubes.z0] = iBlock;
+        }
+    }
+    bool hasMerged = true;
+    while (hasMerged) {
+        hasMerged = false;
+        for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+            if (!isLeaf[iBlock] ||
+                cubesToCells(blocks[iBlock], domain, cubeSize).nCells() != blockActive[iBlock])
+            {
+                continue;
+            }
+            Box3D& cubes = blocks[iBlock];
+            Box3D upperNeighbors[3] = {
+                Box3D(cubes.x1+1, cubes.x1+1, cubes.y0, cubes.y1, cubes.z0, cubes.z1),
+                Box3D(cubes.x0, cubes.x1, cubes.y1+1, cubes.y1+1, cubes.z0, cubes.z1),
+                Box3D(cubes.x0, cubes.x1, cubes.y0, cubes.y1, cubes.z1+1, cubes.z1+1) };
+            for (plint iD=0; iD<3; ++iD) {
+                Box3D const& face = upperNeighbors[iD];
+                std::map<plint,plint>::iterator it =
+                    leafAtCorner.find((face.x0*ny+face.y0)*nz+face.z0);
+                if (it == leafAtCorner.end()) continue;
+                plint neighborId = it->second;
+                Box3D const& neighbor = blocks[neighborId];
+                bool sameFace =
+                    (iD==0 || (neighbor.x0==face.x0 && neighbor.x1==face.x1)) &&
+                    (iD==1 || (neighbor.y0==face.y0 && neighbor.y1==face.y1)) &&
+                    (iD==2 || (neighbor.z0==face.z0 && neighbor.z1==face.z1));
+                if ( sameFace &&
+                     cubesToCells(neighbor, domain, cubeSize).nCells() == blockActive[neighborId] &&
+                     blockActive[iBlock]+blockActive[neighborId] <= maxActive )
+                {
+                    cubes = Box3D( cubes.x0, std::max(cubes.x1, neighbor.x1),
+                                   cubes.y0, std::max(cubes.y1, neighbor.y1),
+                                   cubes.z0, std::max(cubes.z1, neighbor.z1) );
+                    blockActive[iBlock] += blockActive[neighborId];
+                    isLeaf[neighborId] = false;
+                    leafAtCorner.erase(it);
+                    hasMerged = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    SparseBlockStructure3D dataGeometry(domain);
+    blockCosts.clear();
+    for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+        if (isLeaf[iBlock]) {
+            plint blockId = dataGeometry.nextIncrementalId();
+            dataGeometry.addBlock(cubesToCells(blocks[iBlock], domain, cubeSize), blockId);
+            blockCosts[blockId] = (double)blockActive[iBlock];
+        }
+    }
+    return dataGeometry;
 }
 
 static void linearBlockRepartition(plint x0, plint x1,
@@ -33,30 +33,78 @@
 #include "core/globalDefs.h"
 #include "atomicBlock/dataField3D.h"
 #include "multiBlock/sparseBlockStructure3D.h"
+#include "multiBlock/threadAttribution.h"
+#include <map>
 
 namespace plb {
 
+/// Order of the blocks of a distribution, according to the position of their centers.
+namespace BlockOrdering {
+    /// lexicographic: the x-coordinate varies slowest and the z-coordinate fastest.
+    /// morton:        Z-order curve, by interleaving the bits of the coordinates.
+    /// hilbert:       Hilbert curve, whose consecutive blocks are neighbors (except for
+    ///                a few jumps if the numbers of blocks are not powers of two).
+    enum OrderingT {lexicographic, morton, hilbert};
+}
+
 /// A 3D field of scalar values used to indicate the type of the cells.
 /// Any positive value indicates an active (bulk, boundary) cell, 
 /// while zero indicates a non-active (no-dynamics) cell
 typedef ScalarField3D<unsigned char> CellTypeField3D;
 
 /// Create a regular data distribution confined by domain.
+/** The ids of the blocks are attributed in the specified order, which, with a
+ *  one-to-one or a linear thread attribution, also determines their process.
+ **/
 SparseBlockStructure3D createRegularDistribution3D (
-        plint nx, plint ny, plint nz, plint numBlocksX, plint numBlocksY, plint numBlocksZ );
+        plint nx, plint ny, plint nz, plint numBlocksX, plint numBlocksY, plint numBlocksZ,
+        BlockOrdering::OrderingT ordering = BlockOrdering::lexicographic );
 
 /// Create a nx-by-ny-by-nz data distribution
 SparseBlockStructure3D createRegularDistribution3D (
-        Box3D const& domain, plint numBlocksX, plint numBlocksY, plint numBlocksZ );
+        Box3D const& domain, plint numBlocksX, plint numBlocksY, plint numBlocksZ,
+        BlockOrdering::OrderingT ordering = BlockOrdering::lexicographic );
 
 /// Create a data distribution with regular blocks, as evenly distributed as possible
 SparseBlockStructure3D
     createRegularDistribution3D(plint nx, plint ny, plint nz,
-                                int numProc = global::mpi().getSize());
+                                int numProc = global::mpi().getSize(),
+                                BlockOrdering::OrderingT ordering = BlockOrdering::lexicographic);
 
 /// Create a data distribution with regular blocks, as evenly distributed as possible
 SparseBlockStructure3D createRegularDistribution3D(Box3D const& domain,
-                                                   int numProc = global::mpi().getSize());
+                                                   int numProc = global::mpi().getSize(),
+                                                   BlockOrdering::OrderingT ordering = BlockOrdering::lexicographic);
+
+/// Ids of the blocks of a distribution, sorted in the specified order.
+std::vector<plint> orderBlocks (
+        SparseBlockStructure3D const& blockStructure, BlockOrdering::OrderingT ordering );
+
+/// Attribute the blocks of a distribution to the MPI processes, in contiguous
+///   segments of a space-filling curve.
+/** The segments have approximately the same cost. The cost of a block is its
+ *  number of cells, unless it is listed in blockCosts. As opposed to
+ *  partitionBlockGraph(), the computational cost is almost linear in the
+ *  number of blocks, and remains small for hundreds of thousands of blocks.
+ *  The result is the same on all processes.
+ **/
+ThreadAttribution* createCurveAttribution (
+        SparseBlockStructure3D const& blockStructure,
+        BlockOrdering::OrderingT ordering = BlockOrdering::hilbert,
+        std::map<plint,double> const& blockCosts = std::map<plint,double>(),
+        int numProc = global::mpi().getSize() );
+
+/// Attribute the blocks of a distribution to the MPI processes, such that
+///   neighboring blocks are placed on processes of the same node.
+/** The blocks are split recursively across the longest extent of their
+ *  centers, and the processes at the node boundary closest to the middle,
+ *  in proportion to the number of processes of each part. With one block
+ *  per process, as produced by createRegularDistribution3D, each node
+ *  gets a compact set of blocks, and inter-node communication is reduced.
+ **/
+ThreadAttribution* createTopologyAwareAttribution (
+        SparseBlockStructure3D const& blockStructure,
+        int numProc = global::mpi().getSize() );
 
 /// Re-create a distribution by covering it with regular blocks.
 SparseBlockStructure3D reparallelize(SparseBlockStructure3D const& originalStructure,
@@ -96,6 +144,24 @@ SparseBlockStructure3D createYSlicedDistribution3D (
 SparseBlockStructure3D createZSlicedDistribution3D (
         CellTypeField3D const& cellTypeField );
 
+/// Create a data distribution whose blocks adapt to the location of the
+///   active cells.
+/** The domain is divided into cubes of cubeSize*cubeSize*cubeSize cells (the
+ *  last cube in each direction is truncated by the domain), and
+ *  numActiveCells(iX,iY,iZ) is the number of active cells in cube (iX,iY,iZ).
+ *  Starting from a single block, the blocks are recursively split into
+ *  octants, which are shrunk to the bounding box of their active cells (at
+ *  the resolution of the cubes). The blocks with most inactive cells, or with
+ *  more than their share of the active cells, are split first, until
+ *  approximately numBlocks blocks are obtained. Adjacent blocks without
+ *  inactive cells are then merged, as long as they don't exceed their share
+ *  of the active cells. The number of active cells of each block is written
+ *  into blockCosts.
+ **/
+SparseBlockStructure3D createAdaptiveDistribution3D (
+        ScalarField3D<int> const& numActiveCells, Box3D const& domain, plint cubeSize,
+        plint numBlocks, std::map<plint,double>& blockCosts );
+
 }  // namespace plb
 
 #endif  // STATIC_REPARTITIONS_3D_H
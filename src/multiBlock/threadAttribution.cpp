@@ -244,4 +244,25 @@ ThreadAttribution* ExplicitThreadAttribution::clone() const {
     return new ExplicitThreadAttribution(*this);
 }
 
+std::vector<std::vector<plint> > distributeOverLocalThreads (
+        std::vector<plint> const& blocks, ThreadAttribution const& attribution, int numThreads )
+{
+    PLB_PRECONDITION( numThreads>0 );
+    std::vector<std::vector<plint> > threadBlocks(numThreads);
+    bool explicitThreads = false;
+    for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+        if (attribution.getLocalThreadId(blocks[iBlock]) != 0) {
+            explicitThreads = true;
+            break;
+        }
+    }
+    for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+        plint threadId = explicitThreads ?
+                             attribution.getLocalThreadId(blocks[iBlock]) % numThreads :
+                             (plint)iBlock % numThreads;
+        threadBlocks[threadId].push_back(blocks[iBlock]);
+    }
+    return threadBlocks;
+}
+
 }  // namespace plb
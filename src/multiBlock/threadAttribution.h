@@ -131,6 +131,15 @@ private:
     std::map<plint,int> coProcessors;
 };
 
+/// Distribute blocks among the shared-memory threads of the current MPI process.
+/** If the thread attribution assigns different local thread ids to the blocks,
+ *  these ids are honoured (modulo numThreads). Otherwise, the blocks are
+ *  dealt out among the threads in a round-robin manner. The result has
+ *  one entry per thread.
+ **/
+std::vector<std::vector<plint> > distributeOverLocalThreads (
+        std::vector<plint> const& blocks, ThreadAttribution const& attribution, int numThreads );
+
 }  // namespace plb
 
 #endif  // THREAD_ATTRIBUTION_H
@@ -29,6 +29,7 @@
 #include "atomicBlock/dataProcessingFunctional3D.h"
 #include "multiBlock/multiContainerBlock3D.h"
 #include "multiBlock/multiDataField3D.h"
+#include "multiBlock/staticRepartitions3D.h"
 
 namespace plb {
 
@@ -47,9 +48,28 @@ private:
     plint numBlocksId;
 };
     
+/// Compute a management which excludes the blocks of a multi-block that have
+///   no active cell (see ComputeSparsityFunctional3D).
+/** With the default lexicographic ordering, the remaining blocks are attributed
+ *  to the processes in ranges of ids. Otherwise, each process gets a contiguous
+ *  segment of the specified space-filling curve, with a similar number of cells.
+ **/
 template<typename T>
 MultiBlockManagement3D computeSparseManagement (
-        MultiScalarField3D<T>& field, plint newEnvelopeWidth );
+        MultiScalarField3D<T>& field, plint newEnvelopeWidth,
+        BlockOrdering::OrderingT ordering = BlockOrdering::lexicographic );
+
+/// Adaptive version of computeSparseManagement(), in which the block size of the
+///   field is ignored (see createAdaptiveDistribution3D()).
+/** The blocks are built out of cubes of minBlockSize cells in each direction,
+ *  mixing active and inactive cells as little as possible, with approximately
+ *  numBlocksPerProc blocks per process. They are attributed to the processes
+ *  along a space-filling curve, balancing the number of active cells.
+ **/
+template<typename T>
+MultiBlockManagement3D computeAdaptiveSparseManagement (
+        MultiScalarField3D<T>& field, plint newEnvelopeWidth, plint numBlocksPerProc,
+        plint minBlockSize = 8, BlockOrdering::OrderingT ordering = BlockOrdering::hilbert );
 
 }  // namespace plb
 
@@ -105,7 +105,8 @@ pluint ComputeSparsityFunctional3D<T>::getNumBlocks() const {
 
 template<typename T>
 MultiBlockManagement3D computeSparseManagement (
-        MultiScalarField3D<T>& field, plint newEnvelopeWidth )
+        MultiScalarField3D<T>& field, plint newEnvelopeWidth,
+        BlockOrdering::OrderingT ordering )
 {
     MultiContainerBlock3D multiFlagBlock(field);
     std::vector<MultiBlock3D*> args;
@@ -163,19 +164,24 @@ MultiBlockManagement3D computeSparseManagement (
     // by the sparse block-structure is empty.
     PLB_ASSERT( newId>0 );
 
-    ExplicitThreadAttribution* newAttribution = new ExplicitThreadAttribution;
-    std::vector<std::pair<plint,plint> > ranges;
-    plint numRanges = std::min(newId, (plint)global::mpi().getSize());
-    util::linearRepartition(0, newId-1, numRanges, ranges);
-    
-    std::vector<plint> localBlocks;
-    for (pluint iProc=0; iProc<ranges.size(); ++iProc) {
-        for (plint blockId=ranges[iProc].first; blockId<=ranges[iProc].second; ++blockId) {
-            newAttribution -> addBlock(blockId, iProc);
-            if (iProc==(pluint)global::mpi().getRank()) {
-                localBlocks.push_back(blockId);
+    ThreadAttribution* newAttribution = 0;
+    if (ordering == BlockOrdering::lexicographic) {
+        ExplicitThreadAttribution* linearAttribution = new ExplicitThreadAttribution;
+        std::vector<std::pair<plint,plint> > ranges;
+        plint numRanges = std::min(newId, (plint)global::mpi().getSize());
+        util::linearRepartition(0, newId-1, numRanges, ranges);
+
+        for (pluint iProc=0; iProc<ranges.size(); ++iProc) {
+            for (plint blockId=ranges[iProc].first; blockId<=ranges[iProc].second; ++blockId) {
+                linearAttribution -> addBlock(blockId, iProc);
             }
         }
+        newAttribution = linearAttribution;
+    }
+    else {
+        // The remaining blocks are scattered through the domain: ranks get
+        //   contiguous segments of a space-filling curve instead of ranges of ids.
+        newAttribution = createCurveAttribution(newSparseBlock, ordering);
     }
 
     MultiBlockManagement3D newManagement (
@@ -185,6 +191,74 @@ MultiBlockManagement3D computeSparseManagement (
     return newManagement;
 }
 
+/* ******** computeAdaptiveSparseManagement ************************************ */
+
+template<typename T>
+MultiBlockManagement3D computeAdaptiveSparseManagement (
+        MultiScalarField3D<T>& field, plint newEnvelopeWidth, plint numBlocksPerProc,
+        plint minBlockSize, BlockOrdering::OrderingT ordering )
+{
+    PLB_PRECONDITION( numBlocksPerProc>0 && minBlockSize>0 );
+    Box3D domain = field.getBoundingBox();
+    plint nx = (domain.getNx()+minBlockSize-1) / minBlockSize;
+    plint ny = (domain.getNy()+minBlockSize-1) / minBlockSize;
+    plint nz = (domain.getNz()+minBlockSize-1) / minBlockSize;
+
+    // Count the active cells in each cube of minBlockSize cells.
+    MultiBlockManagement3D const& management = field.getMultiBlockManagement();
+    SparseBlockStructure3D const& sparseBlock = management.getSparseBlockStructure();
+    std::vector<plint> const& localBlocks = management.getLocalInfo().getBlocks();
+    std::vector<int> numActive(nx*ny*nz, 0);
+    for (pluint iBlock=0; iBlock<localBlocks.size(); ++iBlock) {
+        plint blockId = localBlocks[iBlock];
+        Box3D uniqueBulk;
+        sparseBlock.getUniqueBulk(blockId, uniqueBulk);
+        ScalarField3D<T> const& component = field.getComponent(blockId);
+        Dot3D location = component.getLocation();
+        for (plint iX=uniqueBulk.x0; iX<=uniqueBulk.x1; ++iX) {
+            plint cubeX = (iX-domain.x0) / minBlockSize;
+            for (plint iY=uniqueBulk.y0; iY<=uniqueBulk.y1; ++iY) {
+                plint cubeY = (iY-domain.y0) / minBlockSize;
+                for (plint iZ=uniqueBulk.z0; iZ<=uniqueBulk.z1; ++iZ) {
+                    plint cubeZ = (iZ-domain.z0) / minBlockSize;
+                    if (component.get(iX-location.x, iY-location.y, iZ-location.z) != 0) {
+                        ++numActive[(cubeX*ny+cubeY)*nz+cubeZ];
+                    }
+                }
+            }
+        }
+    }
+
+#ifdef PLB_MPI_PARALLEL
+    std::vector<int> tmp(numActive.size());
+    global::mpi().reduceVect(numActive, tmp, MPI_SUM);
+    global::mpi().bCast(&tmp[0], tmp.size());
+    tmp.swap(numActive);
+#endif
+
+    ScalarField3D<int> numActiveCells(nx, ny, nz);
+    for (plint cubeX=0; cubeX<nx; ++cubeX) {
+        for (plint cubeY=0; cubeY<ny; ++cubeY) {
+            for (plint cubeZ=0; cubeZ<nz; ++cubeZ) {
+                numActiveCells.get(cubeX,cubeY,cubeZ) = numActive[(cubeX*ny+cubeY)*nz+cubeZ];
+            }
+        }
+    }
+
+    std::map<plint,double> blockCosts;
+    SparseBlockStructure3D newSparseBlock = createAdaptiveDistribution3D (
+            numActiveCells, domain, minBlockSize,
+            numBlocksPerProc*global::mpi().getSize(), blockCosts );
+    ThreadAttribution* newAttribution =
+        createCurveAttribution(newSparseBlock, ordering, blockCosts);
+
+    MultiBlockManagement3D newManagement (
+            newSparseBlock, newAttribution,
+            newEnvelopeWidth,
+            management.getRefinementLevel() );
+    return newManagement;
+}
+
 }  // namespace plb
 
 #endif  // MAKE_SPARSE_3D_HH
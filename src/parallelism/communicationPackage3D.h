@@ -42,6 +42,9 @@ struct CommunicationInfo3D {
     int toProcessId;
     Box3D toDomain;
     Dot3D absoluteOffset;
+    /// Side of the bulk of the receiving block on which toDomain is located,
+    ///   in a communication of the data streamed into the envelopes.
+    Dot3D normal;
 };
 
 typedef std::vector<CommunicationInfo3D> CommunicationPackage3D;
@@ -29,6 +29,7 @@
 #ifdef PLB_MPI_PARALLEL
 
 #include "parallelism/mpiManager.h"
+#include "parallelism/smpManager.h"
 #include "core/plbDebug.h"
 #include "core/plbComplex.h"
 #include "core/plbComplex.hh"
@@ -41,7 +42,8 @@ namespace global {
 
 MpiManager::MpiManager()
     : ok(false),
-      responsibleForMpiMachine(false)
+      responsibleForMpiMachine(false),
+      useSharedMemory(true)
 { }
 
 MpiManager::~MpiManager() {
@@ -56,7 +58,17 @@ void MpiManager::init(int *argc, char ***argv, bool verbous) {
     if (verbous) {
         std::cerr << "Constructing an MPI thread" << std::endl;
     }
+#ifdef PLB_OPENMP
+    // MPI is only called outside of the parallel regions of the
+    //   shared-memory threads, hence the funneled thread support.
+    int threadSupport;
+    int ok1 = MPI_Init_thread(argc, argv, MPI_THREAD_FUNNELED, &threadSupport);
+    if (threadSupport < MPI_THREAD_FUNNELED) {
+        global::smp().disableThreads();
+    }
+#else
     int ok1 = MPI_Init(argc, argv);
+#endif
     // If I'm the one who calls MPI_Init, then I need to be
     // the one who calls MPI_Finalize.
     responsibleForMpiMachine = true;
@@ -64,6 +76,7 @@ void MpiManager::init(int *argc, char ***argv, bool verbous) {
     int ok2 = MPI_Comm_rank(getGlobalCommunicator(),&taskId);
     int ok3 = MPI_Comm_size(getGlobalCommunicator(),&numTasks);
     ok = (ok1==0 && ok2==0 && ok3==0);
+    initNodeCommunicator();
 }
 
 void MpiManager::init(MPI_Comm globalCommunicator_) {
@@ -71,6 +84,7 @@ void MpiManager::init(MPI_Comm globalCommunicator_) {
     int ok1 = MPI_Comm_rank(getGlobalCommunicator(),&taskId);
     int ok2 = MPI_Comm_size(getGlobalCommunicator(),&numTasks);
     ok = (ok1==0 && ok2==0);
+    initNodeCommunicator();
 }
 
 void MpiManager::init() {
@@ -102,6 +116,59 @@ MPI_Comm MpiManager::getGlobalCommunicator() const {
     return globalCommunicator;
 }
 
+void MpiManager::initNodeCommunicator() {
+    nodeRanks.assign(numTasks, -1);
+    nodeRanks[taskId] = 0;
+    nodeIds.resize(numTasks);
+    for (int iRank=0; iRank<numTasks; ++iRank) {
+        nodeIds[iRank] = iRank;
+    }
+    nodeSize = 1;
+    nodeCommunicator = MPI_COMM_SELF;
+    if (!ok) return;
+#ifdef PLB_MPI_SHARED_MEMORY
+    MPI_Comm_split_type(getGlobalCommunicator(), MPI_COMM_TYPE_SHARED, taskId,
+                        MPI_INFO_NULL, &nodeCommunicator);
+    MPI_Comm_size(nodeCommunicator, &nodeSize);
+    // The global ranks of the processes of the node, ordered by node rank.
+    std::vector<int> globalRanks(nodeSize);
+    MPI_Allgather(&taskId, 1, MPI_INT, &globalRanks[0], 1, MPI_INT, nodeCommunicator);
+    nodeRanks[taskId] = -1;
+    for (int iRank=0; iRank<nodeSize; ++iRank) {
+        nodeRanks[globalRanks[iRank]] = iRank;
+    }
+    // The processes are ordered by global rank in the node communicator.
+    int nodeId = globalRanks[0];
+    MPI_Allgather(&nodeId, 1, MPI_INT, &nodeIds[0], 1, MPI_INT, getGlobalCommunicator());
+#endif
+}
+
+MPI_Comm MpiManager::getNodeCommunicator() const {
+    return nodeCommunicator;
+}
+
+int MpiManager::getNodeSize() const {
+    return nodeSize;
+}
+
+int MpiManager::getNodeRank(int proc) const {
+    PLB_PRECONDITION( proc>=0 && proc<(int)nodeRanks.size() );
+    return nodeRanks[proc];
+}
+
+int MpiManager::getNodeId(int proc) const {
+    PLB_PRECONDITION( proc>=0 && proc<(int)nodeIds.size() );
+    return nodeIds[proc];
+}
+
+void MpiManager::toggleSharedMemory(bool useSharedMemory_) {
+    useSharedMemory = useSharedMemory_;
+}
+
+bool MpiManager::usesSharedMemory() const {
+    return useSharedMemory;
+}
+
 void MpiManager::barrier() {
     if (!ok) return;
     MPI_Barrier(getGlobalCommunicator());
@@ -2223,12 +2290,102 @@ void MpiManager::reduceAndBcast<Complex<__float128> >(Complex<__float128>& reduc
 }
 #endif
 
+void MpiManager::iAllReduce( void* sendBuf, void* recvBuf, int count,
+                             MPI_Datatype datatype, MPI_Op op, MPI_Request* request )
+{
+    *request = MPI_REQUEST_NULL;
+    if (!ok) return;
+#ifdef PLB_MPI_NONBLOCKING_COLLECTIVES
+    MPI_Iallreduce(sendBuf, recvBuf, count, datatype, op, getGlobalCommunicator(), request);
+#else
+    MPI_Allreduce(sendBuf, recvBuf, count, datatype, op, getGlobalCommunicator());
+#endif
+}
+
 void MpiManager::wait(MPI_Request* request, MPI_Status* status)
 {
     if (!ok) return;
     MPI_Wait(request, status);
 }
 
+void MpiManager::sendInit(char *buf, int count, int dest, MPI_Request* request, int tag)
+{
+    if (!ok) return;
+    MPI_Send_init(static_cast<void*>(buf), count, MPI_CHAR, dest, tag, getGlobalCommunicator(), request);
+}
+
+void MpiManager::recvInit(char *buf, int count, int source, MPI_Request* request, int tag)
+{
+    if (!ok) return;
+    MPI_Recv_init(static_cast<void*>(buf), count, MPI_CHAR, source, tag, getGlobalCommunicator(), request);
+}
+
+void MpiManager::start(MPI_Request* request)
+{
+    if (!ok) return;
+    MPI_Start(request);
+}
+
+void MpiManager::requestFree(MPI_Request* request)
+{
+    if (!ok || *request==MPI_REQUEST_NULL) return;
+    // Communicators can outlive the MPI machine, if they are destroyed
+    //   after the end of the main function.
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if (!finalized) {
+        MPI_Request_free(request);
+    }
+    *request = MPI_REQUEST_NULL;
+}
+
+#ifdef PLB_MPI_SHARED_MEMORY
+char* MpiManager::allocateShared(int size, MPI_Win* window)
+{
+    if (!ok) return 0;
+    char* memory = 0;
+    MPI_Win_allocate_shared(size, 1, MPI_INFO_NULL, getNodeCommunicator(), &memory, window);
+    // A passive-target epoch is kept open during the whole life time of the
+    //   window; the memory is synchronized with syncSharedMemory().
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, *window);
+    return memory;
+}
+
+char* MpiManager::querySharedMemory(MPI_Win window, int nodeRank)
+{
+    if (!ok) return 0;
+    MPI_Aint size;
+    int dispUnit;
+    char* memory = 0;
+    MPI_Win_shared_query(window, nodeRank, &size, &dispUnit, &memory);
+    return memory;
+}
+
+void MpiManager::syncSharedMemory(MPI_Win window)
+{
+    if (!ok) return;
+    MPI_Win_sync(window);
+}
+
+void MpiManager::freeShared(MPI_Win* window)
+{
+    if (!ok || *window==MPI_WIN_NULL) return;
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if (!finalized) {
+        MPI_Win_unlock_all(*window);
+        MPI_Win_free(window);
+    }
+    *window = MPI_WIN_NULL;
+}
+#endif
+
+void MpiManager::nodeBarrier()
+{
+    if (!ok) return;
+    MPI_Barrier(getNodeCommunicator());
+}
+
 }  // namespace global
 
 }  // namespace plb
@@ -35,6 +35,11 @@
 #include "mpi.h"
 #include <vector>
 #include <string>
+// Shared-memory windows are available from MPI-3 on.
+#if MPI_VERSION >= 3
+#define PLB_MPI_SHARED_MEMORY
+#define PLB_MPI_NONBLOCKING_COLLECTIVES
+#endif
 #endif
 
 
@@ -67,6 +72,21 @@ public:
     double getTime() const;
     /// Returns the global communicator for this program or library instance.
     MPI_Comm getGlobalCommunicator() const;
+    /// Returns the communicator of the processes which share the memory of the
+    ///   current node (with MPI-3), or a communicator with the current process only.
+    MPI_Comm getNodeCommunicator() const;
+    /// Returns the number of processes on the current node.
+    int getNodeSize() const;
+    /// Returns the rank of process proc in the node communicator, or -1 if
+    ///   proc is on another node.
+    int getNodeRank(int proc) const;
+    /// Returns an identifier of the node of process proc, which is the
+    ///   smallest rank of the processes on that node.
+    int getNodeId(int proc) const;
+    /// Whether processes of the same node communicate through shared memory
+    ///   where possible (default: true). Must be the same on all processes.
+    void toggleSharedMemory(bool useSharedMemory_);
+    bool usesSharedMemory() const;
 
     /// Synchronizes the processes
     void barrier();
@@ -142,9 +162,43 @@ public:
     template <typename T>
     void reduceAndBcast(T& reductVal, MPI_Op op, int root = 0 );
 
+    /// Element-per-element reduction of count elements of type datatype,
+    ///   non-blocking with MPI-3; result available on all MPI threads once
+    ///   the request is completed.
+    void iAllReduce( void* sendBuf, void* recvBuf, int count,
+                     MPI_Datatype datatype, MPI_Op op, MPI_Request* request );
+
     /// Complete a non-blocking MPI operation
     void wait(MPI_Request* request, MPI_Status* status);
 
+    /// Create a persistent request for sending the bytes at *buf
+    void sendInit( char *buf, int count, int dest, MPI_Request* request, int tag = 0 );
+
+    /// Create a persistent request for receiving the bytes at *buf
+    void recvInit( char *buf, int count, int source, MPI_Request* request, int tag = 0 );
+
+    /// Start a persistent request
+    void start(MPI_Request* request);
+
+    /// Free a persistent request; does nothing after the end of MPI
+    void requestFree(MPI_Request* request);
+
+#ifdef PLB_MPI_SHARED_MEMORY
+    /// Allocate size bytes of memory which are shared with the processes of the
+    ///   node; collective on the node communicator
+    char* allocateShared(int size, MPI_Win* window);
+    /// Address of the shared memory of the process nodeRank of the node
+    char* querySharedMemory(MPI_Win window, int nodeRank);
+    /// Make the memory operations on shared memory visible to the other processes
+    void syncSharedMemory(MPI_Win window);
+    /// Free shared memory; collective on the node communicator, and does nothing
+    ///   after the end of MPI.
+    void freeShared(MPI_Win* window);
+#endif
+
+    /// Synchronizes the processes of the node
+    void nodeBarrier();
+
 private:
     /// Implementation code for Scatter
     template <typename T>
@@ -158,11 +212,20 @@ private:
 private:
     MpiManager();
     ~MpiManager();
+    /// Create the node communicator, once the global communicator is known.
+    void initNodeCommunicator();
 private:
     int numTasks, taskId;
     bool ok;
     bool responsibleForMpiMachine;
     MPI_Comm globalCommunicator;
+    MPI_Comm nodeCommunicator;
+    int nodeSize;
+    /// Rank in the node communicator of each process, or -1 for other nodes.
+    std::vector<int> nodeRanks;
+    /// Node identifier of each process.
+    std::vector<int> nodeIds;
+    bool useSharedMemory;
 
 friend MpiManager& mpi();
 };
@@ -184,6 +247,8 @@ public:
     int bossId() const { return 0; }
     /// Tells whether current processor is main processor
     bool isMainProcessor() const { return true; }
+    /// Returns an identifier of the node of process proc
+    int getNodeId(int proc) const { return 0; }
     /// Broadcast data from one processor to multiple processors
     template <typename T>
     void bCast(T* sendBuf, int sendCount, int root = 0) { }
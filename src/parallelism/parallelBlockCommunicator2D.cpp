@@ -42,7 +42,7 @@ CommunicationStructure2D::CommunicationStructure2D (
         std::vector<Overlap2D> const& overlaps,
         MultiBlockManagement2D const& originManagement,
         MultiBlockManagement2D const& destinationManagement,
-        plint sizeOfCell )
+        plint sizeOfCell, bool shareOnNode )
 {
     plint fromEnvelopeWidth = originManagement.getEnvelopeWidth();
     plint toEnvelopeWidth = destinationManagement.getEnvelopeWidth();
@@ -101,6 +101,9 @@ CommunicationStructure2D::CommunicationStructure2D (
 
     sendComm = SendPoolCommunicator(sendPool);
     recvComm = RecvPoolCommunicator(recvPool);
+    if (shareOnNode) {
+        shareStaticMessagesOnNode(sendComm, recvComm);
+    }
 }
 
 ////////////////////// Class ParallelBlockCommunicator2D /////////////////////
@@ -156,7 +159,7 @@ void ParallelBlockCommunicator2D::duplicateOverlaps(MultiBlock2D& multiBlock, mo
         communication = new CommunicationStructure2D (
                                 overlaps,
                                 multiBlockManagement, multiBlockManagement,
-                                multiBlock.sizeOfCell() );
+                                multiBlock.sizeOfCell(), true );
     }
 
     communicate(*communication, multiBlock, multiBlock, whichData);
@@ -174,7 +177,7 @@ void ParallelBlockCommunicator2D::communicate (
             overlaps,
             originMultiBlock.getMultiBlockManagement(),
             destinationMultiBlock.getMultiBlockManagement(),
-            originMultiBlock.sizeOfCell() );
+            originMultiBlock.sizeOfCell(), false );
     global::profiler().start("mpiCommunication");
     communicate(communication, originMultiBlock, destinationMultiBlock, whichData);
     global::profiler().stop("mpiCommunication");
@@ -223,6 +226,7 @@ void ParallelBlockCommunicator2D::communicate (
 
     // 5. Finalize the sends.
     communication.sendComm.finalize(staticMessage);
+    communication.recvComm.finalize(staticMessage);
 }
 
 void ParallelBlockCommunicator2D::signalPeriodicity() const {
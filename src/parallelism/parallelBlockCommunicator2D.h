@@ -43,11 +43,14 @@ namespace plb {
 
 struct CommunicationStructure2D
 {
+    /// With shareOnNode, the static messages between processes of the same node go
+    ///   through shared memory (see shareStaticMessagesOnNode()). As its setup is
+    ///   collective on the node, this is only worth it for structures which are kept.
     CommunicationStructure2D (
             std::vector<Overlap2D> const& overlaps,
             MultiBlockManagement2D const& originManagement,
             MultiBlockManagement2D const& destinationManagement,
-            plint sizeOfCell );
+            plint sizeOfCell, bool shareOnNode );
     CommunicationPackage2D sendPackage;
     CommunicationPackage2D recvPackage;
     CommunicationPackage2D sendRecvPackage;
@@ -32,6 +32,7 @@
 #include "atomicBlock/atomicBlock3D.h"
 #include "core/plbDebug.h"
 #include "core/plbProfiler.h"
+#include "core/plbBlockProfiler.h"
 #include <algorithm>
 #ifdef PLB_MPI_PARALLEL
 #include <mpi.h>
@@ -41,53 +42,107 @@ namespace plb {
 
 #ifdef PLB_MPI_PARALLEL
 
-CommunicationStructure3D::CommunicationStructure3D (
-        std::vector<Overlap3D> const& overlaps,
+/// Compute the local domains and the processes of a communication between
+///   the blocks of an overlap.
+static CommunicationInfo3D computeCommunicationInfo (
+        Overlap3D const& overlap,
         MultiBlockManagement3D const& originManagement,
-        MultiBlockManagement3D const& destinationManagement,
-        plint sizeOfCell )
+        MultiBlockManagement3D const& destinationManagement )
 {
-    plint fromEnvelopeWidth = originManagement.getEnvelopeWidth();
-    plint toEnvelopeWidth = destinationManagement.getEnvelopeWidth();
     SparseBlockStructure3D const& fromSparseBlock
         = originManagement.getSparseBlockStructure();
     SparseBlockStructure3D const& toSparseBlock
         = destinationManagement.getSparseBlockStructure();
+    CommunicationInfo3D info;
+
+    info.fromBlockId = overlap.getOriginalId();
+    info.toBlockId   = overlap.getOverlapId();
+
+    SmartBulk3D originalBulk(fromSparseBlock, originManagement.getEnvelopeWidth(), info.fromBlockId);
+    SmartBulk3D overlapBulk(toSparseBlock, destinationManagement.getEnvelopeWidth(), info.toBlockId);
+
+    Box3D originalCoordinates(overlap.getOriginalCoordinates());
+    Box3D overlapCoordinates(overlap.getOverlapCoordinates());
+    info.fromDomain = originalBulk.toLocal(originalCoordinates);
+    info.toDomain   = overlapBulk.toLocal(overlapCoordinates);
+    info.absoluteOffset = Dot3D (
+            overlapCoordinates.x0 - originalCoordinates.x0,
+            overlapCoordinates.y0 - originalCoordinates.y0,
+            overlapCoordinates.z0 - originalCoordinates.z0 );
+    info.normal = Dot3D(0,0,0);
+
+    PLB_PRECONDITION(info.fromDomain.getNx() == info.toDomain.getNx());
+    PLB_PRECONDITION(info.fromDomain.getNy() == info.toDomain.getNy());
+    PLB_PRECONDITION(info.fromDomain.getNz() == info.toDomain.getNz());
+
+    ThreadAttribution const& fromAttribution = originManagement.getThreadAttribution();
+    ThreadAttribution const& toAttribution = destinationManagement.getThreadAttribution();
+    info.fromProcessId = fromAttribution.getMpiProcess(info.fromBlockId);
+    info.toProcessId   = toAttribution.getMpiProcess(info.toBlockId);
+    return info;
+}
 
-    SendRecvPool sendPool, recvPool;
-    for (pluint iOverlap=0; iOverlap<overlaps.size(); ++iOverlap) {
-        Overlap3D const& overlap = overlaps[iOverlap];
-        CommunicationInfo3D info;
-
-        info.fromBlockId = overlap.getOriginalId();
-        info.toBlockId   = overlap.getOverlapId();
-
-        SmartBulk3D originalBulk(fromSparseBlock, fromEnvelopeWidth, info.fromBlockId);
-        SmartBulk3D overlapBulk(toSparseBlock, toEnvelopeWidth, info.toBlockId);
-
-        Box3D originalCoordinates(overlap.getOriginalCoordinates());
-        Box3D overlapCoordinates(overlap.getOverlapCoordinates());
-        info.fromDomain = originalBulk.toLocal(originalCoordinates);
-        info.toDomain   = overlapBulk.toLocal(overlapCoordinates);
-        info.absoluteOffset = Dot3D (
-                overlapCoordinates.x0 - originalCoordinates.x0,
-                overlapCoordinates.y0 - originalCoordinates.y0,
-                overlapCoordinates.z0 - originalCoordinates.z0 );
-
-        plint lx = info.fromDomain.x1-info.fromDomain.x0+1;
-        plint ly = info.fromDomain.y1-info.fromDomain.y0+1;
-        plint lz = info.fromDomain.z1-info.fromDomain.z0+1;
-        PLB_PRECONDITION(lx == info.toDomain.x1-info.toDomain.x0+1);
-        PLB_PRECONDITION(ly == info.toDomain.y1-info.toDomain.y0+1);
-        PLB_PRECONDITION(lz == info.toDomain.z1-info.toDomain.z0+1);
+/// Split a communication into parts in which toDomain has a constant position
+///   with respect to the bulk of the receiving block (toBulk, in local coordinates).
+static void splitBySide (
+        CommunicationInfo3D const& info, Box3D const& toBulk,
+        CommunicationPackage3D& package )
+{
+    Box3D const& domain = info.toDomain;
+    plint lower[3]     = { domain.x0, domain.y0, domain.z0 };
+    plint upper[3]     = { domain.x1, domain.y1, domain.z1 };
+    plint bulkLower[3] = { toBulk.x0, toBulk.y0, toBulk.z0 };
+    plint bulkUpper[3] = { toBulk.x1, toBulk.y1, toBulk.z1 };
+    // Range of coordinates on the side -1, 0 and +1 of the bulk, along each axis.
+    plint from[3][3], to[3][3];
+    for (plint iD=0; iD<3; ++iD) {
+        from[iD][0] = lower[iD];
+        to[iD][0]   = std::min(upper[iD], bulkLower[iD]-1);
+        from[iD][1] = std::max(lower[iD], bulkLower[iD]);
+        to[iD][1]   = std::min(upper[iD], bulkUpper[iD]);
+        from[iD][2] = std::max(lower[iD], bulkUpper[iD]+1);
+        to[iD][2]   = upper[iD];
+    }
+    for (plint iX=0; iX<3; ++iX) {
+        for (plint iY=0; iY<3; ++iY) {
+            for (plint iZ=0; iZ<3; ++iZ) {
+                // Cells of the bulk are not part of the envelope.
+                if (iX==1 && iY==1 && iZ==1) continue;
+                if ( from[0][iX]>to[0][iX] ||
+                     from[1][iY]>to[1][iY] ||
+                     from[2][iZ]>to[2][iZ] ) continue;
+                CommunicationInfo3D part(info);
+                part.toDomain = Box3D(from[0][iX], to[0][iX], from[1][iY], to[1][iY],
+                                      from[2][iZ], to[2][iZ]);
+                part.fromDomain = part.toDomain.shift (
+                        info.fromDomain.x0-info.toDomain.x0,
+                        info.fromDomain.y0-info.toDomain.y0,
+                        info.fromDomain.z0-info.toDomain.z0 );
+                part.normal = Dot3D(iX-1, iY-1, iZ-1);
+                package.push_back(part);
+            }
+        }
+    }
+}
 
-        plint numberOfCells = lx*ly*lz;
+/// Sort the communications of the overlaps into remote sends, remote receives
+///   and local copies, and subscribe the messages of the remote ones.
+static void subscribeCommunications (
+        std::vector<Overlap3D> const& overlaps,
+        MultiBlockManagement3D const& originManagement,
+        MultiBlockManagement3D const& destinationManagement,
+        plint sizeOfCell,
+        CommunicationPackage3D& sendPackage, CommunicationPackage3D& recvPackage,
+        CommunicationPackage3D& sendRecvPackage,
+        SendRecvPool& sendPool, SendRecvPool& recvPool )
+{
+    for (pluint iOverlap=0; iOverlap<overlaps.size(); ++iOverlap) {
+        CommunicationInfo3D info = computeCommunicationInfo (
+                overlaps[iOverlap], originManagement, destinationManagement );
+        plint numberOfCells = info.fromDomain.nCells();
 
         ThreadAttribution const& fromAttribution = originManagement.getThreadAttribution();
         ThreadAttribution const& toAttribution = destinationManagement.getThreadAttribution();
-        info.fromProcessId = fromAttribution.getMpiProcess(info.fromBlockId);
-        info.toProcessId   = toAttribution.getMpiProcess(info.toBlockId);
-
         if ( fromAttribution.isLocal(info.fromBlockId) &&
              toAttribution.isLocal(info.toBlockId))
         {
@@ -104,11 +159,204 @@ CommunicationStructure3D::CommunicationStructure3D (
             recvPool.subscribeMessage(info.fromProcessId, numberOfCells*sizeOfCell);
         }
     }
+}
+
+/// Overlaps of the envelope of a multi-block, including the periodic ones
+///   which are currently active.
+static std::vector<Overlap3D> getEnvelopeOverlaps(MultiBlock3D const& multiBlock)
+{
+    LocalMultiBlockInfo3D const& localInfo = multiBlock.getMultiBlockManagement().getLocalInfo();
+    PeriodicitySwitch3D const& periodicity = multiBlock.periodicity();
+    std::vector<Overlap3D> overlaps(localInfo.getNormalOverlaps());
+    for (pluint iOverlap=0; iOverlap<localInfo.getPeriodicOverlaps().size(); ++iOverlap) {
+        PeriodicOverlap3D const& pOverlap = localInfo.getPeriodicOverlaps()[iOverlap];
+        if (periodicity.get(pOverlap.normalX,pOverlap.normalY,pOverlap.normalZ)) {
+            overlaps.push_back(pOverlap.overlap);
+        }
+    }
+    return overlaps;
+}
+
+/// Pack the content of the bulk cells into the messages of the remote sends.
+static void sendPackage (
+        CommunicationPackage3D const& package, MultiBlock3D const& originMultiBlock,
+        SendPoolCommunicator& sendComm, bool incoming, modif::ModifT whichData, bool staticMessage )
+{
+    global::BlockProfiler& blockProfiler = global::blockProfiler();
+    for (unsigned iSend=0; iSend<package.size(); ++iSend) {
+        CommunicationInfo3D const& info = package[iSend];
+        AtomicBlock3D const& fromBlock = originMultiBlock.getComponent(info.fromBlockId);
+        double startTime = blockProfiler.doProfiling() ? blockProfiler.getTime() : 0.;
+        if (incoming) {
+            fromBlock.getDataTransfer().sendIncoming (
+                    info.fromDomain, info.normal.x, info.normal.y, info.normal.z,
+                    sendComm.getStaticSendBuffer(info.toProcessId) );
+            sendComm.acceptStaticMessage(info.toProcessId);
+        }
+        else if (staticMessage) {
+            fromBlock.getDataTransfer().sendStatic (
+                    info.fromDomain, sendComm.getStaticSendBuffer(info.toProcessId) );
+            sendComm.acceptStaticMessage(info.toProcessId);
+        }
+        else {
+            fromBlock.getDataTransfer().send (
+                    info.fromDomain, sendComm.getSendBuffer(info.toProcessId), whichData );
+            sendComm.acceptMessage(info.toProcessId, staticMessage);
+        }
+        if (blockProfiler.doProfiling()) {
+            blockProfiler.add( originMultiBlock.getId(), info.fromBlockId, "envelopePacking",
+                               blockProfiler.getTime()-startTime, info.fromDomain.nCells() );
+        }
+    }
+}
+
+/// Execute the local copies, which require no communication.
+static void copyPackage (
+        CommunicationPackage3D const& package, MultiBlock3D const& originMultiBlock,
+        MultiBlock3D& destinationMultiBlock, modif::ModifT whichData )
+{
+    global::BlockProfiler& blockProfiler = global::blockProfiler();
+    for (unsigned iSendRecv=0; iSendRecv<package.size(); ++iSendRecv) {
+        CommunicationInfo3D const& info = package[iSendRecv];
+        AtomicBlock3D const& fromBlock = originMultiBlock.getComponent(info.fromBlockId);
+        AtomicBlock3D& toBlock = destinationMultiBlock.getComponent(info.toBlockId);
+        double startTime = blockProfiler.doProfiling() ? blockProfiler.getTime() : 0.;
+        plint deltaX = info.fromDomain.x0 - info.toDomain.x0;
+        plint deltaY = info.fromDomain.y0 - info.toDomain.y0;
+        plint deltaZ = info.fromDomain.z0 - info.toDomain.z0;
+        toBlock.getDataTransfer().attribute (
+                info.toDomain, deltaX, deltaY, deltaZ, fromBlock,
+                whichData, info.absoluteOffset );
+        if (blockProfiler.doProfiling()) {
+            blockProfiler.add( destinationMultiBlock.getId(), info.toBlockId, "envelopeCopy",
+                               blockProfiler.getTime()-startTime, info.toDomain.nCells() );
+        }
+    }
+}
+
+/// Unpack the messages of the remote receives into the overlaps.
+static void receivePackage (
+        CommunicationPackage3D const& package, MultiBlock3D& destinationMultiBlock,
+        RecvPoolCommunicator& recvComm, bool incoming, modif::ModifT whichData, bool staticMessage )
+{
+    global::BlockProfiler& blockProfiler = global::blockProfiler();
+    for (unsigned iRecv=0; iRecv<package.size(); ++iRecv) {
+        CommunicationInfo3D const& info = package[iRecv];
+        AtomicBlock3D& toBlock = destinationMultiBlock.getComponent(info.toBlockId);
+        double startTime;
+        // The messages are received before the timer is started, so that waiting
+        //   for them is not counted as unpacking.
+        if (incoming || staticMessage) {
+            char const* message = recvComm.receiveStaticMessage(info.fromProcessId);
+            startTime = blockProfiler.doProfiling() ? blockProfiler.getTime() : 0.;
+            if (incoming) {
+                toBlock.getDataTransfer().receiveIncoming (
+                        info.toDomain, info.normal.x, info.normal.y, info.normal.z,
+                        message, info.absoluteOffset );
+            }
+            else {
+                toBlock.getDataTransfer().receiveStatic (
+                        info.toDomain, message, info.absoluteOffset );
+            }
+        }
+        else {
+            std::vector<char> const& message = recvComm.receiveMessage(info.fromProcessId, staticMessage);
+            startTime = blockProfiler.doProfiling() ? blockProfiler.getTime() : 0.;
+            toBlock.getDataTransfer().receive (
+                    info.toDomain, message, whichData, info.absoluteOffset );
+        }
+        if (blockProfiler.doProfiling()) {
+            blockProfiler.add( destinationMultiBlock.getId(), info.toBlockId, "envelopeUnpacking",
+                               blockProfiler.getTime()-startTime, info.toDomain.nCells() );
+        }
+    }
+}
+
+CommunicationStructure3D::CommunicationStructure3D (
+        std::vector<Overlap3D> const& overlaps,
+        MultiBlockManagement3D const& originManagement,
+        MultiBlockManagement3D const& destinationManagement,
+        plint sizeOfCell, bool shareOnNode )
+    : incoming(false)
+{
+    SendRecvPool sendPool, recvPool;
+    subscribeCommunications( overlaps, originManagement, destinationManagement, sizeOfCell,
+                             sendPackage, recvPackage, sendRecvPackage, sendPool, recvPool );
+    sendComm = SendPoolCommunicator(sendPool);
+    recvComm = RecvPoolCommunicator(recvPool);
+    if (shareOnNode) {
+        shareStaticMessagesOnNode(sendComm, recvComm);
+    }
+}
+
+CommunicationStructure3D::CommunicationStructure3D (
+        std::vector<Overlap3D> const& overlaps, MultiBlock3D const& multiBlock )
+    : incoming(true)
+{
+    MultiBlockManagement3D const& management = multiBlock.getMultiBlockManagement();
+    ThreadAttribution const& attribution = management.getThreadAttribution();
+    SendRecvPool sendPool, recvPool;
+    for (pluint iOverlap=0; iOverlap<overlaps.size(); ++iOverlap) {
+        CommunicationInfo3D info = computeCommunicationInfo (
+                overlaps[iOverlap], management, management );
+        bool sends = attribution.isLocal(info.fromBlockId);
+        bool receives = attribution.isLocal(info.toBlockId);
+        if (sends && receives) {
+            // Local copies are cheap: they include all static data.
+            sendRecvPackage.push_back(info);
+            continue;
+        }
+        if (!sends && !receives) continue;
+        SmartBulk3D toBulk(management, info.toBlockId);
+        CommunicationPackage3D parts;
+        splitBySide(info, toBulk.toLocal(toBulk.getBulk()), parts);
+        for (pluint iPart=0; iPart<parts.size(); ++iPart) {
+            CommunicationInfo3D const& part = parts[iPart];
+            if (sends) {
+                BlockDataTransfer3D const& transfer
+                    = multiBlock.getComponent(part.fromBlockId).getDataTransfer();
+                sendPackage.push_back(part);
+                sendPool.subscribeMessage ( part.toProcessId, part.fromDomain.nCells() *
+                        transfer.incomingCellSize(part.normal.x, part.normal.y, part.normal.z) );
+            }
+            else {
+                BlockDataTransfer3D const& transfer
+                    = multiBlock.getComponent(part.toBlockId).getDataTransfer();
+                recvPackage.push_back(part);
+                recvPool.subscribeMessage ( part.fromProcessId, part.toDomain.nCells() *
+                        transfer.incomingCellSize(part.normal.x, part.normal.y, part.normal.z) );
+            }
+        }
+    }
 
     sendComm = SendPoolCommunicator(sendPool);
     recvComm = RecvPoolCommunicator(recvPool);
+    shareStaticMessagesOnNode(sendComm, recvComm);
 }
 
+/** The messages of all multi-blocks are subscribed one multi-block after the
+ *  other, in the same order on the sending and on the receiving process, and
+ *  are therefore aggregated into one message per pair of processes.
+ **/
+GroupCommunicationStructure3D::GroupCommunicationStructure3D (
+        std::vector<MultiBlock3D*> const& multiBlocks )
+    : sendPackages(multiBlocks.size()),
+      recvPackages(multiBlocks.size()),
+      sendRecvPackages(multiBlocks.size())
+{
+    SendRecvPool sendPool, recvPool;
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        MultiBlock3D const& multiBlock = *multiBlocks[iBlock];
+        MultiBlockManagement3D const& management = multiBlock.getMultiBlockManagement();
+        subscribeCommunications( getEnvelopeOverlaps(multiBlock), management, management,
+                                 multiBlock.sizeOfCell(),
+                                 sendPackages[iBlock], recvPackages[iBlock], sendRecvPackages[iBlock],
+                                 sendPool, recvPool );
+    }
+    sendComm = SendPoolCommunicator(sendPool);
+    recvComm = RecvPoolCommunicator(recvPool);
+    shareStaticMessagesOnNode(sendComm, recvComm);
+}
 
 
 CommunicationPattern3D::CommunicationPattern3D (
@@ -176,17 +424,26 @@ CommunicationPattern3D::CommunicationPattern3D (
 
 ParallelBlockCommunicator3D::ParallelBlockCommunicator3D()
     : overlapsModified(true),
-      communication(0)
+      communication(0),
+      incomingCommunication(0)
 { }
 
 ParallelBlockCommunicator3D::ParallelBlockCommunicator3D (
         ParallelBlockCommunicator3D const& rhs )
     : overlapsModified(true),
-      communication(0)
+      communication(0),
+      incomingCommunication(0)
 { }
 
 ParallelBlockCommunicator3D::~ParallelBlockCommunicator3D() {
     delete communication;
+    delete incomingCommunication;
+    for (pluint iTransfer=0; iTransfer<transferCommunications.size(); ++iTransfer) {
+        delete transferCommunications[iTransfer].communication;
+    }
+    for (pluint iGroup=0; iGroup<groupCommunications.size(); ++iGroup) {
+        delete groupCommunications[iGroup].communication;
+    }
 }
 
 ParallelBlockCommunicator3D& ParallelBlockCommunicator3D::operator= (
@@ -199,6 +456,9 @@ ParallelBlockCommunicator3D& ParallelBlockCommunicator3D::operator= (
 void ParallelBlockCommunicator3D::swap(ParallelBlockCommunicator3D& rhs) {
     std::swap(overlapsModified,rhs.overlapsModified);
     std::swap(communication,rhs.communication);
+    std::swap(incomingCommunication,rhs.incomingCommunication);
+    transferCommunications.swap(rhs.transferCommunications);
+    groupCommunications.swap(rhs.groupCommunications);
 }
 
 ParallelBlockCommunicator3D* ParallelBlockCommunicator3D::clone() const {
@@ -207,29 +467,61 @@ ParallelBlockCommunicator3D* ParallelBlockCommunicator3D::clone() const {
 
 void ParallelBlockCommunicator3D::duplicateOverlaps( MultiBlock3D& multiBlock,
                                                      modif::ModifT whichData ) const
+{
+    communicate(getOverlapCommunication(multiBlock, false), multiBlock, multiBlock, whichData);
+}
+
+void ParallelBlockCommunicator3D::startDuplicateOverlaps( MultiBlock3D& multiBlock,
+                                                          modif::ModifT whichData ) const
+{
+    startCommunication(getOverlapCommunication(multiBlock, false), multiBlock, whichData);
+}
+
+void ParallelBlockCommunicator3D::completeDuplicateOverlaps( MultiBlock3D& multiBlock,
+                                                             modif::ModifT whichData ) const
+{
+    PLB_ASSERT(communication != 0);
+    completeCommunication(*communication, multiBlock, multiBlock, whichData);
+}
+
+void ParallelBlockCommunicator3D::startDuplicateIncoming(MultiBlock3D& multiBlock) const
+{
+    startCommunication(getOverlapCommunication(multiBlock, true), multiBlock, modif::staticVariables);
+}
+
+void ParallelBlockCommunicator3D::completeDuplicateIncoming(MultiBlock3D& multiBlock) const
+{
+    PLB_ASSERT(incomingCommunication != 0);
+    completeCommunication(*incomingCommunication, multiBlock, multiBlock, modif::staticVariables);
+}
+
+CommunicationStructure3D& ParallelBlockCommunicator3D::getOverlapCommunication (
+        MultiBlock3D const& multiBlock, bool incoming ) const
 {
     MultiBlockManagement3D const& multiBlockManagement = multiBlock.getMultiBlockManagement();
-    PeriodicitySwitch3D const& periodicity             = multiBlock.periodicity();
 
-    // Implement a caching mechanism for the communication structure.
+    // Implement a caching mechanism for the communication structures.
     if (overlapsModified) {
         overlapsModified = false;
-        LocalMultiBlockInfo3D const& localInfo = multiBlockManagement.getLocalInfo();
-        std::vector<Overlap3D> overlaps(multiBlockManagement.getLocalInfo().getNormalOverlaps());
-        for (pluint iOverlap=0; iOverlap<localInfo.getPeriodicOverlaps().size(); ++iOverlap) {
-            PeriodicOverlap3D const& pOverlap = localInfo.getPeriodicOverlaps()[iOverlap];
-            if (periodicity.get(pOverlap.normalX,pOverlap.normalY,pOverlap.normalZ)) {
-                overlaps.push_back(pOverlap.overlap);
-            }
-        }
         delete communication;
-        communication = new CommunicationStructure3D (
-                                overlaps,
-                                multiBlockManagement, multiBlockManagement,
-                                multiBlock.sizeOfCell() );
+        communication = 0;
+        delete incomingCommunication;
+        incomingCommunication = 0;
     }
-
-    communicate(*communication, multiBlock, multiBlock, whichData);
+    CommunicationStructure3D*& cached = incoming ? incomingCommunication : communication;
+    if (!cached) {
+        std::vector<Overlap3D> overlaps(getEnvelopeOverlaps(multiBlock));
+        if (incoming) {
+            cached = new CommunicationStructure3D(overlaps, multiBlock);
+        }
+        else {
+            cached = new CommunicationStructure3D (
+                             overlaps,
+                             multiBlockManagement, multiBlockManagement,
+                             multiBlock.sizeOfCell(), true );
+        }
+    }
+    return *cached;
 }
 
 void ParallelBlockCommunicator3D::communicate (
@@ -240,59 +532,114 @@ void ParallelBlockCommunicator3D::communicate (
     PLB_PRECONDITION( originMultiBlock.sizeOfCell() ==
                       destinationMultiBlock.sizeOfCell() );
 
-    CommunicationStructure3D communication (
-            overlaps,
-            originMultiBlock.getMultiBlockManagement(),
-            destinationMultiBlock.getMultiBlockManagement(),
-            originMultiBlock.sizeOfCell() );
-    communicate(communication, originMultiBlock, destinationMultiBlock, whichData);
+    CommunicationStructure3D* cachedCommunication =
+        getTransferCommunication(overlaps, originMultiBlock, destinationMultiBlock);
+    if (cachedCommunication) {
+        communicate(*cachedCommunication, originMultiBlock, destinationMultiBlock, whichData);
+    }
+    else {
+        CommunicationStructure3D communication (
+                overlaps,
+                originMultiBlock.getMultiBlockManagement(),
+                destinationMultiBlock.getMultiBlockManagement(),
+                originMultiBlock.sizeOfCell(), false );
+        communicate(communication, originMultiBlock, destinationMultiBlock, whichData);
+    }
+}
+
+/** Transfers which are repeated, like the copy between two differently
+ *  distributed multi-blocks at each iteration, keep their communication
+ *  structure, and the buffers which come with it. One-time transfers, like
+ *  the initial copy into a new multi-block, are not worth the memory: a
+ *  communication structure is only kept from the second request of the
+ *  same transfer on. The same sequence of transfers is executed on all
+ *  processes, which therefore take the same decisions.
+ **/
+CommunicationStructure3D* ParallelBlockCommunicator3D::getTransferCommunication (
+        std::vector<Overlap3D> const& overlaps,
+        MultiBlock3D const& originMultiBlock,
+        MultiBlock3D const& destinationMultiBlock ) const
+{
+    static const pluint maxTransfers = 8;
+    id_t originDistribution = originMultiBlock.getMultiBlockManagement().getDistributionId();
+    id_t destinationDistribution = destinationMultiBlock.getMultiBlockManagement().getDistributionId();
+    plint sizeOfCell = originMultiBlock.sizeOfCell();
+
+    for (pluint iTransfer=0; iTransfer<transferCommunications.size(); ++iTransfer) {
+        TransferCommunication3D& transfer = transferCommunications[iTransfer];
+        if ( transfer.originDistribution == originDistribution &&
+             transfer.destinationDistribution == destinationDistribution &&
+             transfer.sizeOfCell == sizeOfCell &&
+             transfer.overlaps == overlaps )
+        {
+            if (!transfer.communication) {
+                transfer.communication = new CommunicationStructure3D (
+                        overlaps,
+                        originMultiBlock.getMultiBlockManagement(),
+                        destinationMultiBlock.getMultiBlockManagement(),
+                        sizeOfCell, true );
+            }
+            return transfer.communication;
+        }
+    }
+
+    if (transferCommunications.size() == maxTransfers) {
+        delete transferCommunications[0].communication;
+        transferCommunications.erase(transferCommunications.begin());
+    }
+    TransferCommunication3D transfer;
+    transfer.originDistribution = originDistribution;
+    transfer.destinationDistribution = destinationDistribution;
+    transfer.sizeOfCell = sizeOfCell;
+    transfer.overlaps = overlaps;
+    transfer.communication = 0;
+    transferCommunications.push_back(transfer);
+    return 0;
 }
 
 void ParallelBlockCommunicator3D::communicate (
         CommunicationStructure3D& communication,
         MultiBlock3D const& originMultiBlock,
         MultiBlock3D& destinationMultiBlock, modif::ModifT whichData ) const
+{
+    startCommunication(communication, originMultiBlock, whichData);
+    completeCommunication(communication, originMultiBlock, destinationMultiBlock, whichData);
+}
+
+void ParallelBlockCommunicator3D::startCommunication (
+        CommunicationStructure3D& communication,
+        MultiBlock3D const& originMultiBlock, modif::ModifT whichData ) const
 {
     global::profiler().start("mpiCommunication");
     bool staticMessage = whichData == modif::staticVariables;
     // 1. Non-blocking receives.
     communication.recvComm.startBeingReceptive(staticMessage);
 
-    // 2. Non-blocking sends.
-    for (unsigned iSend=0; iSend<communication.sendPackage.size(); ++iSend) {
-        CommunicationInfo3D const& info = communication.sendPackage[iSend];
-        AtomicBlock3D const& fromBlock = originMultiBlock.getComponent(info.fromBlockId);
-        fromBlock.getDataTransfer().send (
-                info.fromDomain, communication.sendComm.getSendBuffer(info.toProcessId),
-                whichData );
-        communication.sendComm.acceptMessage(info.toProcessId, staticMessage);
-    }
+    // 2. Non-blocking sends. Static data is packed in place, in the buffer
+    //    of the MPI communication.
+    sendPackage( communication.sendPackage, originMultiBlock, communication.sendComm,
+                 communication.incoming, whichData, staticMessage );
+    global::profiler().stop("mpiCommunication");
+}
 
+void ParallelBlockCommunicator3D::completeCommunication (
+        CommunicationStructure3D& communication,
+        MultiBlock3D const& originMultiBlock,
+        MultiBlock3D& destinationMultiBlock, modif::ModifT whichData ) const
+{
+    global::profiler().start("mpiCommunication");
+    bool staticMessage = whichData == modif::staticVariables;
     // 3. Local copies which require no communication.
-    for (unsigned iSendRecv=0; iSendRecv<communication.sendRecvPackage.size(); ++iSendRecv) {
-        CommunicationInfo3D const& info = communication.sendRecvPackage[iSendRecv];
-        AtomicBlock3D const& fromBlock = originMultiBlock.getComponent(info.fromBlockId);
-        AtomicBlock3D& toBlock = destinationMultiBlock.getComponent(info.toBlockId);
-        plint deltaX = info.fromDomain.x0 - info.toDomain.x0;
-        plint deltaY = info.fromDomain.y0 - info.toDomain.y0;
-        plint deltaZ = info.fromDomain.z0 - info.toDomain.z0;
-        toBlock.getDataTransfer().attribute (
-                info.toDomain, deltaX, deltaY, deltaZ, fromBlock,
-                whichData, info.absoluteOffset );
-    }
+    copyPackage( communication.sendRecvPackage, originMultiBlock, destinationMultiBlock, whichData );
 
-    // 4. Finalize the receives.
-    for (unsigned iRecv=0; iRecv<communication.recvPackage.size(); ++iRecv) {
-        CommunicationInfo3D const& info = communication.recvPackage[iRecv];
-        AtomicBlock3D& toBlock = destinationMultiBlock.getComponent(info.toBlockId);
-        toBlock.getDataTransfer().receive (
-                info.toDomain,
-                communication.recvComm.receiveMessage(info.fromProcessId, staticMessage),
-                whichData, info.absoluteOffset );
-    }
+    // 4. Finalize the receives. Static data is unpacked directly from the
+    //    buffer of the MPI communication.
+    receivePackage( communication.recvPackage, destinationMultiBlock, communication.recvComm,
+                    communication.incoming, whichData, staticMessage );
 
-    // 5. Finalize the sends.
+    // 5. Finalize the sends, and release the receive buffers.
     communication.sendComm.finalize(staticMessage);
+    communication.recvComm.finalize(staticMessage);
     global::profiler().stop("mpiCommunication");
 }
 
@@ -300,6 +647,81 @@ void ParallelBlockCommunicator3D::signalPeriodicity() const {
     overlapsModified = true;
 }
 
+bool ParallelBlockCommunicator3D::duplicateGroupOverlaps (
+        std::vector<MultiBlock3D*> const& multiBlocks,
+        std::vector<modif::ModifT> const& whichData ) const
+{
+    PLB_PRECONDITION( multiBlocks.size() == whichData.size() );
+    GroupCommunicationStructure3D& group = getGroupCommunication(multiBlocks);
+    // The static messages have a constant size only if all multi-blocks
+    //   exchange static data.
+    bool staticMessage = true;
+    for (pluint iBlock=0; iBlock<whichData.size(); ++iBlock) {
+        staticMessage = staticMessage && whichData[iBlock]==modif::staticVariables;
+    }
+
+    global::profiler().start("mpiCommunication");
+    group.recvComm.startBeingReceptive(staticMessage);
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        sendPackage( group.sendPackages[iBlock], *multiBlocks[iBlock], group.sendComm,
+                     false, whichData[iBlock], staticMessage );
+    }
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        copyPackage( group.sendRecvPackages[iBlock], *multiBlocks[iBlock],
+                     *multiBlocks[iBlock], whichData[iBlock] );
+    }
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        receivePackage( group.recvPackages[iBlock], *multiBlocks[iBlock], group.recvComm,
+                        false, whichData[iBlock], staticMessage );
+    }
+    group.sendComm.finalize(staticMessage);
+    group.recvComm.finalize(staticMessage);
+    global::profiler().stop("mpiCommunication");
+    return true;
+}
+
+/** A group is identified by its multi-blocks, their distribution and their
+ *  periodicity, which determine the overlaps. The same groups are requested
+ *  in the same order on all processes, which therefore take the same decisions.
+ **/
+GroupCommunicationStructure3D& ParallelBlockCommunicator3D::getGroupCommunication (
+        std::vector<MultiBlock3D*> const& multiBlocks ) const
+{
+    static const pluint maxGroups = 16;
+    id_t distribution = multiBlocks[0]->getMultiBlockManagement().getDistributionId();
+    std::vector<id_t> multiBlockIds(multiBlocks.size());
+    std::vector<bool> periodicity(3*multiBlocks.size());
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        PLB_ASSERT( multiBlocks[iBlock]->getMultiBlockManagement().getDistributionId() == distribution );
+        multiBlockIds[iBlock] = multiBlocks[iBlock]->getId();
+        for (plint iDim=0; iDim<3; ++iDim) {
+            periodicity[3*iBlock+iDim] = multiBlocks[iBlock]->periodicity().get(iDim);
+        }
+    }
+
+    for (pluint iGroup=0; iGroup<groupCommunications.size(); ++iGroup) {
+        GroupCommunication3D const& group = groupCommunications[iGroup];
+        if ( group.distribution == distribution &&
+             group.multiBlockIds == multiBlockIds &&
+             group.periodicity == periodicity )
+        {
+            return *group.communication;
+        }
+    }
+
+    if (groupCommunications.size() == maxGroups) {
+        delete groupCommunications[0].communication;
+        groupCommunications.erase(groupCommunications.begin());
+    }
+    GroupCommunication3D group;
+    group.distribution = distribution;
+    group.multiBlockIds = multiBlockIds;
+    group.periodicity = periodicity;
+    group.communication = new GroupCommunicationStructure3D(multiBlocks);
+    groupCommunications.push_back(group);
+    return *group.communication;
+}
+
 
 
 ////////////////////// Class BlockingCommunicator3D /////////////////////
@@ -54,11 +54,22 @@ struct CommunicationPattern3D
 
 struct CommunicationStructure3D
 {
+    /// With shareOnNode, the static messages between processes of the same node go
+    ///   through shared memory (see shareStaticMessagesOnNode()). As its setup is
+    ///   collective on the node, this is only worth it for structures which are kept.
     CommunicationStructure3D (
             std::vector<Overlap3D> const& overlaps,
             MultiBlockManagement3D const& originManagement,
             MultiBlockManagement3D const& destinationManagement,
-            plint sizeOfCell );
+            plint sizeOfCell, bool shareOnNode );
+    /// Update of the envelopes of a multi-block with the static data streamed into them.
+    /** The remote communications are split into parts with a constant position with
+     *  respect to the bulk of the receiving block (see BlockDataTransfer3D::sendIncoming()).
+     **/
+    CommunicationStructure3D (
+            std::vector<Overlap3D> const& overlaps,
+            MultiBlock3D const& multiBlock );
+    bool incoming;
     CommunicationPackage3D sendPackage;
     CommunicationPackage3D recvPackage;
     CommunicationPackage3D sendRecvPackage;
@@ -66,6 +77,19 @@ struct CommunicationStructure3D
     RecvPoolCommunicator recvComm;
 };
 
+/// Update of the envelopes of several multi-blocks with the same distribution,
+///   with a single message per pair of processes.
+struct GroupCommunicationStructure3D
+{
+    GroupCommunicationStructure3D(std::vector<MultiBlock3D*> const& multiBlocks);
+    /// Communications of each multi-block, in the order of the group.
+    std::vector<CommunicationPackage3D> sendPackages;
+    std::vector<CommunicationPackage3D> recvPackages;
+    std::vector<CommunicationPackage3D> sendRecvPackages;
+    SendPoolCommunicator sendComm;
+    RecvPoolCommunicator recvComm;
+};
+
 
 class ParallelBlockCommunicator3D : public BlockCommunicator3D {
 public:
@@ -77,21 +101,67 @@ public:
     void swap(ParallelBlockCommunicator3D& rhs);
     virtual ParallelBlockCommunicator3D* clone() const;
     virtual void duplicateOverlaps(MultiBlock3D& multiBlock, modif::ModifT whichData) const;
+    virtual void startDuplicateOverlaps(MultiBlock3D& multiBlock, modif::ModifT whichData) const;
+    virtual void completeDuplicateOverlaps(MultiBlock3D& multiBlock, modif::ModifT whichData) const;
+    virtual void startDuplicateIncoming(MultiBlock3D& multiBlock) const;
+    virtual void completeDuplicateIncoming(MultiBlock3D& multiBlock) const;
+    virtual bool duplicateGroupOverlaps( std::vector<MultiBlock3D*> const& multiBlocks,
+                                         std::vector<modif::ModifT> const& whichData ) const;
     virtual void communicate( std::vector<Overlap3D> const& overlaps,
                               MultiBlock3D const& originMultiBlock,
                               MultiBlock3D& destinationMultiBlock,
                               modif::ModifT whichData ) const;
     virtual void signalPeriodicity() const;
 private:
+    /// Communication structure of duplicateOverlaps(), or of startDuplicateIncoming(),
+    ///   re-created when the overlaps are modified.
+    CommunicationStructure3D& getOverlapCommunication(MultiBlock3D const& multiBlock, bool incoming) const;
+    /// Communication structure of communicate(), or 0 if it is not cached.
+    CommunicationStructure3D* getTransferCommunication (
+            std::vector<Overlap3D> const& overlaps,
+            MultiBlock3D const& originMultiBlock,
+            MultiBlock3D const& destinationMultiBlock ) const;
+    /// Communication structure of duplicateGroupOverlaps().
+    GroupCommunicationStructure3D& getGroupCommunication (
+            std::vector<MultiBlock3D*> const& multiBlocks ) const;
     void communicate( CommunicationStructure3D& communication,
                       MultiBlock3D const& originMultiBlock,
                       MultiBlock3D& destinationMultiBlock, modif::ModifT whichData ) const;
+    /// Non-blocking receives and sends of communicate().
+    void startCommunication( CommunicationStructure3D& communication,
+                             MultiBlock3D const& originMultiBlock, modif::ModifT whichData ) const;
+    /// Local copies and completion of the receives and the sends of communicate().
+    void completeCommunication( CommunicationStructure3D& communication,
+                                MultiBlock3D const& originMultiBlock,
+                                MultiBlock3D& destinationMultiBlock, modif::ModifT whichData ) const;
     void subscribeOverlap (
         Overlap3D const& overlap, MultiBlockManagement3D const& multiBlockManagement,
         SendRecvPool& sendPool, SendRecvPool& recvPool, plint sizeOfCell ) const;
+private:
+    /// Communication pattern of a transfer from another multi-block.
+    struct TransferCommunication3D {
+        id_t originDistribution, destinationDistribution;
+        plint sizeOfCell;
+        std::vector<Overlap3D> overlaps;
+        /// Null as long as the transfer has been requested only once.
+        CommunicationStructure3D* communication;
+    };
+    /// Communication pattern of a group of multi-blocks.
+    struct GroupCommunication3D {
+        id_t distribution;
+        std::vector<id_t> multiBlockIds;
+        /// Periodicity of each multi-block along the three axes.
+        std::vector<bool> periodicity;
+        GroupCommunicationStructure3D* communication;
+    };
 private:
     mutable bool overlapsModified;
     mutable CommunicationStructure3D* communication;
+    mutable CommunicationStructure3D* incomingCommunication;
+    /// Latest transfers of communicate(), in the order of their first request.
+    mutable std::vector<TransferCommunication3D> transferCommunications;
+    /// Groups of duplicateGroupOverlaps(), in the order of their first request.
+    mutable std::vector<GroupCommunication3D> groupCommunications;
 };
 
 
@@ -27,61 +27,186 @@
  */
 #include "parallelism/mpiManager.h"
 #include "parallelism/parallelStatistics.h"
+#include "core/plbDebug.h"
+#include "core/util.h"
+#include <algorithm>
 #include <cmath>
 
 namespace plb {
 
 #ifdef PLB_MPI_PARALLEL
 
-ParallelCombinedStatistics* ParallelCombinedStatistics::clone() const
+/// Reduction operator for packed observables. Each element is a pair
+///   (value, isMax), and the values are either summed or maximized.
+static void reducePackedObservables(void* inVec, void* inOutVec, int* length, MPI_Datatype* datatype)
 {
-    return new ParallelCombinedStatistics(*this);
+    double const* in = static_cast<double const*>(inVec);
+    double* inOut = static_cast<double*>(inOutVec);
+    for (int iElement=0; iElement<*length; ++iElement) {
+        if (in[2*iElement+1] > 0.5) {
+            inOut[2*iElement] = std::max(inOut[2*iElement], in[2*iElement]);
+        }
+        else {
+            inOut[2*iElement] += in[2*iElement];
+        }
+    }
 }
 
-void ParallelCombinedStatistics::reduceStatistics (
+static MPI_Datatype packedObservableType() {
+    static MPI_Datatype datatype = MPI_DATATYPE_NULL;
+    if (datatype == MPI_DATATYPE_NULL) {
+        MPI_Type_contiguous(2, MPI_DOUBLE, &datatype);
+        MPI_Type_commit(&datatype);
+    }
+    return datatype;
+}
+
+static MPI_Op packedObservableOp() {
+    static MPI_Op op = MPI_OP_NULL;
+    if (op == MPI_OP_NULL) {
+        MPI_Op_create(&reducePackedObservables, 1, &op);
+    }
+    return op;
+}
+
+static void packObservables (
+            std::vector<double> const& averageObservables,
+            std::vector<double> const& sumWeights,
+            std::vector<double> const& sumObservables,
+            std::vector<double> const& maxObservables,
+            std::vector<plint> const& intSumObservables,
+            std::vector<double>& buffer )
+{
+    buffer.clear();
+    // Averages are reduced through the weighted sum and the sum of weights.
+    for (pluint iAverage=0; iAverage<averageObservables.size(); ++iAverage) {
+        buffer.push_back(averageObservables[iAverage]*sumWeights[iAverage]);
+        buffer.push_back(0.);
+        buffer.push_back(sumWeights[iAverage]);
+        buffer.push_back(0.);
+    }
+    for (pluint iSum=0; iSum<sumObservables.size(); ++iSum) {
+        buffer.push_back(sumObservables[iSum]);
+        buffer.push_back(0.);
+    }
+    for (pluint iMax=0; iMax<maxObservables.size(); ++iMax) {
+        buffer.push_back(maxObservables[iMax]);
+        buffer.push_back(1.);
+    }
+    // Integer sums are exact in double precision up to 2^53.
+    for (pluint iSum=0; iSum<intSumObservables.size(); ++iSum) {
+        buffer.push_back((double)intSumObservables[iSum]);
+        buffer.push_back(0.);
+    }
+}
+
+static void unpackObservables (
+            std::vector<double> const& buffer,
             std::vector<double>& averageObservables,
             std::vector<double>& sumWeights,
             std::vector<double>& sumObservables,
             std::vector<double>& maxObservables,
-            std::vector<plint>& intSumObservables ) const
+            std::vector<plint>& intSumObservables )
 {
-    // Averages
+    pluint pos=0;
     for (pluint iAverage=0; iAverage<averageObservables.size(); ++iAverage) {
-        double globalAverage, globalWeight;
-        global::mpi().reduce(averageObservables[iAverage]*sumWeights[iAverage], globalAverage, MPI_SUM);
-        global::mpi().reduce(sumWeights[iAverage], globalWeight, MPI_SUM);
-        if (global::mpi().isMainProcessor() && std::fabs(globalWeight) > 0.5) {
+        double globalAverage = buffer[pos];
+        double globalWeight = buffer[pos+2];
+        if (std::fabs(globalWeight) > 0.5) {
             globalAverage /= globalWeight;
         }
-        global::mpi().bCast(&globalAverage, 1);
         averageObservables[iAverage] = globalAverage;
+        sumWeights[iAverage] = globalWeight;
+        pos += 4;
     }
-
-    // Sum
     for (pluint iSum=0; iSum<sumObservables.size(); ++iSum) {
-        double globalSum;
-        global::mpi().reduce(sumObservables[iSum], globalSum, MPI_SUM);
-        global::mpi().bCast(&globalSum, 1);
-        sumObservables[iSum] = globalSum;
+        sumObservables[iSum] = buffer[pos];
+        pos += 2;
     }
-
-    // Max
     for (pluint iMax=0; iMax<maxObservables.size(); ++iMax) {
-        double globalMax;
-        global::mpi().reduce(maxObservables[iMax], globalMax, MPI_MAX);
-        global::mpi().bCast(&globalMax, 1);
-        maxObservables[iMax] = globalMax;
+        maxObservables[iMax] = buffer[pos];
+        pos += 2;
     }
-
-    // Integer sum
     for (pluint iSum=0; iSum<intSumObservables.size(); ++iSum) {
-        plint globalSum;
-        global::mpi().reduce(intSumObservables[iSum], globalSum, MPI_SUM);
-        global::mpi().bCast(&globalSum, 1);
-        intSumObservables[iSum] = globalSum;
+        intSumObservables[iSum] = util::roundToInt(buffer[pos]);
+        pos += 2;
     }
 }
 
+ParallelCombinedStatistics::ParallelCombinedStatistics()
+    : request(MPI_REQUEST_NULL)
+{ }
+
+ParallelCombinedStatistics::ParallelCombinedStatistics(ParallelCombinedStatistics const& rhs)
+    : CombinedStatistics(rhs),
+      request(MPI_REQUEST_NULL)
+{ }
+
+ParallelCombinedStatistics::~ParallelCombinedStatistics()
+{
+    // The reduction is collective: it cannot be cancelled, only completed.
+    if (request != MPI_REQUEST_NULL) {
+        MPI_Status status;
+        global::mpi().wait(&request, &status);
+    }
+}
+
+ParallelCombinedStatistics* ParallelCombinedStatistics::clone() const
+{
+    return new ParallelCombinedStatistics(*this);
+}
+
+void ParallelCombinedStatistics::reduceStatistics (
+            std::vector<double>& averageObservables,
+            std::vector<double>& sumWeights,
+            std::vector<double>& sumObservables,
+            std::vector<double>& maxObservables,
+            std::vector<plint>& intSumObservables ) const
+{
+    std::vector<double> localBuffer, globalBuffer;
+    packObservables( averageObservables, sumWeights, sumObservables,
+                     maxObservables, intSumObservables, localBuffer );
+    if (localBuffer.empty()) return;
+    globalBuffer.resize(localBuffer.size());
+    MPI_Request localRequest;
+    global::mpi().iAllReduce( &localBuffer[0], &globalBuffer[0], localBuffer.size()/2,
+                              packedObservableType(), packedObservableOp(), &localRequest );
+    MPI_Status status;
+    global::mpi().wait(&localRequest, &status);
+    unpackObservables( globalBuffer, averageObservables, sumWeights, sumObservables,
+                       maxObservables, intSumObservables );
+}
+
+void ParallelCombinedStatistics::startReduction (
+            std::vector<double>& averageObservables,
+            std::vector<double>& sumWeights,
+            std::vector<double>& sumObservables,
+            std::vector<double>& maxObservables,
+            std::vector<plint>& intSumObservables )
+{
+    PLB_PRECONDITION( request == MPI_REQUEST_NULL );
+    packObservables( averageObservables, sumWeights, sumObservables,
+                     maxObservables, intSumObservables, sendBuffer );
+    recvBuffer.resize(sendBuffer.size());
+    if (sendBuffer.empty()) return;
+    global::mpi().iAllReduce( &sendBuffer[0], &recvBuffer[0], sendBuffer.size()/2,
+                              packedObservableType(), packedObservableOp(), &request );
+}
+
+void ParallelCombinedStatistics::completeReduction (
+            std::vector<double>& averageObservables,
+            std::vector<double>& sumWeights,
+            std::vector<double>& sumObservables,
+            std::vector<double>& maxObservables,
+            std::vector<plint>& intSumObservables )
+{
+    if (recvBuffer.empty()) return;
+    MPI_Status status;
+    global::mpi().wait(&request, &status);
+    unpackObservables( recvBuffer, averageObservables, sumWeights, sumObservables,
+                       maxObservables, intSumObservables );
+}
+
 #endif  // PLB_MPI_PARALLEL
 
 }  // namespace plb
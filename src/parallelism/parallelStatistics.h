@@ -36,8 +36,17 @@ namespace plb {
 
 #ifdef PLB_MPI_PARALLEL
 
+/// Reduction of the statistics across MPI processes.
+/** All observables are packed into a single buffer, and reduced with a
+ *  single collective operation. In the split-phase version, this operation
+ *  is non-blocking (with MPI-3) and is only completed when the result is
+ *  needed.
+ **/
 class ParallelCombinedStatistics : public CombinedStatistics {
 public:
+    ParallelCombinedStatistics();
+    ParallelCombinedStatistics(ParallelCombinedStatistics const& rhs);
+    ~ParallelCombinedStatistics();
     virtual ParallelCombinedStatistics* clone() const;
 protected:
     virtual void reduceStatistics (
@@ -46,6 +55,21 @@ protected:
             std::vector<double>& sumObservables,
             std::vector<double>& maxObservables,
             std::vector<plint>& intSumObservables ) const;
+    virtual void startReduction (
+            std::vector<double>& averageObservables,
+            std::vector<double>& sumWeights,
+            std::vector<double>& sumObservables,
+            std::vector<double>& maxObservables,
+            std::vector<plint>& intSumObservables );
+    virtual void completeReduction (
+            std::vector<double>& averageObservables,
+            std::vector<double>& sumWeights,
+            std::vector<double>& sumObservables,
+            std::vector<double>& maxObservables,
+            std::vector<plint>& intSumObservables );
+private:
+    std::vector<double> sendBuffer, recvBuffer;
+    MPI_Request request;
 };
  
 #endif  // PLB_MPI_PARALLEL
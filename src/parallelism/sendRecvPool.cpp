@@ -36,12 +36,40 @@ namespace plb {
 
 #ifdef PLB_MPI_PARALLEL
 
+SendPoolCommunicator::SendPoolCommunicator()
+    : sharedWindow(MPI_WIN_NULL)
+{ }
+
 SendPoolCommunicator::SendPoolCommunicator(SendRecvPool const& pool)
-    : subscriptions(pool.begin(), pool.end())
+    : subscriptions(pool.begin(), pool.end()),
+      sharedWindow(MPI_WIN_NULL)
 {
     //PLB_PRECONDITION(!pool.empty());
 }
 
+SendPoolCommunicator::SendPoolCommunicator(SendPoolCommunicator const& rhs)
+    : subscriptions(rhs.subscriptions),
+      sharedWindow(MPI_WIN_NULL)
+{ }
+
+SendPoolCommunicator& SendPoolCommunicator::operator=(SendPoolCommunicator const& rhs) {
+    if (this != &rhs) {
+        subscriptions = rhs.subscriptions;
+#ifdef PLB_MPI_SHARED_MEMORY
+        global::mpi().freeShared(&sharedWindow);
+#endif
+    }
+    return *this;
+}
+
+SendPoolCommunicator::~SendPoolCommunicator() {
+    // The entries refer to the shared memory: they are deleted first.
+    subscriptions.clear();
+#ifdef PLB_MPI_SHARED_MEMORY
+    global::mpi().freeShared(&sharedWindow);
+#endif
+}
+
 std::vector<char>& SendPoolCommunicator::getSendBuffer(int toProc) {
     std::map<int,CommunicatorEntry>::iterator entryPtr = subscriptions.find(toProc);
     PLB_ASSERT( entryPtr != subscriptions.end() );
@@ -69,14 +97,68 @@ void SendPoolCommunicator::acceptMessage(int toProc, bool staticMessage)
     }
 }
 
+char* SendPoolCommunicator::getStaticSendBuffer(int toProc) {
+    std::map<int,CommunicatorEntry>::iterator entryPtr = subscriptions.find(toProc);
+    PLB_ASSERT( entryPtr != subscriptions.end() );
+    CommunicatorEntry& entry = entryPtr->second;
+    PLB_ASSERT( entry.currentMessage < (int)entry.messages.size() );
+    if (entry.currentMessage==0) {
+        getStaticBuffer(entry);
+    }
+    if (entry.lengths[entry.currentMessage]==0) {
+        return 0;
+    }
+    char* buffer = entry.sharedData ? entry.sharedData : &entry.staticData[0];
+    return buffer + entry.offsets[entry.currentMessage];
+}
+
+char* SendPoolCommunicator::getStaticBuffer(CommunicatorEntry& entry) {
+    // Empty messages are neither sent nor received.
+    if (entry.cumDataLength==0) {
+        return 0;
+    }
+    if (entry.sharedData) {
+        // Wait until the receiver has read the previous messages.
+        while (*entry.sharedAck < entry.sharedSequence) {
+            global::mpi().syncSharedMemory(sharedWindow);
+        }
+        global::mpi().syncSharedMemory(sharedWindow);
+        return entry.sharedData;
+    }
+    // Does nothing once the buffer is allocated, which keeps the persistent
+    //   request valid.
+    entry.staticData.resize(entry.cumDataLength);
+    return &entry.staticData[0];
+}
+
+void SendPoolCommunicator::acceptStaticMessage(int toProc)
+{
+    std::map<int,CommunicatorEntry>::iterator entryPtr = subscriptions.find(toProc);
+    PLB_ASSERT( entryPtr != subscriptions.end() );
+    CommunicatorEntry& entry = entryPtr->second;
+    PLB_ASSERT( entry.currentMessage < (int)entry.messages.size() );
+    entry.currentMessage++;
+
+    if (entry.currentMessage==(int)entry.lengths.size()) {
+        startStaticCommunication(toProc, entry);
+        entry.reset();
+    }
+}
+
 void SendPoolCommunicator::finalize(bool staticMessage) {
     //PLB_ASSERT( !subscriptions.empty() );
     std::map<int, CommunicatorEntry >::iterator iter = subscriptions.begin();
     for (; iter != subscriptions.end(); ++iter) {
         CommunicatorEntry& entry = iter->second;
-        if (!staticMessage) {
-            global::mpi().wait(&entry.sizeRequest, &entry.sizeStatus);
+        if (staticMessage) {
+            // Empty messages are neither sent nor received, and messages in
+            //   shared memory are released by the receiver.
+            if (entry.cumDataLength>0 && !entry.sharedData) {
+                global::mpi().wait(&entry.staticRequest, &entry.messageStatus);
+            }
+            continue;
         }
+        global::mpi().wait(&entry.sizeRequest, &entry.sizeStatus);
         // Empty messages are neither sent nor received.
         if (!entry.data.empty()) {
             global::mpi().wait(&entry.messageRequest, &entry.messageStatus);
@@ -90,24 +172,30 @@ void SendPoolCommunicator::startCommunication(int toProc, bool staticMessage)
     PLB_ASSERT( entryPtr != subscriptions.end() );
     CommunicatorEntry& entry = entryPtr->second;
     if (staticMessage) {
-        entry.data.resize(entry.cumDataLength);
-    }
-    else {
-        // If the communicated data is non-static, the overall size of transmitted
-        //   data must be computed.
-        int dynamicDataLength = 0;
-        entry.dynamicDataSizes.resize(entry.messages.size());
+        // Merge the individual messages into the persistent buffer.
+        char* buffer = getStaticBuffer(entry);
         for (pluint iMessage=0; iMessage<entry.messages.size(); ++iMessage) {
-            dynamicDataLength += entry.messages[iMessage].size();
-            entry.dynamicDataSizes[iMessage] = entry.messages[iMessage].size();
+            PLB_ASSERT( (int)entry.messages[iMessage].size() == entry.lengths[iMessage] );
+            if (!entry.messages[iMessage].empty()) {
+                std::copy(entry.messages[iMessage].begin(), entry.messages[iMessage].end(),
+                          buffer+entry.offsets[iMessage]);
+            }
         }
-        entry.data.resize(dynamicDataLength);
+        startStaticCommunication(toProc, entry);
+        return;
+    }
+    // If the communicated data is non-static, the overall size of transmitted
+    //   data must be computed.
+    int dynamicDataLength = 0;
+    entry.dynamicDataSizes.resize(entry.messages.size());
+    for (pluint iMessage=0; iMessage<entry.messages.size(); ++iMessage) {
+        dynamicDataLength += entry.messages[iMessage].size();
+        entry.dynamicDataSizes[iMessage] = entry.messages[iMessage].size();
     }
+    entry.data.resize(dynamicDataLength);
     // Merge the individual messages into a single vector.
     int pos=0;
     for (pluint iMessage=0; iMessage<entry.messages.size(); ++iMessage) {
-        PLB_ASSERT( !staticMessage ||
-                    ( (int)entry.messages[iMessage].size() == entry.lengths[iMessage] ));
         PLB_ASSERT(pos+entry.messages[iMessage].size() <= entry.data.size());
         if( !entry.messages[iMessage].empty() && !entry.data.empty() ) {
             std::copy(entry.messages[iMessage].begin(),
@@ -115,12 +203,10 @@ void SendPoolCommunicator::startCommunication(int toProc, bool staticMessage)
         }
         pos+=entry.messages[iMessage].size();
     }
-    if (!staticMessage) {
-        PLB_ASSERT(entry.dynamicDataSizes.size()>0);
-        global::profiler().increment("mpiSendChar", (plint)entry.dynamicDataSizes.size());
-        global::mpi().iSend(&entry.dynamicDataSizes[0], entry.dynamicDataSizes.size(), toProc,
-                            &entry.sizeRequest);
-    }
+    PLB_ASSERT(entry.dynamicDataSizes.size()>0);
+    global::profiler().increment("mpiSendChar", (plint)entry.dynamicDataSizes.size());
+    global::mpi().iSend(&entry.dynamicDataSizes[0], entry.dynamicDataSizes.size(), toProc,
+                        &entry.sizeRequest);
     // Empty messages are neither sent nor received.
     if (!entry.data.empty()) {
         global::profiler().increment("mpiSendChar", (plint)entry.data.size());
@@ -128,8 +214,33 @@ void SendPoolCommunicator::startCommunication(int toProc, bool staticMessage)
     }
 }
 
+void SendPoolCommunicator::startStaticCommunication(int toProc, CommunicatorEntry& entry)
+{
+    // Empty messages are neither sent nor received.
+    if (entry.cumDataLength==0) {
+        return;
+    }
+    if (entry.sharedData) {
+        global::mpi().syncSharedMemory(sharedWindow);
+        *entry.sharedReady = ++entry.sharedSequence;
+        global::mpi().syncSharedMemory(sharedWindow);
+        return;
+    }
+    PLB_ASSERT( (int)entry.staticData.size() == entry.cumDataLength );
+    if (entry.staticRequest==MPI_REQUEST_NULL) {
+        global::mpi().sendInit(&entry.staticData[0], entry.cumDataLength, toProc, &entry.staticRequest);
+    }
+    global::profiler().increment("mpiSendChar", (plint)entry.cumDataLength);
+    global::mpi().start(&entry.staticRequest);
+}
+
+RecvPoolCommunicator::RecvPoolCommunicator()
+    : sharedWindow(MPI_WIN_NULL)
+{ }
+
 RecvPoolCommunicator::RecvPoolCommunicator(SendRecvPool const& pool)
-    : subscriptions(pool.begin(), pool.end())
+    : subscriptions(pool.begin(), pool.end()),
+      sharedWindow(MPI_WIN_NULL)
 { }
 
 void RecvPoolCommunicator::startBeingReceptive(bool staticMessage)
@@ -144,13 +255,19 @@ void RecvPoolCommunicator::startBeingReceptive(bool staticMessage)
     for (; iter != subscriptions.end(); ++iter) {
         int fromProc = iter->first;
         CommunicatorEntry& entry = iter->second;
-        entry.data.resize(entry.cumDataLength);
-        // Empty messages are neither sent nor received.
-        if (!entry.data.empty()) {
-            global::profiler().increment("mpiReceiveChar", (plint)entry.data.size());
-            global::mpi().iRecv(&entry.data[0], entry.data.size(),
-                                fromProc, &entry.messageRequest);
+        // Empty messages are neither sent nor received, and messages in
+        //   shared memory need no request.
+        if (entry.cumDataLength==0 || entry.sharedData) {
+            continue;
         }
+        // The persistent request is created at the first communication.
+        if (entry.staticRequest==MPI_REQUEST_NULL) {
+            entry.staticData.resize(entry.cumDataLength);
+            global::mpi().recvInit(&entry.staticData[0], entry.cumDataLength,
+                                   fromProc, &entry.staticRequest);
+        }
+        global::profiler().increment("mpiReceiveChar", (plint)entry.cumDataLength);
+        global::mpi().start(&entry.staticRequest);
     }
 }
 
@@ -213,31 +330,157 @@ void RecvPoolCommunicator::receiveDynamic(int fromProc)
     }
 }
 
+char const* RecvPoolCommunicator::receiveStaticMessage(int fromProc)
+{
+    std::map<int,CommunicatorEntry>::iterator entryPtr = subscriptions.find(fromProc);
+    PLB_ASSERT( entryPtr!= subscriptions.end() );
+    CommunicatorEntry& entry = entryPtr->second;
+    PLB_ASSERT( entry.currentMessage < (int)entry.messages.size() );
+    if (entry.currentMessage==0) {
+        waitStatic(entry);
+    }
+    char const* message = 0;
+    if (entry.lengths[entry.currentMessage]>0) {
+        message = getStaticBuffer(entry) + entry.offsets[entry.currentMessage];
+    }
+    entry.currentMessage++;
+    if (entry.currentMessage==(int)entry.lengths.size()) {
+        entry.reset();
+    }
+    return message;
+}
+
+void RecvPoolCommunicator::finalize(bool staticMessage)
+{
+    if (!staticMessage) {
+        return;
+    }
+    std::map<int, CommunicatorEntry >::iterator iter = subscriptions.begin();
+    for (; iter != subscriptions.end(); ++iter) {
+        releaseStatic(iter->second);
+    }
+}
+
+void RecvPoolCommunicator::waitStatic(CommunicatorEntry& entry)
+{
+    // Empty messages are neither sent nor received.
+    if (entry.cumDataLength==0) {
+        return;
+    }
+    if (entry.sharedData) {
+        ++entry.sharedSequence;
+        while (*entry.sharedReady < entry.sharedSequence) {
+            global::mpi().syncSharedMemory(sharedWindow);
+        }
+        global::mpi().syncSharedMemory(sharedWindow);
+    }
+    else {
+        global::mpi().wait(&entry.staticRequest, &entry.messageStatus);
+    }
+}
+
+void RecvPoolCommunicator::releaseStatic(CommunicatorEntry& entry)
+{
+    if (entry.sharedData && *entry.sharedAck < entry.sharedSequence) {
+        global::mpi().syncSharedMemory(sharedWindow);
+        *entry.sharedAck = entry.sharedSequence;
+        global::mpi().syncSharedMemory(sharedWindow);
+    }
+}
+
+char const* RecvPoolCommunicator::getStaticBuffer(CommunicatorEntry const& entry) const
+{
+    return entry.sharedData ? entry.sharedData : &entry.staticData[0];
+}
+
 void RecvPoolCommunicator::finalizeStatic(int fromProc)
 {
     std::map<int,CommunicatorEntry>::iterator entryPtr = subscriptions.find(fromProc);
     PLB_ASSERT( entryPtr != subscriptions.end() );
     CommunicatorEntry& entry = entryPtr->second;
 
-    // Empty messages are neither sent nor received.
-    if (!entry.data.empty()) {
-        // 1. Make sure the package of messages has been received.
-        global::mpi().wait(&entry.messageRequest, &entry.messageStatus);
-        
-        // 2. The message package is split into individual messages.
-        int pos=0;
-        PLB_ASSERT(entry.messages.size() == entry.lengths.size());
-        for (pluint iMessage=0; iMessage<entry.messages.size(); ++iMessage) {
-            int length = entry.lengths[iMessage];
-            entry.messages[iMessage].resize(length);
-            PLB_ASSERT(pos+length <= (int)entry.data.size());
-            if (!entry.messages[iMessage].empty()) {
-                std::copy( entry.data.begin()+pos, entry.data.begin()+pos+length,
-                           entry.messages[iMessage].begin() );
-            }
-            pos+=length;
+    // 1. Make sure the package of messages has been received.
+    waitStatic(entry);
+
+    // 2. The message package is split into individual messages.
+    PLB_ASSERT(entry.messages.size() == entry.lengths.size());
+    for (pluint iMessage=0; iMessage<entry.messages.size(); ++iMessage) {
+        int length = entry.lengths[iMessage];
+        int pos = entry.offsets[iMessage];
+        entry.messages[iMessage].resize(length);
+        PLB_ASSERT(pos+length <= entry.cumDataLength);
+        if (!entry.messages[iMessage].empty()) {
+            char const* buffer = getStaticBuffer(entry);
+            std::copy( buffer+pos, buffer+pos+length, entry.messages[iMessage].begin() );
         }
     }
+
+    // 3. The messages have been copied: the buffer can be released.
+    releaseStatic(entry);
+}
+
+/** The messages sent by a process are located in its shared memory, which
+ *  is allocated collectively by the processes of the node. Each receiver is
+ *  told by the sender where its messages are located.
+ */
+void shareStaticMessagesOnNode(SendPoolCommunicator& sendComm, RecvPoolCommunicator& recvComm)
+{
+#ifdef PLB_MPI_SHARED_MEMORY
+    global::MpiManager& mpi = global::mpi();
+    if (mpi.getNodeSize()<=1 || !mpi.usesSharedMemory()) {
+        return;
+    }
+    PLB_PRECONDITION( sendComm.sharedWindow==MPI_WIN_NULL );
+    // The counters and the messages of an entry are located on separate cache lines.
+    const int headerSize = 64;
+
+    // 1. Layout of the shared memory of the current process.
+    std::map<int,int> positions;
+    int totalSize = 0;
+    std::map<int, CommunicatorEntry >::iterator iter = sendComm.subscriptions.begin();
+    for (; iter != sendComm.subscriptions.end(); ++iter) {
+        if (mpi.getNodeRank(iter->first)>=0 && iter->second.cumDataLength>0) {
+            positions[iter->first] = totalSize;
+            totalSize += headerSize + (iter->second.cumDataLength+headerSize-1)/headerSize*headerSize;
+        }
+    }
+    char* memory = mpi.allocateShared(totalSize, &sendComm.sharedWindow);
+    recvComm.sharedWindow = sendComm.sharedWindow;
+
+    // 2. The receivers are told where their messages are located.
+    std::vector<MPI_Request> requests(positions.size());
+    std::vector<MPI_Status> statuses(positions.size());
+    pluint iRequest=0;
+    for (std::map<int,int>::iterator it = positions.begin(); it != positions.end(); ++it, ++iRequest) {
+        CommunicatorEntry& entry = sendComm.subscriptions[it->first];
+        entry.sharedReady = (plint*)(memory+it->second);
+        entry.sharedAck = entry.sharedReady+1;
+        *entry.sharedReady = 0;
+        *entry.sharedAck = 0;
+        entry.sharedData = memory+it->second+headerSize;
+        mpi.iSend(&it->second, 1, it->first, &requests[iRequest]);
+    }
+    for (iter = recvComm.subscriptions.begin(); iter != recvComm.subscriptions.end(); ++iter) {
+        int nodeRank = mpi.getNodeRank(iter->first);
+        CommunicatorEntry& entry = iter->second;
+        if (nodeRank>=0 && entry.cumDataLength>0) {
+            int position;
+            mpi.receive(&position, 1, iter->first);
+            char* senderMemory = mpi.querySharedMemory(recvComm.sharedWindow, nodeRank);
+            entry.sharedReady = (plint*)(senderMemory+position);
+            entry.sharedAck = entry.sharedReady+1;
+            entry.sharedData = senderMemory+position+headerSize;
+        }
+    }
+    for (iRequest=0; iRequest<requests.size(); ++iRequest) {
+        mpi.wait(&requests[iRequest], &statuses[iRequest]);
+    }
+
+    // 3. The counters are initialized before they are used by the other processes.
+    mpi.syncSharedMemory(sendComm.sharedWindow);
+    mpi.nodeBarrier();
+    mpi.syncSharedMemory(sendComm.sharedWindow);
+#endif
 }
 
 #endif // PLB_MPI_PARALLEL
@@ -83,18 +83,59 @@ struct CommunicatorEntry {
           cumDataLength(0),
           messages(),
           data(),
-          currentMessage(0)
+          currentMessage(0),
+          staticRequest(MPI_REQUEST_NULL),
+          sharedData(0), sharedReady(0), sharedAck(0), sharedSequence(0)
     { } 
     CommunicatorEntry(PoolEntry const& poolEntry)
         : lengths(poolEntry.lengths),
           cumDataLength(poolEntry.cumDataLength),
           messages(lengths.size()),
-          currentMessage(0)
+          currentMessage(0),
+          offsets(lengths.size()),
+          staticRequest(MPI_REQUEST_NULL),
+          sharedData(0), sharedReady(0), sharedAck(0), sharedSequence(0)
     {
+        int pos=0;
         for (pluint iMessage=0; iMessage<messages.size(); ++iMessage) {
             messages[iMessage].resize(lengths[iMessage]);
+            offsets[iMessage] = pos;
+            pos += lengths[iMessage];
         }
     }
+    /// The persistent request and the shared memory are not copied: each entry
+    ///   creates its own.
+    CommunicatorEntry(CommunicatorEntry const& rhs)
+        : lengths(rhs.lengths),
+          cumDataLength(rhs.cumDataLength),
+          messages(rhs.messages),
+          data(rhs.data),
+          dynamicDataSizes(rhs.dynamicDataSizes),
+          currentMessage(rhs.currentMessage),
+          offsets(rhs.offsets),
+          staticRequest(MPI_REQUEST_NULL),
+          sharedData(0), sharedReady(0), sharedAck(0), sharedSequence(0)
+    { }
+    CommunicatorEntry& operator=(CommunicatorEntry const& rhs) {
+        if (this != &rhs) {
+            global::mpi().requestFree(&staticRequest);
+            lengths = rhs.lengths;
+            cumDataLength = rhs.cumDataLength;
+            messages = rhs.messages;
+            data = rhs.data;
+            dynamicDataSizes = rhs.dynamicDataSizes;
+            currentMessage = rhs.currentMessage;
+            offsets = rhs.offsets;
+            staticData.clear();
+            sharedData = 0;
+            sharedReady = sharedAck = 0;
+            sharedSequence = 0;
+        }
+        return *this;
+    }
+    ~CommunicatorEntry() {
+        global::mpi().requestFree(&staticRequest);
+    }
     void reset() {
         currentMessage=0;
     }
@@ -124,35 +165,91 @@ struct CommunicatorEntry {
     int currentMessage;
     MPI_Request sizeRequest, messageRequest;
     MPI_Status  sizeStatus, messageStatus;
+    /// Position of the individual messages in the buffer staticData.
+    std::vector<int> offsets;
+    /// Static messages have the same size at each communication. They are
+    ///   sent from, or received into, the buffer staticData through a
+    ///   persistent request, which is created at the first communication.
+    std::vector<char> staticData;
+    MPI_Request staticRequest;
+    /// With a process of the same node, static messages go through shared memory
+    ///   instead. They are located at sharedData, in the memory of the sender. The
+    ///   counter sharedReady is incremented by the sender when the messages are
+    ///   written, and sharedAck is set by the receiver when they have been read.
+    char* sharedData;
+    volatile plint* sharedReady;
+    volatile plint* sharedAck;
+    /// Number of communications through shared memory.
+    plint sharedSequence;
 };
 
+class SendPoolCommunicator;
+class RecvPoolCommunicator;
+
+/// Let the static messages which are exchanged with processes of the same node go
+///   through shared memory. Collective on the node communicator.
+void shareStaticMessagesOnNode(SendPoolCommunicator& sendComm, RecvPoolCommunicator& recvComm);
+
 /// The "in-action" device for all messages sent from a processor.
 class SendPoolCommunicator {
 public:
-    SendPoolCommunicator() { }
+    SendPoolCommunicator();
     SendPoolCommunicator(SendRecvPool const& pool);
+    /// The shared memory is not copied.
+    SendPoolCommunicator(SendPoolCommunicator const& rhs);
+    SendPoolCommunicator& operator=(SendPoolCommunicator const& rhs);
+    ~SendPoolCommunicator();
     std::vector<char>& getSendBuffer(int toProc);
     void acceptMessage(int toProc, bool staticMessage);
+    /// Location of the next static message in the buffer of the MPI
+    ///   communication, or 0 if the message is empty.
+    /** The message must be written in place, and then confirmed with
+     *  acceptStaticMessage() instead of acceptMessage().
+     **/
+    char* getStaticSendBuffer(int toProc);
+    void acceptStaticMessage(int toProc);
     void finalize(bool staticMessage);
 private:
     void startCommunication(int toProc, bool staticMessage);
+    /// Send the static messages, packed in staticData, with a persistent request,
+    ///   or signal that they are ready in shared memory.
+    void startStaticCommunication(int toProc, CommunicatorEntry& entry);
+    /// Buffer of the static messages, after the previous ones have been read
+    ///   from shared memory.
+    char* getStaticBuffer(CommunicatorEntry& entry);
 private:
     std::map<int, CommunicatorEntry > subscriptions;
+    /// Window of the shared memory, which is owned by the sending side.
+    MPI_Win sharedWindow;
+friend void shareStaticMessagesOnNode(SendPoolCommunicator&, RecvPoolCommunicator&);
 };
 
 /// The "in-action" device for all messages received on a processor.
 class RecvPoolCommunicator {
 public:
-    RecvPoolCommunicator() { }
+    RecvPoolCommunicator();
     RecvPoolCommunicator(SendRecvPool const& pool);
     /// Initiate non-blocking communication.
     void startBeingReceptive(bool staticMessage);
     std::vector<char> const& receiveMessage(int fromProc, bool staticMessage);
+    /// Location of the next static message in the buffer of the MPI
+    ///   communication, or 0 if the message is empty.
+    /** This avoids the copy of receiveMessage() into individual messages. **/
+    char const* receiveStaticMessage(int fromProc);
+    /// Release the static messages received through shared memory, which can
+    ///   then be overwritten by the sender.
+    void finalize(bool staticMessage);
 private:
+    void waitStatic(CommunicatorEntry& entry);
+    void releaseStatic(CommunicatorEntry& entry);
+    char const* getStaticBuffer(CommunicatorEntry const& entry) const;
     void finalizeStatic(int fromProc);
     void receiveDynamic(int fromProc);
 private:
     std::map<int, CommunicatorEntry > subscriptions;
+    /// Window of the shared memory of the senders, owned by a SendPoolCommunicator.
+    MPI_Win sharedWindow;
+friend void shareStaticMessagesOnNode(SendPoolCommunicator&, RecvPoolCommunicator&);
 };
 
 #endif  // PLB_MPI_PARALLEL
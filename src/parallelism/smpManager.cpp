@@ -0,0 +1,97 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Wrapper functions for shared-memory (SMP) parallelism -- implementation.
+ */
+
+#include "parallelism/smpManager.h"
+#include "core/plbDebug.h"
+#include <algorithm>
+#include <cstdlib>
+#ifdef PLB_OPENMP
+#include <omp.h>
+#endif
+
+namespace plb {
+
+namespace global {
+
+SmpManager::SmpManager()
+    : numThreads(1),
+      threadsDisabled(false)
+{
+#ifdef PLB_OPENMP
+    char const* numThreadsVariable = std::getenv("PLB_NUM_THREADS");
+    if (numThreadsVariable) {
+        numThreads = std::max(1, std::atoi(numThreadsVariable));
+    }
+#endif
+}
+
+int SmpManager::getNumThreads() const {
+    return numThreads;
+}
+
+void SmpManager::setNumThreads(int numThreads_) {
+    PLB_PRECONDITION( numThreads_>0 );
+#ifdef PLB_OPENMP
+    if (!threadsDisabled) {
+        numThreads = numThreads_;
+    }
+#endif
+}
+
+void SmpManager::disableThreads() {
+    threadsDisabled = true;
+    numThreads = 1;
+}
+
+int SmpManager::getThreadId() const {
+#ifdef PLB_OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+int SmpManager::getNumActiveThreads() const {
+#ifdef PLB_OPENMP
+    return omp_get_num_threads();
+#else
+    return 1;
+#endif
+}
+
+double SmpManager::getTime() const {
+#ifdef PLB_OPENMP
+    return omp_get_wtime();
+#else
+    return 0.;
+#endif
+}
+
+}  // namespace global
+
+}  // namespace plb
@@ -0,0 +1,82 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Wrapper functions for shared-memory (SMP) parallelism -- header file.
+ */
+
+#ifndef SMP_MANAGER_H
+#define SMP_MANAGER_H
+
+#include "core/globalDefs.h"
+
+// Threads are used only if SMP parallelism is requested and the compiler
+//   actually provides OpenMP. Otherwise, all code runs on a single thread.
+#if defined(PLB_SMP_PARALLEL) && defined(_OPENMP)
+#define PLB_OPENMP
+#endif
+
+namespace plb {
+
+namespace global {
+
+/// Wrapper functions for the threads that execute the local blocks of an MPI process.
+/** Threads are opt-in: a single thread is used unless the environment variable
+ *  PLB_NUM_THREADS is set, or setNumThreads() is called. This avoids to
+ *  oversubscribe the cores when several MPI processes share a node.
+ **/
+class SmpManager {
+public:
+    /// Number of threads among which the local blocks are distributed.
+    int getNumThreads() const;
+    /// Change the number of threads. Without SMP support, or if threads have
+    ///   been disabled, this has no effect.
+    void setNumThreads(int numThreads_);
+    /// Use a single thread from now on, for example because the MPI library
+    ///   does not support calls from a multi-threaded process.
+    void disableThreads();
+    /// Id of the calling thread; always 0 outside a parallel region.
+    int getThreadId() const;
+    /// Number of threads of the current parallel region; 1 outside a parallel region.
+    int getNumActiveThreads() const;
+    /// Wall-clock time in seconds; returns 0 without SMP support.
+    double getTime() const;
+private:
+    SmpManager();
+private:
+    int numThreads;
+    bool threadsDisabled;
+friend SmpManager& smp();
+};
+
+inline SmpManager& smp() {
+    static SmpManager instance;
+    return instance;
+}
+
+}  // namespace global
+
+}  // namespace plb
+
+#endif  // SMP_MANAGER_H
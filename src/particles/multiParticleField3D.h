@@ -45,6 +45,7 @@ public:
     ~MultiParticleField3D();
     virtual MultiParticleField3D<ParticleFieldT>* clone() const;
     virtual MultiParticleField3D<ParticleFieldT>* clone(MultiBlockManagement3D const& newManagement) const;
+    virtual void migrate(MultiBlockManagement3D const& newManagement);
     MultiParticleField3D& operator=(MultiParticleField3D<ParticleFieldT> const& rhs);
     MultiParticleField3D(MultiParticleField3D<ParticleFieldT> const& rhs);
     void swap(MultiParticleField3D<ParticleFieldT>& rhs);
@@ -133,6 +133,15 @@ MultiParticleField3D<ParticleFieldT>* MultiParticleField3D<ParticleFieldT>::clon
     return newField;
 }
 
+template<class ParticleFieldT>
+void MultiParticleField3D<ParticleFieldT>::migrate(MultiBlockManagement3D const& newManagement)
+{
+    MultiParticleField3D<ParticleFieldT>* newField = clone(newManagement);
+    blocks.swap(newField->blocks);
+    this->adoptDistribution(*newField);
+    delete newField;
+}
+
 template<class ParticleFieldT>
 void MultiParticleField3D<ParticleFieldT>::allocateBlocks() 
 {